@@ -1,6 +1,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include <vector>
+
 #include <gtensor/gtensor.h>
 
 using namespace gt::placeholders;
@@ -33,14 +35,31 @@ auto get_shape(int n_per_dim)
     shape[1] = n_per_dim;
     shape[2] = n_per_dim;
   } else {
-    shape[0] = n_per_dim;
-    shape[1] = n_per_dim;
-    shape[2] = n_per_dim;
-    shape[3] = n_per_dim;
+    // about the same size for 5 and 6 dims: the last dims split in two
+    for (int d = 0; d < Dim; d++) {
+      shape[d] = n_per_dim;
+    }
+    for (int d = 4; d < Dim; d++) {
+      shape[d - 2] = n_per_dim / 2;
+      shape[d] = 2;
+    }
   }
   return shape;
 }
 
+// strides for unraveling with index type I, or with fast_divmod
+template <typename I, typename S>
+auto get_unravel_strides(const S& shape, I)
+{
+  return gt::calc_strides<I>(shape);
+}
+
+template <typename S>
+auto get_unravel_strides(const S& shape, gt::fast_divmod)
+{
+  return gt::calc_fast_strides(shape);
+}
+
 } // namespace bm
 
 } // namespace gt
@@ -489,4 +508,224 @@ BENCHMARK(BM_device_assign_op_launch_4d<float>)
   ->Arg(GTENSOR_BENCHMARK_PER_DIM_SIZE)
   ->Unit(benchmark::kMillisecond);
 
+// ======================================================================
+// BM_device_assign_unravel
+//
+// linear launch over a Dim-d array that unravels the index with 32-bit
+// (int) or 64-bit (size_type) divisions, or with fast_divmod, i.e. the paths
+// that N-d device launches and assigns pick between at runtime
+
+template <typename T, int Dim, typename I>
+static void BM_device_assign_unravel(benchmark::State& state)
+{
+  using index_t =
+    std::conditional_t<std::is_same<I, gt::fast_divmod>::value, int, I>;
+  int n = state.range(0);
+  auto shape = gt::bm::get_shape<Dim>(n);
+
+  auto a = gt::zeros_device<T>(shape);
+  auto b = gt::empty_like(a);
+
+  auto k_a = a.to_kernel();
+  auto k_b = b.to_kernel();
+  auto strides = gt::bm::get_unravel_strides(shape, I{});
+
+  auto op_lambda = GT_LAMBDA(int i)
+  {
+    auto idx = gt::unravel(static_cast<index_t>(i), strides);
+    gt::index_expression(k_b, idx) = 2 * gt::index_expression(k_a, idx);
+  };
+
+  // warmup, device compile
+  gt::launch<1>(gt::shape(a.size()), op_lambda);
+  gt::synchronize();
+
+  for (auto _ : state) {
+    gt::launch<1>(gt::shape(a.size()), op_lambda);
+    gt::synchronize();
+  }
+}
+
+#define BENCHMARK_UNRAVEL(Dim, I)                                              \
+  BENCHMARK(BM_device_assign_unravel<double, Dim, I>)                          \
+    ->Arg(GTENSOR_BENCHMARK_PER_DIM_SIZE / 2)                                  \
+    ->Arg(GTENSOR_BENCHMARK_PER_DIM_SIZE)                                      \
+    ->Unit(benchmark::kMillisecond)
+
+BENCHMARK_UNRAVEL(4, int);
+BENCHMARK_UNRAVEL(4, gt::size_type);
+BENCHMARK_UNRAVEL(4, gt::fast_divmod);
+BENCHMARK_UNRAVEL(5, int);
+BENCHMARK_UNRAVEL(5, gt::size_type);
+BENCHMARK_UNRAVEL(5, gt::fast_divmod);
+BENCHMARK_UNRAVEL(6, int);
+BENCHMARK_UNRAVEL(6, gt::size_type);
+BENCHMARK_UNRAVEL(6, gt::fast_divmod);
+
+// ======================================================================
+// BM_host_assign_odometer
+//
+// host assign of a high rank view with short leading dimensions, through the
+// odometer that assign uses for ranks >= 4 vs a nested loop per dimension
+
+template <typename T, int Dim, bool Nested>
+static void BM_host_assign_odometer(benchmark::State& state)
+{
+  int n = state.range(0);
+  gt::shape_type<Dim> shape;
+  int last = n * n * n * n;
+  for (int d = 0; d < Dim - 1; d++) {
+    shape[d] = 4;
+    last /= 4;
+  }
+  shape[Dim - 1] = last;
+
+  auto a = gt::zeros<T>(shape);
+  auto b = gt::empty<T>(shape);
+  std::vector<gt::gdesc> every_other(Dim, gt::gdesc(_all));
+  every_other[0] = _s(_, _, 2);
+  auto a_view = gt::view<Dim>(a, every_other);
+  auto b_view = gt::view<Dim>(b, every_other);
+  auto k_a = a_view.to_kernel();
+  auto k_b = b_view.to_kernel();
+
+  auto nested = [&]() {
+    gt::launch_host<Dim>(a_view.shape(), [&](auto... i) {
+      k_b(i...) = k_a(i...);
+    });
+  };
+
+  for (auto _ : state) {
+    if (Nested) {
+      nested();
+    } else {
+      b_view = a_view;
+    }
+    benchmark::DoNotOptimize(b.data());
+  }
+}
+
+#define BENCHMARK_ODOMETER(Dim, Nested)                                        \
+  BENCHMARK(BM_host_assign_odometer<double, Dim, Nested>)                      \
+    ->Arg(GTENSOR_BENCHMARK_PER_DIM_SIZE / 4)                                  \
+    ->Unit(benchmark::kMillisecond)
+
+BENCHMARK_ODOMETER(4, true);
+BENCHMARK_ODOMETER(4, false);
+BENCHMARK_ODOMETER(6, true);
+BENCHMARK_ODOMETER(6, false);
+BENCHMARK_ODOMETER(8, false);
+
+// ======================================================================
+// BM_host_assign_row_major
+//
+// host assign of a column-major expression to a row-major 3-d container, in
+// the memory order of the lhs vs nested loops in index order
+
+template <typename T, bool Nested>
+static void BM_host_assign_row_major(benchmark::State& state)
+{
+  int n = state.range(0);
+  auto shape = gt::shape(n, n, 32);
+  auto a = gt::zeros<T>(shape);
+  gt::gtensor<T, 3, gt::space::host, gt::layout::row_major> b(shape);
+
+  for (auto _ : state) {
+    if (Nested) {
+      for (int k = 0; k < shape[2]; k++) {
+        for (int j = 0; j < shape[1]; j++) {
+          for (int i = 0; i < shape[0]; i++) {
+            b(i, j, k) = a(i, j, k) + 2. * a(i, j, k);
+          }
+        }
+      }
+    } else {
+      b = a + 2. * a;
+    }
+    benchmark::DoNotOptimize(b.data());
+  }
+}
+
+BENCHMARK(BM_host_assign_row_major<double, true>)
+  ->Arg(512)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_host_assign_row_major<double, false>)
+  ->Arg(512)
+  ->Unit(benchmark::kMillisecond);
+
+// ======================================================================
+// BM_host_transpose
+//
+// host assign of a transposed 2-d container vs naive loops; the assign
+// copies in blocks for planes over 1 MiB and page-multiple row strides
+
+template <typename T, bool Assign>
+static void BM_host_transpose(benchmark::State& state)
+{
+  int n = state.range(0);
+  auto a = gt::zeros<T>(gt::shape(n, n));
+  gt::gtensor<T, 2> b(a.shape());
+  auto k_a = a.to_kernel();
+  auto k_b = b.to_kernel();
+
+  for (auto _ : state) {
+    if (Assign) {
+      b = gt::transpose(a);
+    } else {
+      for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+          k_b(i, j) = k_a(j, i);
+        }
+      }
+    }
+    benchmark::DoNotOptimize(b.data());
+  }
+}
+
+BENCHMARK(BM_host_transpose<double, true>)
+  ->Arg(1000)
+  ->Arg(1024)
+  ->Arg(1500)
+  ->Arg(2048)
+  ->Arg(3000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_host_transpose<double, false>)
+  ->Arg(1000)
+  ->Arg(1024)
+  ->Arg(1500)
+  ->Arg(2048)
+  ->Arg(3000)
+  ->Unit(benchmark::kMillisecond);
+
+// ======================================================================
+// BM_host_reshape_view
+//
+// assign from a reshaped non-contiguous 3-d view: merging the last two
+// dimensions keeps the strides, merging the first two unravels each index
+
+template <typename T, bool Strided>
+static void BM_host_reshape_view(benchmark::State& state)
+{
+  int n = state.range(0);
+  auto a = gt::zeros<T>(gt::shape(n + 2, n, 32));
+  auto v = a.view(_s(1, -1), _all, _all);
+  gt::gtensor<T, 2> b;
+
+  for (auto _ : state) {
+    if (Strided) {
+      b = gt::reshape(v, gt::shape(n, n * 32));
+    } else {
+      b = gt::reshape(v, gt::shape(n * n, 32));
+    }
+    benchmark::DoNotOptimize(b.data());
+  }
+}
+
+BENCHMARK(BM_host_reshape_view<double, true>)
+  ->Arg(512)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_host_reshape_view<double, false>)
+  ->Arg(512)
+  ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
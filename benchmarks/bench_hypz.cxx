@@ -3,6 +3,8 @@
 #include <benchmark/benchmark.h>
 
 #include <gtensor/gtensor.h>
+#include <gtensor/stencil.h>
+#include <gtensor/wrap.h>
 
 #include "gt-bm.h"
 
@@ -86,4 +88,96 @@ BENCHMARK(BM_semi_arakawa_kl_13p_v1_idep<gt::space::device>)
 BENCHMARK(BM_semi_arakawa_kl_13p_v1_idep<gt::space::managed>)
   ->Unit(benchmark::kMillisecond);
 
+// ======================================================================
+// semi_arakawa_kl_13p_v1_idep_stencil
+//
+// same as above, as a single gt::stencil over k and l, with the stencil
+// index moved last in the coefficients, as gt::stencil expects
+
+template <typename E1, typename E2>
+auto semi_arakawa_kl_13p_v1_idep_stencil(E1& sten, const E2& a)
+{
+  using gt::stencil_point;
+
+  auto coeffs =
+    gt::permute_dims(sten, {0, 2, 3, 4, 5, 1}).view(_all, _newaxis);
+
+  return gt::stencil<
+    stencil_point<+0, -2>, stencil_point<-1, -1>, stencil_point<+0, -1>,
+    stencil_point<+1, -1>, stencil_point<-2, +0>, stencil_point<-1, +0>,
+    stencil_point<+0, +0>, stencil_point<+1, +0>, stencil_point<+2, +0>,
+    stencil_point<-1, +1>, stencil_point<+0, +1>, stencil_point<+1, +1>,
+    stencil_point<+0, +2>>(std::move(coeffs), a, {2, 3});
+}
+
+// ======================================================================
+// BM_semi_arakawa_kl_13p_v1_idep_stencil
+
+template <typename S>
+static void BM_semi_arakawa_kl_13p_v1_idep_stencil(benchmark::State& state)
+{
+  auto shape_rhs = gt::shape(70, 32, 24, 24, 32, 2);
+  auto shape_sten = gt::shape(70, 13, 24, 24, 32, 2);
+
+  std::array<int, 6> bnd = {0, 0, 2, 2, 0, 0};
+  gt::shape_type<6> shape_f;
+  for (int d = 0; d < 6; d++) {
+    shape_f[d] = shape_rhs[d] + 2 * bnd[d];
+  }
+
+  gt::bm::gtensor2<complex_t, 6, S> rhs(shape_rhs, 0.0);
+  gt::bm::gtensor2<complex_t, 6, S> f(shape_f, 0.0);
+  gt::bm::gtensor2<real_t, 6, S> sten(shape_sten, 0.0);
+
+  // warmup, force compile
+  rhs = rhs + semi_arakawa_kl_13p_v1_idep_stencil(sten, f);
+  gt::synchronize();
+
+  for (auto _ : state) {
+    rhs = rhs + semi_arakawa_kl_13p_v1_idep_stencil(sten, f);
+    gt::synchronize();
+  }
+}
+
+BENCHMARK(BM_semi_arakawa_kl_13p_v1_idep_stencil<gt::space::device>)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_semi_arakawa_kl_13p_v1_idep_stencil<gt::space::managed>)
+  ->Unit(benchmark::kMillisecond);
+
+// ======================================================================
+// BM_semi_arakawa_kl_13p_v1_idep_periodic
+//
+// same, but periodic in k and l via wrap views instead of ghost cells
+
+template <typename S>
+static void BM_semi_arakawa_kl_13p_v1_idep_periodic(benchmark::State& state)
+{
+  auto shape_rhs = gt::shape(70, 32, 24, 24, 32, 2);
+  auto shape_sten = gt::shape(70, 13, 24, 24, 32, 2);
+
+  std::array<int, 6> bnd = {0, 0, 2, 2, 0, 0};
+  auto pad = gt::shape(0, 0, 2, 2, 0, 0);
+
+  gt::bm::gtensor2<complex_t, 6, S> rhs(shape_rhs, 0.0);
+  gt::bm::gtensor2<complex_t, 6, S> f(shape_rhs, 0.0);
+  gt::bm::gtensor2<real_t, 6, S> sten(shape_sten, 0.0);
+  auto f_periodic = gt::wrap(f, pad, gt::boundary::periodic);
+
+  // warmup, force compile
+  gt::assign_wrapped(
+    rhs, rhs + semi_arakawa_kl_13p_v1_idep(sten, f_periodic, bnd), pad);
+  gt::synchronize();
+
+  for (auto _ : state) {
+    gt::assign_wrapped(
+      rhs, rhs + semi_arakawa_kl_13p_v1_idep(sten, f_periodic, bnd), pad);
+    gt::synchronize();
+  }
+}
+
+BENCHMARK(BM_semi_arakawa_kl_13p_v1_idep_periodic<gt::space::device>)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_semi_arakawa_kl_13p_v1_idep_periodic<gt::space::managed>)
+  ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include <gtensor/gtensor.h>
+
+#include <gt-io/io.h>
+#include <gt-io/parallel.h>
+
+using namespace gt::placeholders;
+
+constexpr int KB = 1024;
+constexpr int MB = 1024 * KB;
+
+// directory for the benchmark files, point it to the file system of interest
+// (e.g. local NVMe) with GTENSOR_BENCH_IO_DIR
+static std::string bench_file()
+{
+  const char* dir = std::getenv("GTENSOR_BENCH_IO_DIR");
+  return std::string(dir ? dir : "/tmp") + "/gtensor_bench_io.dat";
+}
+
+class bench_fd
+{
+public:
+  bench_fd() : path_(bench_file())
+  {
+    fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+      throw std::runtime_error("bench_io: can't open " + path_);
+    }
+  }
+  ~bench_fd()
+  {
+    close(fd_);
+    std::remove(path_.c_str());
+  }
+
+  int fd() const { return fd_; }
+
+private:
+  std::string path_;
+  int fd_;
+};
+
+// ======================================================================
+// write / read of a 3-d array, serial vs partitioned along the slowest
+// dimension, state.range(0) is the array size in MB, state.range(1) the
+// number of threads (0: serial path)
+
+static auto make_array(int mb)
+{
+  int nz = mb * MB / (sizeof(double) * 128 * 128);
+  return gt::gtensor<double, 3>(gt::shape(128, 128, nz), 1.);
+}
+
+static void BM_io_write(benchmark::State& state)
+{
+  auto a = make_array(state.range(0));
+  int n_threads = state.range(1);
+  bench_fd f;
+
+  for (auto _ : state) {
+    if (n_threads == 0) {
+      lseek(f.fd(), 0, SEEK_SET);
+      gt::io::write(f.fd(), a);
+    } else {
+      gt::io::write_parallel(f.fd(), a, 0, n_threads);
+    }
+    fsync(f.fd());
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(double));
+}
+
+static void BM_io_read(benchmark::State& state)
+{
+  auto a = make_array(state.range(0));
+  int n_threads = state.range(1);
+  bench_fd f;
+  gt::io::write(f.fd(), a);
+  fsync(f.fd());
+
+  for (auto _ : state) {
+    if (n_threads == 0) {
+      lseek(f.fd(), 0, SEEK_SET);
+      gt::io::read(f.fd(), a);
+    } else {
+      gt::io::read_parallel(f.fd(), a, 0, n_threads);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * a.size() * sizeof(double));
+}
+
+// interior of the array, i.e. strided runs rather than one contiguous block
+static void BM_io_write_view(benchmark::State& state)
+{
+  auto a = make_array(state.range(0));
+  auto v = a.view(_s(2, -2), _s(2, -2), _all);
+  int n_threads = state.range(1);
+  bench_fd f;
+
+  for (auto _ : state) {
+    if (n_threads == 0) {
+      lseek(f.fd(), 0, SEEK_SET);
+      gt::io::write(f.fd(), v);
+    } else {
+      gt::io::write_parallel(f.fd(), v, 0, n_threads);
+    }
+    fsync(f.fd());
+  }
+  state.SetBytesProcessed(state.iterations() * v.size() * sizeof(double));
+}
+
+static void io_args(benchmark::internal::Benchmark* b)
+{
+  for (int mb : {64, 1024}) {
+    for (int n_threads : {0, 1, 2, 4, 8, 16}) {
+      b->Args({mb, n_threads});
+    }
+  }
+}
+
+BENCHMARK(BM_io_write)
+  ->Apply(io_args)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_io_read)
+  ->Apply(io_args)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_io_write_view)
+  ->Apply(io_args)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,6 +1,9 @@
 #include <benchmark/benchmark.h>
 
 #include <gtensor/gtensor.h>
+#include <gtensor/gtensor_fixed.h>
+#include <gtensor/segmented.h>
+#include <gtensor/gtensor_tiled.h>
 
 using namespace gt::placeholders;
 
@@ -245,4 +248,276 @@ static void BM_add_dgdxy_fused_6d(benchmark::State& state)
 
 BENCHMARK(BM_add_dgdxy_fused_6d)->Unit(benchmark::kMillisecond);
 
+// ======================================================================
+// BM_jacobian_3x3
+//
+// apply a 3x3 matrix at every point of a vector field on the host, with the
+// matrix as a dynamic shape span, or as a fixed extent one, where the strides
+// and loop bounds are constants
+
+template <bool Fixed>
+static void BM_jacobian_3x3(benchmark::State& state)
+{
+  const int n = 1024 * 1024;
+  auto v = gt::zeros<real_t>({n, 3});
+  auto w = gt::empty_like(v);
+  gt::gtensor_fixed<real_t, 3, 3> jac{
+    {1., 0.5, 0.}, {0., 2., 0.25}, {0.125, 0., 3.}};
+  gt::gtensor<real_t, 2> jac_dyn = jac;
+
+  auto k_v = v.to_kernel();
+  auto k_w = w.to_kernel();
+  auto k_jac = jac.to_kernel();
+  auto k_jac_dyn = jac_dyn.to_kernel();
+
+  auto apply = [&](const auto& k_j) {
+    gt::launch_host<1>(gt::shape(n), [=](int i) {
+      for (int r = 0; r < k_j.shape(0); r++) {
+        real_t sum = 0.;
+        for (int c = 0; c < k_j.shape(1); c++) {
+          sum += k_j(r, c) * k_v(i, c);
+        }
+        k_w(i, r) = sum;
+      }
+    });
+  };
+
+  for (auto _ : state) {
+    if (Fixed) {
+      apply(k_jac);
+    } else {
+      apply(k_jac_dyn);
+    }
+    benchmark::DoNotOptimize(w.data());
+  }
+}
+
+BENCHMARK(BM_jacobian_3x3<false>)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_jacobian_3x3<true>)->Unit(benchmark::kMillisecond);
+
+// ======================================================================
+// BM_small_expr_3x3
+//
+// evaluate an expression of small matrices into a new one, as done per point
+// or per call in small-tensor code: allocates with dynamic shapes, and stays
+// on the stack with fixed extents
+
+template <bool Fixed>
+static void BM_small_expr_3x3(benchmark::State& state)
+{
+  using matrix_type = std::conditional_t<Fixed, gt::gtensor_fixed<real_t, 3, 3>,
+                                         gt::gtensor<real_t, 2>>;
+  matrix_type a = gt::gtensor_fixed<real_t, 3, 3>{
+    {1., 0.5, 0.}, {0., 2., 0.25}, {0.125, 0., 3.}};
+  matrix_type b = 2. * a;
+
+  for (auto _ : state) {
+    for (int i = 0; i < 1000; i++) {
+      matrix_type c = a + 0.5 * b;
+      benchmark::DoNotOptimize(c.data());
+    }
+  }
+}
+
+BENCHMARK(BM_small_expr_3x3<false>)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_small_expr_3x3<true>)->Unit(benchmark::kMicrosecond);
+
+// ======================================================================
+// BM_stencil_3d_layout, BM_stencil_3d_tiles
+//
+// 2nd order (7-point, H = 1) and 4th order (13-point, H = 2) laplacian on a
+// 3-d grid whose planes don't fit into the L2 cache, so that column-major
+// sweeps read the neighboring planes from further out. The grid is stored
+// column-major, in tiles or in Z-order and launched in the memory order of
+// the storage with per-element access (column-major order for Z-order, which
+// launch doesn't know), or, tiled, tile by tile through launch_tiles. The
+// tiles of 512 x 4 x 16 (256 kB) are deep in the slowest dimension, where
+// the halo comes from a neighboring tile that's a whole slab of tiles away,
+// while the neighbors in the middle dimension were just visited.
+
+using tiled_512x4x16 = gt::layout::tiled<512, 4, 16>;
+
+template <int H, typename A>
+GT_INLINE real_t laplacian(const A& a, int i, int j, int k)
+{
+  if (H == 1) {
+    return a(i - 1, j, k) + a(i + 1, j, k) + a(i, j - 1, k) + a(i, j + 1, k) +
+           a(i, j, k - 1) + a(i, j, k + 1) - 6. * a(i, j, k);
+  }
+  return -2.5 * a(i, j, k) +
+         4. / 3. *
+           (a(i - 1, j, k) + a(i + 1, j, k) + a(i, j - 1, k) +
+            a(i, j + 1, k) + a(i, j, k - 1) + a(i, j, k + 1)) -
+         1. / 12. *
+           (a(i - 2, j, k) + a(i + 2, j, k) + a(i, j - 2, k) +
+            a(i, j + 2, k) + a(i, j, k - 2) + a(i, j, k + 2));
+}
+
+template <typename E>
+static E stencil_3d_init(int n, int nz)
+{
+  gt::gtensor<real_t, 3> init(gt::shape(n, n, nz));
+  for (int i = 0; i < init.size(); i++) {
+    init.data()[i] = i % 17;
+  }
+  return E(init);
+}
+
+template <int H, typename E, typename L>
+static void BM_stencil_3d_layout(benchmark::State& state)
+{
+  int n = state.range(0);
+  int nz = state.range(1);
+  auto a = stencil_3d_init<E>(n, nz);
+  auto b = stencil_3d_init<E>(n, nz);
+  auto k_a = a.to_kernel();
+  auto k_b = b.to_kernel();
+
+  for (auto _ : state) {
+    gt::launch_host<3, L>(gt::shape(n - 2 * H, n - 2 * H, nz - 2 * H),
+                          [&](int i, int j, int k) {
+                            i += H, j += H, k += H;
+                            k_b(i, j, k) = laplacian<H>(k_a, i, j, k);
+                          });
+    benchmark::DoNotOptimize(b.data());
+  }
+}
+
+using gtensor_3d = gt::gtensor<real_t, 3>;
+using gtensor_tiled_3d = gt::gtensor_tiled<real_t, 3, tiled_512x4x16>;
+using gtensor_morton_3d = gt::gtensor_tiled<real_t, 3, gt::layout::morton>;
+
+template <int H>
+static void BM_stencil_3d_tiles(benchmark::State& state)
+{
+  int n = state.range(0);
+  int nz = state.range(1);
+  auto a = stencil_3d_init<gtensor_tiled_3d>(n, nz);
+  auto b = stencil_3d_init<gtensor_tiled_3d>(n, nz);
+
+  for (auto _ : state) {
+    gt::launch_tiles<H>(b, a, gt::shape(H, H, H),
+                        gt::shape(n - H, n - H, nz - H),
+                        [](const auto& o, const auto& a, int i, int j, int k) {
+                          o(i, j, k) = laplacian<H>(a, i, j, k);
+                        });
+    benchmark::DoNotOptimize(b.data());
+  }
+}
+
+BENCHMARK(BM_stencil_3d_layout<1, gtensor_3d, gt::layout::column_major>)
+  ->Args({1024, 64})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil_3d_layout<1, gtensor_tiled_3d, tiled_512x4x16>)
+  ->Args({1024, 64})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil_3d_layout<1, gtensor_morton_3d, gt::layout::column_major>)
+  ->Args({1024, 64})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil_3d_tiles<1>)
+  ->Args({1024, 64})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil_3d_layout<2, gtensor_3d, gt::layout::column_major>)
+  ->Args({1024, 64})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil_3d_tiles<2>)
+  ->Args({1024, 64})
+  ->Unit(benchmark::kMillisecond);
+
+// ======================================================================
+// BM_tiled_convert
+//
+// column-major <-> tiled, tile by tile vs element by element in column-major
+// order
+
+using gtensor_tiled_16x8x8 =
+  gt::gtensor_tiled<real_t, 3, gt::layout::tiled<16, 8, 8>>;
+
+template <bool ToTiled, bool Tilewise>
+static void BM_tiled_convert(benchmark::State& state)
+{
+  int n = state.range(0);
+  auto shape = gt::shape(n, n, n);
+  auto a = gt::zeros<real_t>(shape);
+  gtensor_tiled_16x8x8 t(shape, 0.);
+  auto k_a = a.to_kernel();
+  auto k_t = t.to_kernel();
+
+  for (auto _ : state) {
+    if (ToTiled && Tilewise) {
+      t = a;
+    } else if (ToTiled) {
+      gt::launch_host<3>(
+        shape, [&](int i, int j, int k) { k_t(i, j, k) = k_a(i, j, k); });
+    } else if (Tilewise) {
+      a = t;
+    } else {
+      a = t.view(_all, _all, _all);
+    }
+    benchmark::DoNotOptimize(a.data());
+    benchmark::DoNotOptimize(t.data());
+  }
+}
+
+#define BENCHMARK_TILED_CONVERT(ToTiled, Tilewise)                             \
+  BENCHMARK(BM_tiled_convert<ToTiled, Tilewise>)                               \
+    ->Arg(256)                                                                 \
+    ->Unit(benchmark::kMillisecond)
+
+BENCHMARK_TILED_CONVERT(true, false);
+BENCHMARK_TILED_CONVERT(true, true);
+BENCHMARK_TILED_CONVERT(false, false);
+BENCHMARK_TILED_CONVERT(false, true);
+
+// ======================================================================
+// BM_segmented
+//
+// assigning roll, concatenate and pad on a 3-d grid, split into segments vs
+// element by element through a view
+
+enum class segmented_op
+{
+  roll,
+  concatenate,
+  pad
+};
+
+template <segmented_op Op, bool Segmented>
+static void BM_segmented(benchmark::State& state)
+{
+  int n = state.range(0);
+  auto a = gt::zeros<real_t>(gt::shape(n, n, n));
+  gtensor_3d b;
+
+  auto run = [&](const auto& rhs) {
+    b = gtensor_3d(rhs.shape());
+    for (auto _ : state) {
+      if (Segmented) {
+        b = rhs;
+      } else {
+        b = rhs.view(_all, _all, _all);
+      }
+      benchmark::DoNotOptimize(b.data());
+    }
+  };
+
+  switch (Op) {
+    case segmented_op::roll: run(gt::roll(a, gt::shape(1, -2, 3))); break;
+    case segmented_op::concatenate: run(gt::concatenate(a, a, 2)); break;
+    case segmented_op::pad: run(gt::pad(a, gt::shape(8, 8, 8))); break;
+  }
+}
+
+#define BENCHMARK_SEGMENTED(Op)                                                \
+  BENCHMARK(BM_segmented<segmented_op::Op, false>)                             \
+    ->Arg(256)                                                                 \
+    ->Unit(benchmark::kMillisecond);                                           \
+  BENCHMARK(BM_segmented<segmented_op::Op, true>)                              \
+    ->Arg(256)                                                                 \
+    ->Unit(benchmark::kMillisecond)
+
+BENCHMARK_SEGMENTED(roll);
+BENCHMARK_SEGMENTED(concatenate);
+BENCHMARK_SEGMENTED(pad);
+
 BENCHMARK_MAIN();
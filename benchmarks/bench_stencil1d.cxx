@@ -4,6 +4,7 @@
 #include <benchmark/benchmark.h>
 
 #include <gtensor/gtensor.h>
+#include <gtensor/stencil.h>
 
 #include "gt-bm.h"
 
@@ -113,6 +114,86 @@ static void BM_stencil1d(benchmark::State& state)
   }
 }
 
+// same, as a single gt::stencil expression, with the scale folded into the
+// coefficients
+
+template <typename S, int... I>
+static auto stencil_op(const gt::bm::gtensor2<double, 1, S>& y, double scale,
+                       std::integer_sequence<int, I...>)
+{
+  const auto& coeffs = stencil_arrays[sizeof...(I)];
+  return gt::stencil<I...>({coeffs(I) * scale...}, y);
+}
+
+template <typename S, int N>
+static void BM_stencil1d_op(benchmark::State& state)
+{
+  int n = state.range(0) * MB;
+
+  gt::gtensor<double, 1> y(gt::shape(n));
+  gt::bm::gtensor2<double, 1, S> d_y(gt::shape(n));
+  gt::bm::gtensor2<double, 1, S> d_dydx_numeric(gt::shape(n - (N - 1)));
+  double lx = 8;
+  double dx = n / lx;
+  double scale = lx / n;
+
+  for (int i = 0; i < y.shape(0); i++) {
+    double xtmp = i * dx;
+    y(i) = xtmp * xtmp * xtmp;
+  }
+
+  gt::copy(y, d_y);
+  gt::synchronize();
+
+  auto expr = stencil_op<S>(d_y, scale, std::make_integer_sequence<int, N>{});
+
+  // warm up, force compile
+  d_dydx_numeric = expr;
+  gt::synchronize();
+
+  for (auto _ : state) {
+    d_dydx_numeric = expr;
+    gt::synchronize();
+  }
+}
+
+// smoother: K sweeps of a 3 point stencil, separately or temporally blocked
+template <typename S, int K, bool Blocked>
+static void BM_smoother(benchmark::State& state)
+{
+  using namespace gt::placeholders;
+  int n = state.range(0) * MB;
+
+  gt::gtensor<double, 1> y(gt::shape(n));
+  gt::bm::gtensor2<double, 1, S> d_y(gt::shape(n));
+  gt::bm::gtensor2<double, 1, S> d_tmp(gt::shape(n - 2));
+  for (int i = 0; i < y.shape(0); i++) {
+    y(i) = i % 7;
+  }
+  gt::copy(y, d_y);
+  gt::synchronize();
+
+  auto smooth = [&]() {
+    if (Blocked) {
+      gt::stencil_iterate<-1, 0, 1>({0.25, 0.5, 0.25}, d_y, K);
+    } else {
+      for (int k = 0; k < K; k++) {
+        d_tmp = gt::stencil<-1, 0, 1>({0.25, 0.5, 0.25}, d_y);
+        d_y.view(_s(1, -1)) = d_tmp;
+      }
+    }
+  };
+
+  // warm up, force compile
+  smooth();
+  gt::synchronize();
+
+  for (auto _ : state) {
+    smooth();
+    gt::synchronize();
+  }
+}
+
 BENCHMARK(BM_stencil1d<gt::space::device, 3>)
   ->Range(8, 256)
   ->Unit(benchmark::kMillisecond);
@@ -151,4 +232,67 @@ BENCHMARK(BM_stencil1d<gt::space::managed, 13>)
   ->Range(8, 256)
   ->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_stencil1d_op<gt::space::device, 3>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::device, 5>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::device, 7>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::device, 9>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::device, 11>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::device, 13>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_stencil1d_op<gt::space::managed, 3>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::managed, 5>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::managed, 7>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::managed, 9>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::managed, 11>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stencil1d_op<gt::space::managed, 13>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_smoother<gt::space::device, 4, false>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_smoother<gt::space::device, 4, true>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_smoother<gt::space::device, 16, false>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_smoother<gt::space::device, 16, true>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_smoother<gt::space::managed, 4, false>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_smoother<gt::space::managed, 4, true>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_smoother<gt::space::managed, 16, false>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_smoother<gt::space::managed, 16, true>)
+  ->Range(8, 256)
+  ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
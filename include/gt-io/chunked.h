@@ -0,0 +1,448 @@
+#ifndef GTENSOR_IO_CHUNKED_H
+#define GTENSOR_IO_CHUNKED_H
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+#include "gt-io/io.h"
+#include "gt-io/parallel.h"
+
+namespace gt
+{
+
+namespace io
+{
+
+// ======================================================================
+// chunked file format
+//
+// An array of shape `shape` is cut into a regular grid of chunks of shape
+// `chunk_shape` (edge chunks are truncated). Each chunk is stored as its
+// column-major elements, zlib compressed independently of the others, so
+// that a hyperslab can be read by decompressing only the chunks it touches.
+//
+//   header     magic, version, codec, element size, rank,
+//              shape[rank], chunk_shape[rank]          (chunked_header)
+//   index      (offset, nbytes) per chunk, chunks in column-major grid order
+//   data       chunk payloads, in the order they were finished
+//
+// A chunk whose nbytes equals its raw size is stored uncompressed; this is
+// used when compression doesn't pay off. All fields are in native byte
+// order.
+
+namespace detail
+{
+
+constexpr char chunked_magic[8] = {'G', 'T', 'C', 'H', 'U', 'N', 'K', '\0'};
+constexpr std::uint32_t chunked_version = 1;
+constexpr std::uint32_t chunked_codec_zlib = 1;
+
+struct chunked_header
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t codec;
+  std::uint32_t elem_size;
+  std::uint32_t rank;
+};
+
+struct chunked_index_entry
+{
+  std::uint64_t offset;
+  std::uint64_t nbytes;
+};
+
+template <size_type N>
+class chunk_grid
+{
+public:
+  chunk_grid() = default;
+
+  chunk_grid(const gt::shape_type<N>& shape,
+             const gt::shape_type<N>& chunk_shape)
+    : shape_(shape), chunk_shape_(chunk_shape)
+  {
+    for (int d = 0; d < N; d++) {
+      if (chunk_shape[d] <= 0) {
+        throw std::runtime_error(
+          "gt::io::chunked: chunk extents must be positive");
+      }
+      n_chunks_[d] = (shape[d] + chunk_shape[d] - 1) / chunk_shape[d];
+    }
+  }
+
+  size_type size() const { return calc_size(n_chunks_); }
+
+  const gt::shape_type<N>& shape() const { return shape_; }
+  const gt::shape_type<N>& chunk_shape() const { return chunk_shape_; }
+  const gt::shape_type<N>& n_chunks() const { return n_chunks_; }
+
+  // grid coordinates of chunk number i
+  gt::shape_type<N> coords(size_type i) const
+  {
+    gt::shape_type<N> c;
+    for (int d = 0; d < N; d++) {
+      c[d] = i % n_chunks_[d];
+      i /= n_chunks_[d];
+    }
+    return c;
+  }
+
+  size_type number(const gt::shape_type<N>& c) const
+  {
+    size_type i = 0;
+    for (int d = N - 1; d >= 0; d--) {
+      i = i * n_chunks_[d] + c[d];
+    }
+    return i;
+  }
+
+  gt::shape_type<N> origin(const gt::shape_type<N>& c) const
+  {
+    gt::shape_type<N> o;
+    for (int d = 0; d < N; d++) {
+      o[d] = c[d] * chunk_shape_[d];
+    }
+    return o;
+  }
+
+  // shape of the (possibly truncated) chunk at grid coordinates c
+  gt::shape_type<N> extents(const gt::shape_type<N>& c) const
+  {
+    gt::shape_type<N> e;
+    for (int d = 0; d < N; d++) {
+      e[d] = std::min(chunk_shape_[d], shape_[d] - c[d] * chunk_shape_[d]);
+    }
+    return e;
+  }
+
+private:
+  gt::shape_type<N> shape_;
+  gt::shape_type<N> chunk_shape_;
+  gt::shape_type<N> n_chunks_;
+};
+
+template <size_type N>
+inline size_type chunked_header_bytes()
+{
+  return sizeof(chunked_header) + 2 * N * sizeof(std::uint64_t);
+}
+
+class unique_fd
+{
+public:
+  explicit unique_fd(int fd) : fd_(fd) {}
+  ~unique_fd()
+  {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+  unique_fd(const unique_fd&) = delete;
+  unique_fd& operator=(const unique_fd&) = delete;
+
+  int get() const { return fd_; }
+
+  int release()
+  {
+    int fd = fd_;
+    fd_ = -1;
+    return fd;
+  }
+
+private:
+  int fd_;
+};
+
+template <typename E>
+inline void write_chunked_impl(const std::string& path, const E& e,
+                               const gt::shape_type<expr_dimension<E>()>&
+                                 chunk_shape,
+                               int n_threads, int level)
+{
+  constexpr size_type N = expr_dimension<E>();
+  using T = std::decay_t<expr_value_type<E>>;
+
+  chunk_grid<N> grid(e.shape(), chunk_shape);
+  const size_type n_chunks = grid.size();
+  const size_type header_bytes = chunked_header_bytes<N>();
+  const size_type data_offset =
+    header_bytes + n_chunks * sizeof(chunked_index_entry);
+
+  unique_fd fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+  if (fd.get() < 0) {
+    throw io_error("write_chunked");
+  }
+
+  const T* base = e.size() > 0 ? &e.data_access(0) : nullptr;
+  const auto src_strides = to_ptrdiff(e.strides());
+  std::vector<chunked_index_entry> index(n_chunks);
+  std::mutex alloc_mutex;
+  size_type data_end = data_offset;
+
+  parallel_for(n_chunks, n_threads, [&](size_type i) {
+    auto c = grid.coords(i);
+    auto o = grid.origin(c);
+    auto ext = grid.extents(c);
+
+    const T* src = base;
+    for (int d = 0; d < N; d++) {
+      src += o[d] * src_strides[d];
+    }
+    std::vector<T> raw(calc_size(ext));
+    copy_strided(raw.data(), contiguous_strides(ext), src, src_strides, ext);
+
+    const size_type raw_bytes = raw.size() * sizeof(T);
+    std::vector<Bytef> packed(compressBound(raw_bytes));
+    uLongf packed_bytes = packed.size();
+    int rc = compress2(packed.data(), &packed_bytes,
+                       reinterpret_cast<const Bytef*>(raw.data()), raw_bytes,
+                       level);
+    if (rc != Z_OK) {
+      throw std::runtime_error("gt::io::write_chunked: compression failed");
+    }
+
+    const void* payload = packed.data();
+    size_type nbytes = packed_bytes;
+    if (nbytes >= raw_bytes) {
+      payload = raw.data();
+      nbytes = raw_bytes;
+    }
+
+    size_type offset;
+    {
+      std::lock_guard<std::mutex> lock(alloc_mutex);
+      offset = data_end;
+      data_end += nbytes;
+    }
+    pwrite_all(fd.get(), payload, nbytes, offset);
+    index[i] = {offset, nbytes};
+  });
+
+  std::vector<char> header(header_bytes);
+  chunked_header h;
+  std::memcpy(h.magic, chunked_magic, sizeof(h.magic));
+  h.version = chunked_version;
+  h.codec = chunked_codec_zlib;
+  h.elem_size = sizeof(T);
+  h.rank = N;
+  std::memcpy(header.data(), &h, sizeof(h));
+  auto* dims = reinterpret_cast<std::uint64_t*>(header.data() + sizeof(h));
+  for (int d = 0; d < N; d++) {
+    dims[d] = grid.shape()[d];
+    dims[N + d] = grid.chunk_shape()[d];
+  }
+  pwrite_all(fd.get(), header.data(), header.size(), 0);
+  pwrite_all(fd.get(), index.data(), index.size() * sizeof(chunked_index_entry),
+             header_bytes);
+
+  if (::close(fd.release()) != 0) {
+    throw io_error("write_chunked");
+  }
+}
+
+} // namespace detail
+
+// ======================================================================
+// write_chunked
+//
+// Writes a host expression to a new file `path` in the chunked format,
+// compressing chunks of shape `chunk_shape` in parallel on n_threads threads
+// (<= 0: one per hardware thread). `level` is the zlib compression level.
+// Containers, spans and views of those are gathered chunk by chunk straight
+// from their strides; other expressions are evaluated first.
+
+template <typename E>
+inline std::enable_if_t<is_data_strided_v<E>> write_chunked(
+  const std::string& path, const E& e,
+  const gt::shape_type<expr_dimension<E>()>& chunk_shape, int n_threads = 0,
+  int level = Z_DEFAULT_COMPRESSION)
+{
+  static_assert(std::is_same<expr_space_type<E>, gt::space::host>::value,
+                "gt::io::write_chunked: only host expressions are supported");
+  detail::write_chunked_impl(path, e, chunk_shape, n_threads, level);
+}
+
+template <typename E>
+inline std::enable_if_t<!is_data_strided_v<E>> write_chunked(
+  const std::string& path, const E& e,
+  const gt::shape_type<expr_dimension<E>()>& chunk_shape, int n_threads = 0,
+  int level = Z_DEFAULT_COMPRESSION)
+{
+  write_chunked(path, gt::eval(e), chunk_shape, n_threads, level);
+}
+
+// ======================================================================
+// chunked_reader
+//
+// Random access to a file written by write_chunked. read(origin, dst) fills
+// dst with the hyperslab [origin, origin + dst.shape()), decompressing (in
+// parallel) only the chunks that intersect it.
+
+template <typename T, size_type N>
+class chunked_reader
+{
+public:
+  using value_type = T;
+  using shape_type = gt::shape_type<N>;
+
+  explicit chunked_reader(const std::string& path, int n_threads = 0)
+    : fd_(::open(path.c_str(), O_RDONLY)), n_threads_(n_threads)
+  {
+    if (fd_.get() < 0) {
+      throw detail::io_error("chunked_reader");
+    }
+
+    std::vector<char> header(detail::chunked_header_bytes<N>());
+    detail::chunked_header h;
+    detail::pread_all(fd_.get(), &h, sizeof(h), 0);
+    if (std::memcmp(h.magic, detail::chunked_magic, sizeof(h.magic)) != 0 ||
+        h.version != detail::chunked_version) {
+      throw std::runtime_error("gt::io::chunked_reader: '" + path +
+                               "' is not a chunked gtensor file");
+    }
+    if (h.codec != detail::chunked_codec_zlib) {
+      throw std::runtime_error("gt::io::chunked_reader: unsupported codec");
+    }
+    if (h.elem_size != sizeof(T) || h.rank != N) {
+      throw std::runtime_error(
+        "gt::io::chunked_reader: element size or rank mismatch");
+    }
+
+    detail::pread_all(fd_.get(), header.data(), header.size(), 0);
+    auto* dims =
+      reinterpret_cast<const std::uint64_t*>(header.data() + sizeof(h));
+    shape_type shape, chunk_shape;
+    for (int d = 0; d < N; d++) {
+      shape[d] = dims[d];
+      chunk_shape[d] = dims[N + d];
+    }
+    grid_ = detail::chunk_grid<N>(shape, chunk_shape);
+
+    index_.resize(grid_.size());
+    detail::pread_all(fd_.get(), index_.data(),
+                      index_.size() * sizeof(detail::chunked_index_entry),
+                      header.size());
+  }
+
+  const shape_type& shape() const { return grid_.shape(); }
+  const shape_type& chunk_shape() const { return grid_.chunk_shape(); }
+  size_type n_chunks() const { return grid_.size(); }
+
+  // read the hyperslab starting at origin into a host container, span or
+  // view of those
+  template <typename E>
+  void read(const shape_type& origin, E&& dst) const
+  {
+    static_assert(is_data_strided_v<E>,
+                  "gt::io::chunked_reader::read: destination must be a "
+                  "container, span or view of those");
+    static_assert(std::is_same<expr_space_type<E>, gt::space::host>::value,
+                  "gt::io::chunked_reader::read: only host expressions are "
+                  "supported");
+    static_assert(
+      std::is_same<std::decay_t<expr_value_type<E>>, T>::value,
+      "gt::io::chunked_reader::read: destination value type mismatch");
+    static_assert(expr_dimension<E>() == N,
+                  "gt::io::chunked_reader::read: destination rank mismatch");
+
+    const shape_type ext = dst.shape();
+    for (int d = 0; d < N; d++) {
+      if (origin[d] < 0 || ext[d] < 0 || origin[d] + ext[d] > shape()[d]) {
+        throw std::runtime_error(
+          "gt::io::chunked_reader::read: hyperslab out of bounds");
+      }
+    }
+    if (calc_size(ext) == 0) {
+      return;
+    }
+
+    // box of chunk grid coordinates touched by the hyperslab
+    shape_type c_lo, c_n;
+    for (int d = 0; d < N; d++) {
+      c_lo[d] = origin[d] / chunk_shape()[d];
+      c_n[d] = (origin[d] + ext[d] - 1) / chunk_shape()[d] - c_lo[d] + 1;
+    }
+
+    T* dst_base = &dst.data_access(0);
+    const auto dst_strides = detail::to_ptrdiff(dst.strides());
+
+    detail::parallel_for(calc_size(c_n), n_threads_, [&](size_type k) {
+      shape_type c;
+      for (int d = 0; d < N; d++) {
+        c[d] = c_lo[d] + k % c_n[d];
+        k /= c_n[d];
+      }
+      auto c_origin = grid_.origin(c);
+      auto c_ext = grid_.extents(c);
+      std::vector<T> chunk(calc_size(c_ext));
+      load_chunk(grid_.number(c), chunk);
+
+      // intersection of the chunk with the hyperslab
+      shape_type lo, n;
+      for (int d = 0; d < N; d++) {
+        lo[d] = std::max(origin[d], c_origin[d]);
+        n[d] = std::min(origin[d] + ext[d], c_origin[d] + c_ext[d]) - lo[d];
+      }
+      const auto chunk_strides = detail::contiguous_strides(c_ext);
+      const T* src = chunk.data();
+      T* p = dst_base;
+      for (int d = 0; d < N; d++) {
+        src += (lo[d] - c_origin[d]) * chunk_strides[d];
+        p += (lo[d] - origin[d]) * dst_strides[d];
+      }
+      detail::copy_strided(p, dst_strides, src, chunk_strides, n);
+    });
+  }
+
+  // read the whole array
+  gt::gtensor<T, N, gt::space::host> read() const
+  {
+    gt::gtensor<T, N, gt::space::host> h(shape());
+    shape_type origin;
+    for (int d = 0; d < N; d++) {
+      origin[d] = 0;
+    }
+    read(origin, h);
+    return h;
+  }
+
+private:
+  void load_chunk(size_type i, std::vector<T>& chunk) const
+  {
+    const auto& entry = index_[i];
+    const size_type raw_bytes = chunk.size() * sizeof(T);
+    if (entry.nbytes == raw_bytes) {
+      detail::pread_all(fd_.get(), chunk.data(), raw_bytes, entry.offset);
+      return;
+    }
+    std::vector<Bytef> packed(entry.nbytes);
+    detail::pread_all(fd_.get(), packed.data(), packed.size(), entry.offset);
+    uLongf n = raw_bytes;
+    int rc = uncompress(reinterpret_cast<Bytef*>(chunk.data()), &n,
+                        packed.data(), packed.size());
+    if (rc != Z_OK || n != raw_bytes) {
+      throw std::runtime_error("gt::io::chunked_reader: corrupt chunk");
+    }
+  }
+
+  detail::unique_fd fd_;
+  int n_threads_;
+  detail::chunk_grid<N> grid_;
+  std::vector<detail::chunked_index_entry> index_;
+};
+
+} // namespace io
+
+} // namespace gt
+
+#endif // GTENSOR_IO_CHUNKED_H
@@ -0,0 +1,460 @@
+#ifndef GTENSOR_IO_H
+#define GTENSOR_IO_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "gtensor/gtensor.h"
+
+namespace gt
+{
+
+namespace io
+{
+
+// ======================================================================
+// is_data_strided
+//
+// true for expressions whose elements all live in one host buffer and can be
+// addressed as base pointer + index * strides: containers, spans, and
+// (possibly nested) views of those. Reshape and other adapted views do not
+// qualify, since their strides are logical rather than storage strides.
+
+template <typename E>
+struct is_data_strided : gt::detail::is_data_strided<std::decay_t<E>>
+{};
+
+template <typename E>
+constexpr bool is_data_strided_v = is_data_strided<E>::value;
+
+namespace detail
+{
+
+// ======================================================================
+// strided_runs
+//
+// Collapses the logical (column-major) traversal of a strided layout into
+// runs of contiguous elements. Size one dimensions are dropped, leading
+// dimensions with unit-compatible strides form the run, and adjacent outer
+// dimensions that are contiguous w.r.t. each other are merged, so the
+// odometer over the remaining dimensions is as short as possible.
+
+template <typename T>
+class strided_runs
+{
+public:
+  template <size_type N>
+  strided_runs(T* base, const gt::shape_type<N>& shape,
+               const gt::strides_type<N>& strides)
+    : base_(base), run_(1), n_runs_(1)
+  {
+    if (calc_size(shape) == 0) {
+      n_runs_ = 0;
+      return;
+    }
+    std::ptrdiff_t run_stride = 1;
+    int d = 0;
+    for (; d < N; d++) {
+      if (shape[d] == 1) {
+        continue;
+      }
+      if (strides[d] != run_stride) {
+        break;
+      }
+      run_ *= shape[d];
+      run_stride *= shape[d];
+    }
+    for (; d < N; d++) {
+      if (shape[d] == 1) {
+        continue;
+      }
+      if (!extents_.empty() &&
+          strides[d] == strides_.back() * std::ptrdiff_t(extents_.back())) {
+        extents_.back() *= shape[d];
+      } else {
+        extents_.push_back(shape[d]);
+        strides_.push_back(strides[d]);
+      }
+      n_runs_ *= shape[d];
+    }
+  }
+
+  // number of elements in each contiguous run
+  size_type run_length() const { return run_; }
+
+  size_type n_runs() const { return n_runs_; }
+
+  // calls f(T* p, size_type n) for each run, in logical order
+  template <typename F>
+  void for_each(F&& f) const
+  {
+    if (n_runs_ == 0) {
+      return;
+    }
+    const int nd = extents_.size();
+    std::vector<size_type> idx(nd, 0);
+    T* p = base_;
+    for (size_type r = 0; r < n_runs_; r++) {
+      f(p, run_);
+      for (int d = 0; d < nd; d++) {
+        if (++idx[d] < extents_[d]) {
+          p += strides_[d];
+          break;
+        }
+        idx[d] = 0;
+        p -= strides_[d] * std::ptrdiff_t(extents_[d] - 1);
+      }
+    }
+  }
+
+private:
+  T* base_;
+  size_type run_;
+  size_type n_runs_;
+  std::vector<size_type> extents_;
+  std::vector<std::ptrdiff_t> strides_;
+};
+
+template <typename E>
+inline auto make_strided_runs(E& e)
+{
+  using T = std::remove_reference_t<decltype(e.data_access(0))>;
+  T* base = e.size() > 0 ? &e.data_access(0) : nullptr;
+  return strided_runs<T>(base, e.shape(), e.strides());
+}
+
+inline std::runtime_error io_error(const char* where)
+{
+  return std::runtime_error(std::string("gt::io::") + where + ": " +
+                            std::strerror(errno));
+}
+
+// ======================================================================
+// transfer_all
+//
+// issue readv / writev until all bytes described by iov have been
+// transferred, handling short transfers and EINTR. iov is modified. If offset
+// is given, preadv / pwritev at *offset are used instead, and *offset is
+// advanced past the transferred bytes.
+
+template <bool Write>
+inline void transfer_all(int fd, struct iovec* iov, int cnt,
+                         off_t* offset = nullptr)
+{
+  while (cnt > 0) {
+    ssize_t n;
+    if (offset) {
+      n = Write ? ::pwritev(fd, iov, cnt, *offset)
+                : ::preadv(fd, iov, cnt, *offset);
+    } else {
+      n = Write ? ::writev(fd, iov, cnt) : ::readv(fd, iov, cnt);
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw io_error(Write ? "write" : "read");
+    }
+    if (n == 0) {
+      throw std::runtime_error(Write ? "gt::io::write: no progress"
+                                     : "gt::io::read: unexpected end of file");
+    }
+    if (offset) {
+      *offset += n;
+    }
+    while (cnt > 0 && size_type(n) >= iov->iov_len) {
+      n -= iov->iov_len;
+      iov++;
+      cnt--;
+    }
+    if (cnt > 0) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+      iov->iov_len -= n;
+    }
+  }
+}
+
+// ======================================================================
+// pwrite_all / pread_all
+//
+// positioned transfer of exactly nbytes, handling short transfers and EINTR.
+// Does not move the file position, so may be used concurrently on one fd.
+
+inline void pwrite_all(int fd, const void* buf, size_type nbytes, off_t offset)
+{
+  const char* p = static_cast<const char*>(buf);
+  while (nbytes > 0) {
+    ssize_t n = ::pwrite(fd, p, nbytes, offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw io_error("write");
+    }
+    if (n == 0) {
+      throw std::runtime_error("gt::io::write: no progress");
+    }
+    p += n;
+    nbytes -= n;
+    offset += n;
+  }
+}
+
+inline void pread_all(int fd, void* buf, size_type nbytes, off_t offset)
+{
+  char* p = static_cast<char*>(buf);
+  while (nbytes > 0) {
+    ssize_t n = ::pread(fd, p, nbytes, offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw io_error("read");
+    }
+    if (n == 0) {
+      throw std::runtime_error("gt::io::read: unexpected end of file");
+    }
+    p += n;
+    nbytes -= n;
+    offset += n;
+  }
+}
+
+// ======================================================================
+// copy_strided
+//
+// copies a hyperslab of the given shape between two strided layouts, with
+// memcpy for the inner dimension when both sides are contiguous in it.
+
+template <typename T, size_type N>
+inline void copy_strided(T* dst,
+                         const gt::sarray<std::ptrdiff_t, N>& dst_strides,
+                         const T* src,
+                         const gt::sarray<std::ptrdiff_t, N>& src_strides,
+                         const gt::shape_type<N>& shape)
+{
+  if (calc_size(shape) == 0) {
+    return;
+  }
+  const bool contiguous = dst_strides[0] == 1 && src_strides[0] == 1;
+  gt::shape_type<N> idx;
+  for (int d = 0; d < N; d++) {
+    idx[d] = 0;
+  }
+  while (true) {
+    if (contiguous) {
+      std::memcpy(dst, src, shape[0] * sizeof(T));
+    } else {
+      for (int i = 0; i < shape[0]; i++) {
+        dst[i * dst_strides[0]] = src[i * src_strides[0]];
+      }
+    }
+    int d = 1;
+    for (; d < N; d++) {
+      if (++idx[d] < shape[d]) {
+        dst += dst_strides[d];
+        src += src_strides[d];
+        break;
+      }
+      idx[d] = 0;
+      dst -= dst_strides[d] * (shape[d] - 1);
+      src -= src_strides[d] * (shape[d] - 1);
+    }
+    if (d >= N) {
+      break;
+    }
+  }
+}
+
+// strides of a contiguous column-major layout; unlike calc_strides, size one
+// dimensions get their regular stride
+template <size_type N>
+inline gt::sarray<std::ptrdiff_t, N> contiguous_strides(
+  const gt::shape_type<N>& shape)
+{
+  gt::sarray<std::ptrdiff_t, N> strides;
+  std::ptrdiff_t stride = 1;
+  for (int d = 0; d < N; d++) {
+    strides[d] = stride;
+    stride *= shape[d];
+  }
+  return strides;
+}
+
+template <size_type N>
+inline gt::sarray<std::ptrdiff_t, N> to_ptrdiff(const gt::strides_type<N>& s)
+{
+  gt::sarray<std::ptrdiff_t, N> r;
+  for (int d = 0; d < N; d++) {
+    r[d] = s[d];
+  }
+  return r;
+}
+
+// ======================================================================
+// iov_batch
+//
+// Accumulates runs into a vectored I/O request. Runs of at least
+// direct_bytes go straight from / to user memory, shorter runs are packed
+// into a bounded bounce buffer so that e.g. a view with a non-unit inner
+// stride doesn't turn into one iovec per element. With an offset, the batch
+// is transferred with positioned I/O starting at that file offset.
+
+template <bool Write>
+class iov_batch
+{
+public:
+  static constexpr size_type direct_bytes = 4096;
+  static constexpr size_type bounce_bytes = 1 << 20;
+
+  iov_batch(int fd, off_t offset = -1)
+    : fd_(fd), offset_(offset), bounce_(bounce_bytes), bounce_used_(0)
+  {
+#ifdef IOV_MAX
+    max_iov_ = IOV_MAX;
+#else
+    max_iov_ = 1024;
+#endif
+    iov_.reserve(max_iov_);
+  }
+
+  void add(void* p, size_type nbytes)
+  {
+    if (iov_.size() == max_iov_ ||
+        (nbytes < direct_bytes && bounce_used_ + nbytes > bounce_.size())) {
+      flush();
+    }
+    if (nbytes >= direct_bytes) {
+      iov_.push_back({p, nbytes});
+      return;
+    }
+    char* b = bounce_.data() + bounce_used_;
+    if (Write) {
+      std::memcpy(b, p, nbytes);
+    } else {
+      pending_.push_back({p, bounce_used_, nbytes});
+    }
+    if (!iov_.empty() &&
+        static_cast<char*>(iov_.back().iov_base) + iov_.back().iov_len == b) {
+      iov_.back().iov_len += nbytes;
+    } else {
+      iov_.push_back({b, nbytes});
+    }
+    bounce_used_ += nbytes;
+  }
+
+  void flush()
+  {
+    if (iov_.empty()) {
+      return;
+    }
+    transfer_all<Write>(fd_, iov_.data(), iov_.size(),
+                        offset_ >= 0 ? &offset_ : nullptr);
+    if (!Write) {
+      for (const auto& s : pending_) {
+        std::memcpy(s.dst, bounce_.data() + s.offset, s.nbytes);
+      }
+      pending_.clear();
+    }
+    iov_.clear();
+    bounce_used_ = 0;
+  }
+
+private:
+  struct scatter_entry
+  {
+    void* dst;
+    size_type offset;
+    size_type nbytes;
+  };
+
+  int fd_;
+  off_t offset_;
+  size_type max_iov_;
+  std::vector<struct iovec> iov_;
+  std::vector<char> bounce_;
+  size_type bounce_used_;
+  std::vector<scatter_entry> pending_;
+};
+
+} // namespace detail
+
+// ======================================================================
+// write
+//
+// Writes the elements of a host expression to fd at the current file
+// position, in logical (column-major) order, i.e. the file contents are
+// the same as for gt::eval(e). Data strided expressions (containers, spans
+// and views of those) are streamed directly from their strides using
+// vectored I/O, without materializing a contiguous temporary. Other
+// expressions are evaluated first. Returns the number of bytes written.
+
+template <typename E>
+inline std::enable_if_t<is_data_strided_v<E>, size_type> write(int fd,
+                                                               const E& e)
+{
+  static_assert(std::is_same<expr_space_type<E>, gt::space::host>::value,
+                "gt::io::write: only host expressions are supported");
+  using T = std::decay_t<expr_value_type<E>>;
+
+  auto runs = detail::make_strided_runs(e);
+  {
+    detail::iov_batch<true> batch(fd);
+    runs.for_each([&](const T* p, size_type n) {
+      batch.add(const_cast<T*>(p), n * sizeof(T));
+    });
+    batch.flush();
+  }
+  return e.size() * sizeof(T);
+}
+
+template <typename E>
+inline std::enable_if_t<!is_data_strided_v<E>, size_type> write(int fd,
+                                                                const E& e)
+{
+  return write(fd, gt::eval(e));
+}
+
+// ======================================================================
+// read
+//
+// Reads elements from fd at the current file position into a host data
+// strided expression, scattering them according to its strides. This is the
+// inverse of write(). Returns the number of bytes read.
+
+template <typename E>
+inline size_type read(int fd, E&& e)
+{
+  static_assert(is_data_strided_v<E>,
+                "gt::io::read: destination must be a container, span or view "
+                "of those");
+  static_assert(std::is_same<expr_space_type<E>, gt::space::host>::value,
+                "gt::io::read: only host expressions are supported");
+  using T = std::decay_t<expr_value_type<E>>;
+  static_assert(!std::is_const<std::remove_reference_t<decltype(
+                  e.data_access(0))>>::value,
+                "gt::io::read: destination must not be const");
+
+  auto runs = detail::make_strided_runs(e);
+  {
+    detail::iov_batch<false> batch(fd);
+    runs.for_each([&](T* p, size_type n) { batch.add(p, n * sizeof(T)); });
+    batch.flush();
+  }
+  return e.size() * sizeof(T);
+}
+
+} // namespace io
+
+} // namespace gt
+
+#endif // GTENSOR_IO_H
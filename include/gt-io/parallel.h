@@ -0,0 +1,231 @@
+#ifndef GTENSOR_IO_PARALLEL_H
+#define GTENSOR_IO_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "gt-io/io.h"
+
+namespace gt
+{
+
+namespace io
+{
+
+namespace detail
+{
+
+// number of worker threads to use when the caller passes n_threads <= 0
+inline int default_n_threads()
+{
+  int n = std::thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+// ======================================================================
+// parallel_for
+//
+// calls f(i) for i in [0, n) from up to n_threads threads, handing out work
+// items dynamically. The first exception thrown by f stops the remaining
+// work and is rethrown in the calling thread after all workers have joined.
+
+template <typename F>
+inline void parallel_for(size_type n, int n_threads, F&& f)
+{
+  if (n_threads <= 0) {
+    n_threads = default_n_threads();
+  }
+  n_threads = std::min<size_type>(n_threads, n);
+  if (n_threads <= 1) {
+    for (size_type i = 0; i < n; i++) {
+      f(i);
+    }
+    return;
+  }
+
+  std::atomic<size_type> next{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto worker = [&]() {
+    while (!failed.load(std::memory_order_relaxed)) {
+      size_type i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= n) {
+        break;
+      }
+      try {
+        f(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(n_threads - 1);
+  for (int t = 1; t < n_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// ======================================================================
+// preallocate
+//
+// makes sure the file is at least `end` bytes long, reserving the blocks up
+// front where the file system supports it, so that concurrent positioned
+// writes don't contend on extending the file.
+
+inline void preallocate(int fd, off_t end)
+{
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    throw io_error("preallocate");
+  }
+  if (st.st_size >= end) {
+    return;
+  }
+  int rc = ::posix_fallocate(fd, st.st_size, end - st.st_size);
+  if (rc == 0) {
+    return;
+  }
+  if (rc != EINVAL && rc != EOPNOTSUPP) {
+    errno = rc;
+    throw io_error("preallocate");
+  }
+  if (::ftruncate(fd, end) != 0) {
+    throw io_error("preallocate");
+  }
+}
+
+// calls f(base, shape, offset) for each of up to n_parts slabs along the
+// slowest (last) dimension of a strided layout, where offset is the
+// position of the slab's first element in logical order
+template <typename T, size_type N, typename F>
+inline void for_each_slab(T* base, const gt::shape_type<N>& shape,
+                          const gt::strides_type<N>& strides, int n_parts,
+                          F&& f)
+{
+  const int n_slow = shape[N - 1];
+  const size_type slice_size = calc_size(shape) / std::max(n_slow, 1);
+  if (n_parts <= 0) {
+    n_parts = default_n_threads();
+  }
+  n_parts = std::max(std::min(n_parts, n_slow), 1);
+
+  parallel_for(n_parts, n_parts, [&](size_type part) {
+    int begin = n_slow * part / n_parts;
+    int end = n_slow * (part + 1) / n_parts;
+    gt::shape_type<N> slab_shape = shape;
+    slab_shape[N - 1] = end - begin;
+    f(base + std::ptrdiff_t(begin) * strides[N - 1], slab_shape,
+      size_type(begin) * slice_size);
+  });
+}
+
+} // namespace detail
+
+// ======================================================================
+// write_parallel
+//
+// Writes a host expression to fd at file position `offset`, producing the
+// same file contents as write(). The expression is partitioned along its
+// slowest dimension into slabs that are written concurrently with
+// positioned vectored I/O from n_threads threads (<= 0: one per hardware
+// thread) into the preallocated file. The file position is not used or
+// changed. Returns the number of bytes written.
+
+template <typename E>
+inline std::enable_if_t<is_data_strided_v<E>, size_type> write_parallel(
+  int fd, const E& e, off_t offset = 0, int n_threads = 0)
+{
+  static_assert(std::is_same<expr_space_type<E>, gt::space::host>::value,
+                "gt::io::write_parallel: only host expressions are supported");
+  using T = std::decay_t<expr_value_type<E>>;
+
+  const size_type nbytes = e.size() * sizeof(T);
+  if (nbytes == 0) {
+    return 0;
+  }
+  detail::preallocate(fd, offset + nbytes);
+  detail::for_each_slab(
+    &e.data_access(0), e.shape(), e.strides(), n_threads,
+    [&](const T* base, const auto& shape, size_type first) {
+      detail::iov_batch<true> batch(fd, offset + first * sizeof(T));
+      detail::strided_runs<const T>(base, shape, e.strides())
+        .for_each([&](const T* p, size_type n) {
+          batch.add(const_cast<T*>(p), n * sizeof(T));
+        });
+      batch.flush();
+    });
+  return nbytes;
+}
+
+template <typename E>
+inline std::enable_if_t<!is_data_strided_v<E>, size_type> write_parallel(
+  int fd, const E& e, off_t offset = 0, int n_threads = 0)
+{
+  return write_parallel(fd, gt::eval(e), offset, n_threads);
+}
+
+// ======================================================================
+// read_parallel
+//
+// Reads elements starting at file position `offset` into a host data
+// strided expression, the inverse of write_parallel(). Slabs along the
+// slowest dimension are read concurrently by n_threads threads. Returns the
+// number of bytes read.
+
+template <typename E>
+inline size_type read_parallel(int fd, E&& e, off_t offset = 0,
+                               int n_threads = 0)
+{
+  static_assert(is_data_strided_v<E>,
+                "gt::io::read_parallel: destination must be a container, span "
+                "or view of those");
+  static_assert(std::is_same<expr_space_type<E>, gt::space::host>::value,
+                "gt::io::read_parallel: only host expressions are supported");
+  using T = std::decay_t<expr_value_type<E>>;
+  static_assert(!std::is_const<std::remove_reference_t<decltype(
+                  e.data_access(0))>>::value,
+                "gt::io::read_parallel: destination must not be const");
+
+  const size_type nbytes = e.size() * sizeof(T);
+  if (nbytes == 0) {
+    return 0;
+  }
+  detail::for_each_slab(
+    &e.data_access(0), e.shape(), e.strides(), n_threads,
+    [&](T* base, const auto& shape, size_type first) {
+      detail::iov_batch<false> batch(fd, offset + first * sizeof(T));
+      detail::strided_runs<T>(base, shape, e.strides())
+        .for_each([&](T* p, size_type n) { batch.add(p, n * sizeof(T)); });
+      batch.flush();
+    });
+  return nbytes;
+}
+
+} // namespace io
+
+} // namespace gt
+
+#endif // GTENSOR_IO_PARALLEL_H
@@ -0,0 +1,341 @@
+#ifndef GTENSOR_IO_STREAM_H
+#define GTENSOR_IO_STREAM_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gt-io/io.h"
+
+namespace gt
+{
+
+namespace io
+{
+
+// ======================================================================
+// mapped_file
+//
+// Read-only memory mapping of an array stored raw (as written by
+// gt::io::write) at `offset` in a file. Slabs along the slowest (last)
+// dimension are exposed as host spans, so they can be used in expressions
+// directly. The OS can be told ahead of time which slabs will be needed
+// next and which are done with, to overlap readahead with compute and keep
+// the resident set bounded.
+
+template <typename T, size_type N>
+class mapped_file
+{
+public:
+  using value_type = T;
+  using shape_type = gt::shape_type<N>;
+
+  mapped_file(const std::string& path, const shape_type& shape,
+              off_t offset = 0)
+    : shape_(shape), slice_size_(1)
+  {
+    for (int d = 0; d < N - 1; d++) {
+      slice_size_ *= shape[d];
+    }
+    const size_type nbytes = calc_size(shape) * sizeof(T);
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw detail::io_error("mapped_file");
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || size_type(st.st_size) < offset + nbytes) {
+      ::close(fd);
+      throw std::runtime_error("gt::io::mapped_file: '" + path +
+                               "' is too small for the given shape");
+    }
+
+    // mmap offsets need to be page aligned
+    const off_t page = ::sysconf(_SC_PAGESIZE);
+    const off_t map_offset = offset / page * page;
+    map_bytes_ = nbytes + (offset - map_offset);
+    map_ = map_bytes_ > 0 ? ::mmap(nullptr, map_bytes_, PROT_READ, MAP_SHARED,
+                                   fd, map_offset)
+                          : nullptr;
+    ::close(fd);
+    if (map_ == MAP_FAILED) {
+      map_ = nullptr;
+      throw detail::io_error("mapped_file");
+    }
+    if (map_) {
+      data_ = reinterpret_cast<const T*>(static_cast<const char*>(map_) +
+                                         (offset - map_offset));
+    }
+  }
+
+  ~mapped_file()
+  {
+    if (map_) {
+      ::munmap(map_, map_bytes_);
+    }
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  const shape_type& shape() const { return shape_; }
+  int shape(int i) const { return shape_[i]; }
+
+  // extent of the slowest dimension
+  int n_slabs() const { return shape_[N - 1]; }
+
+  // the whole array
+  auto span() const { return gt::adapt<N>(data_, shape_); }
+
+  // elements [begin, end) along the slowest dimension
+  auto slab(int begin, int end) const
+  {
+    shape_type shape = shape_;
+    shape[N - 1] = end - begin;
+    return gt::adapt<N>(data_ + size_type(begin) * slice_size_, shape);
+  }
+
+  // hint that slab [begin, end) will be accessed soon
+  void will_need(int begin, int end) const
+  {
+    advise(begin, end, MADV_WILLNEED);
+  }
+
+  // hint that slab [begin, end) won't be accessed again
+  void dont_need(int begin, int end) const
+  {
+    advise(begin, end, MADV_DONTNEED);
+  }
+
+private:
+  void advise(int begin, int end, int advice) const
+  {
+    if (!map_ || begin >= end) {
+      return;
+    }
+    // round inwards for DONTNEED so neighboring slabs aren't affected,
+    // outwards otherwise
+    const std::uintptr_t page = ::sysconf(_SC_PAGESIZE);
+    auto lo = reinterpret_cast<std::uintptr_t>(data_ + begin * slice_size_);
+    auto hi = reinterpret_cast<std::uintptr_t>(data_ + end * slice_size_);
+    if (advice == MADV_DONTNEED) {
+      lo = (lo + page - 1) / page * page;
+      hi = hi / page * page;
+    } else {
+      lo = lo / page * page;
+    }
+    if (lo < hi) {
+      ::madvise(reinterpret_cast<void*>(lo), hi - lo, advice);
+    }
+  }
+
+  shape_type shape_;
+  size_type slice_size_;
+  void* map_ = nullptr;
+  size_type map_bytes_ = 0;
+  const T* data_ = nullptr;
+};
+
+namespace detail
+{
+
+// ======================================================================
+// write_pipeline
+//
+// A fixed set of host buffers that are filled by the caller and written out
+// by a background thread with positioned writes, so computing chunk i + 1
+// overlaps with writing chunk i. acquire() blocks until a buffer is free,
+// which bounds the memory in flight to n_buffers chunks. Write errors are
+// rethrown from acquire() or finish().
+
+template <typename T>
+class write_pipeline
+{
+public:
+  write_pipeline(int fd, size_type buffer_size, int n_buffers)
+    : fd_(fd), done_(false)
+  {
+    buffers_.reserve(n_buffers);
+    for (int i = 0; i < n_buffers; i++) {
+      buffers_.emplace_back(buffer_size);
+      free_.push_back(i);
+    }
+    writer_ = std::thread([this]() { run(); });
+  }
+
+  ~write_pipeline()
+  {
+    if (writer_.joinable()) {
+      stop();
+    }
+  }
+
+  // wait for a free buffer, returns its number
+  int acquire()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return !free_.empty() || error_; });
+    rethrow_locked();
+    int b = free_.front();
+    free_.pop_front();
+    return b;
+  }
+
+  T* data(int b) { return buffers_[b].data(); }
+
+  // queue the first n elements of buffer b to be written at offset
+  void submit(int b, size_type n, off_t offset)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back({b, n, offset});
+    cv_.notify_all();
+  }
+
+  // wait for all queued writes to complete
+  void finish()
+  {
+    stop();
+    std::lock_guard<std::mutex> lock(mutex_);
+    rethrow_locked();
+  }
+
+private:
+  struct job
+  {
+    int buffer;
+    size_type n;
+    off_t offset;
+  };
+
+  void run()
+  {
+    while (true) {
+      job j;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return !queue_.empty() || done_; });
+        if (queue_.empty()) {
+          return;
+        }
+        j = queue_.front();
+        queue_.pop_front();
+      }
+      try {
+        if (!error_) {
+          pwrite_all(fd_, buffers_[j.buffer].data(), j.n * sizeof(T),
+                     j.offset);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(j.buffer);
+      cv_.notify_all();
+    }
+  }
+
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+      cv_.notify_all();
+    }
+    writer_.join();
+  }
+
+  void rethrow_locked()
+  {
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  int fd_;
+  std::vector<std::vector<T>> buffers_;
+  std::deque<int> free_;
+  std::deque<job> queue_;
+  bool done_;
+  std::exception_ptr error_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread writer_;
+};
+
+} // namespace detail
+
+// ======================================================================
+// stream_eval
+//
+// Out-of-core evaluation of out = f(inputs...) for arrays that don't fit in
+// memory. The result of the given shape is computed in chunks of up to
+// `chunk` slices along the slowest dimension, and stored raw (like
+// gt::io::write) at `offset` in fd.
+//
+// For each chunk [begin, end), f is called with the matching slabs of the
+// mapped inputs (host spans, see mapped_file::slab) followed by begin and
+// end, and has to return an expression of the chunk's shape, built with the
+// usual gtensor expressions and views. The expression is assigned into one
+// of two chunk buffers, which are written by a background thread while the
+// next chunk is computed. Readahead is requested for the next chunk of each
+// input, and the pages of finished chunks are released, so that peak memory
+// is proportional to the chunk size rather than to the array size.
+
+template <typename T, size_type N, typename F, typename... Inputs>
+inline void stream_eval(int fd, const gt::shape_type<N>& shape, int chunk,
+                        F&& f, off_t offset, const Inputs&... inputs)
+{
+  if (chunk <= 0) {
+    throw std::runtime_error("gt::io::stream_eval: chunk must be positive");
+  }
+  const int n_slow = shape[N - 1];
+  for (int n : {n_slow, inputs.n_slabs()...}) {
+    if (n != n_slow) {
+      throw std::runtime_error(
+        "gt::io::stream_eval: inputs must match the slowest dimension");
+    }
+  }
+
+  gt::shape_type<N> chunk_shape = shape;
+  chunk_shape[N - 1] = std::min(chunk, n_slow);
+  const size_type slice = calc_size(shape) / std::max(n_slow, 1);
+
+  detail::write_pipeline<T> pipeline(fd, calc_size(chunk_shape), 2);
+  for (int begin = 0; begin < n_slow; begin += chunk) {
+    const int end = std::min(begin + chunk, n_slow);
+    const int next_end = std::min(end + chunk, n_slow);
+    (void)next_end;
+    (void)std::initializer_list<int>{
+      (inputs.will_need(end, next_end), 0)...};
+
+    gt::shape_type<N> cshape = shape;
+    cshape[N - 1] = end - begin;
+    int b = pipeline.acquire();
+    gt::adapt<N>(pipeline.data(b), cshape) =
+      f(inputs.slab(begin, end)..., begin, end);
+    pipeline.submit(b, calc_size(cshape),
+                    offset + size_type(begin) * slice * sizeof(T));
+
+    (void)std::initializer_list<int>{(inputs.dont_need(begin, end), 0)...};
+  }
+  pipeline.finish();
+}
+
+} // namespace io
+
+} // namespace gt
+
+#endif // GTENSOR_IO_STREAM_H
@@ -2,9 +2,13 @@
 #ifndef GTENSOR_ASSIGN_H
 #define GTENSOR_ASSIGN_H
 
+#include <algorithm>
+#include <limits>
 #include <type_traits>
+#include <utility>
 
 #include "defs.h"
+#include "gfunction.h"
 #include "space.h"
 
 namespace gt
@@ -39,101 +43,688 @@ struct assigner<1, space::host>
   }
 };
 
-template <>
-struct assigner<2, space::host>
+// ----------------------------------------------------------------------
+// host odometer
+//
+// Iteration over a shape of any rank on the host: one dimension is the inner
+// loop, the others are advanced like an odometer, one increment and compare
+// per row rather than a nested loop per dimension.
+//
+// for_each_row(shape, order, f) calls f(idx) once per row along dimension
+// order[0], with idx[order[0]] == 0, advancing order[1], order[2], ... in
+// turn. Without an order, rows are along the first dimension.
+//
+// for_each_strided_row(shape, strides, f) iterates K operands with the given
+// (element) strides at once, keeping one data offset per operand that is
+// updated with an add per dimension and row, instead of recomputing the
+// offset as the full dot product of index and strides. Dimensions are taken
+// in the memory order of the first operand, size one dimensions are dropped,
+// and dimensions that are contiguous with the previous one in all operands
+// are merged into it, so rows are as long as the layouts allow.
+// f(offsets, n, row_strides) is called once per row of n elements.
+//
+// memory_order(e) is the order of the dimensions of e from fastest to slowest
+// varying in memory, with size one dimensions last, or the index order for
+// expressions without strides. is_index_order(e) tells whether that is the
+// index order, as for column-major layouts, apart from size one dimensions.
+
+template <size_type N, typename F>
+inline void for_each_row(const gt::shape_type<N>& shape,
+                         const gt::shape_type<N>& order, F&& f)
 {
-  template <typename E1, typename E2>
-  static void run(E1& lhs, const E2& rhs, stream_view stream)
-  {
-    // printf("assigner<2, host>\n");
-    for (int j = 0; j < lhs.shape(1); j++) {
-      for (int i = 0; i < lhs.shape(0); i++) {
-        lhs(i, j) = rhs(i, j);
+  gt::shape_type<N> idx;
+  for (int d = 0; d < N; d++) {
+    if (shape[d] == 0) {
+      return;
+    }
+    idx[d] = 0;
+  }
+  while (true) {
+    f(idx);
+    int k = 1;
+    for (; k < N; k++) {
+      const int d = order[k];
+      if (++idx[d] < shape[d]) {
+        break;
+      }
+      idx[d] = 0;
+    }
+    if (k >= N) {
+      return;
+    }
+  }
+}
+
+template <size_type N, typename F>
+inline void for_each_row(const gt::shape_type<N>& shape, F&& f)
+{
+  gt::shape_type<N> order;
+  for (int d = 0; d < N; d++) {
+    order[d] = d;
+  }
+  for_each_row(shape, order, std::forward<F>(f));
+}
+
+template <size_type N, typename S>
+inline gt::shape_type<N> stride_order(const gt::shape_type<N>& shape,
+                                      const S& strides)
+{
+  auto key = [&](int d) {
+    return shape[d] == 1 ? std::numeric_limits<index_type>::max()
+                         : (strides[d] < 0 ? -strides[d] : strides[d]);
+  };
+  // insertion sort, stable so that equal strides stay in index order
+  gt::shape_type<N> order;
+  for (int d = 0; d < N; d++) {
+    int k = d;
+    for (; k > 0 && key(order[k - 1]) > key(d); k--) {
+      order[k] = order[k - 1];
+    }
+    order[k] = d;
+  }
+  return order;
+}
+
+template <typename E>
+inline auto memory_order(const E& e, std::true_type)
+{
+  return stride_order(e.shape(), e.strides());
+}
+
+template <typename E>
+inline auto memory_order(const E& e, std::false_type)
+{
+  gt::shape_type<expr_dimension<E>()> order;
+  for (int d = 0; d < expr_dimension<E>(); d++) {
+    order[d] = d;
+  }
+  return order;
+}
+
+template <typename E>
+inline auto memory_order(const E& e)
+{
+  return memory_order(
+    e, std::integral_constant<bool, has_strides_method_v<E>>{});
+}
+
+template <typename E>
+inline bool is_index_order(const E& e)
+{
+  auto order = memory_order(e);
+  int prev = -1;
+  for (int k = 0; k < expr_dimension<E>(); k++) {
+    if (e.shape(order[k]) == 1) {
+      continue;
+    }
+    if (order[k] < prev) {
+      return false;
+    }
+    prev = order[k];
+  }
+  return true;
+}
+
+// whether the elements of e fill a dense block of memory, in any order
+template <typename E>
+inline bool is_dense(const E& e)
+{
+  auto order = stride_order(e.shape(), e.strides());
+  index_type stride = 1;
+  for (int k = 0; k < expr_dimension<E>(); k++) {
+    const int d = order[k];
+    if (e.shape(d) != 1 && e.strides()[d] != stride) {
+      return false;
+    }
+    stride *= e.shape(d);
+  }
+  return true;
+}
+
+template <size_type N, size_type K, typename F>
+inline void for_each_strided_row(const gt::shape_type<N>& shape,
+                                 const sarray<strides_type<N>, K>& strides,
+                                 F&& f)
+{
+  auto order = stride_order(shape, strides[0]);
+  sarray<index_type, N> n;
+  sarray<strides_type<N>, K> s;
+  int rank = 0;
+  for (int j = 0; j < N; j++) {
+    const int d = order[j];
+    if (shape[d] == 0) {
+      return;
+    } else if (shape[d] == 1) {
+      continue;
+    }
+    bool merge = rank > 0;
+    for (int k = 0; k < K && merge; k++) {
+      merge = strides[k][d] == s[k][rank - 1] * n[rank - 1];
+    }
+    if (merge) {
+      n[rank - 1] *= shape[d];
+    } else {
+      n[rank] = shape[d];
+      for (int k = 0; k < K; k++) {
+        s[k][rank] = strides[k][d];
+      }
+      rank++;
+    }
+  }
+
+  sarray<index_type, K> offsets;
+  sarray<index_type, K> row_strides;
+  for (int k = 0; k < K; k++) {
+    offsets[k] = 0;
+    row_strides[k] = rank > 0 ? s[k][0] : 0;
+  }
+  if (rank == 0) {
+    f(offsets, index_type(1), row_strides);
+    return;
+  }
+
+  sarray<index_type, N> idx;
+  for (int d = 0; d < rank; d++) {
+    idx[d] = 0;
+  }
+  while (true) {
+    f(offsets, n[0], row_strides);
+    int d = 1;
+    for (; d < rank; d++) {
+      for (int k = 0; k < K; k++) {
+        offsets[k] += s[k][d];
       }
+      if (++idx[d] < n[d]) {
+        break;
+      }
+      for (int k = 0; k < K; k++) {
+        offsets[k] -= s[k][d] * n[d];
+      }
+      idx[d] = 0;
+    }
+    if (d >= rank) {
+      return;
     }
   }
+}
+
+// whether all elements of an expression are at &e.data_access(0) + index *
+// strides, i.e., containers, spans and (possibly nested) views of those.
+// Specialized in gview.h.
+template <typename E, typename Enable = void>
+struct is_data_strided : std::false_type
+{};
+
+// what the odometer below takes as data strided: is_data_strided, plus
+// expressions that are data strided or not depending on run time state, for
+// which check(e) has to be true as well, e.g. reshaped views (see
+// reshape_adaptor in gview.h). Specialized in gview.h.
+template <typename E, typename Enable = void>
+struct maybe_data_strided
+{
+  static constexpr bool value = is_data_strided<E>::value;
+
+  static bool check(const E&) { return true; }
 };
 
-template <>
-struct assigner<3, space::host>
+// ----------------------------------------------------------------------
+// row_binder
+//
+// In the odometer's indexed path, every element costs an N-d index
+// calculation per operand of the rhs. When the rhs is a tree of gfunctions
+// whose leaves are scalars and data strided expressions of the full rank,
+// row_binder<E, N>::bind(e, inner) turns it into a row evaluator instead:
+// each leaf keeps its data pointer and its strides, with the strides of size
+// one (broadcast) dimensions zeroed. seek(idx) moves every leaf to the start
+// of a row along dimension inner with one dot product, and r(i) then reads
+// element i of the row with one load per leaf. Leaves that are broadcast
+// along the row have row stride 0, i.e., their load doesn't depend on i and
+// hits the same L1 line throughout the row. When all leaves have row stride 1
+// (or are scalars), unit(i) reads p[i] instead, which the compiler can
+// vectorize. check(e) is false if a leaf turns out not to be data strided
+// after all, see maybe_data_strided.
+
+template <typename E, size_type N, typename Enable>
+struct row_binder
 {
-  template <typename E1, typename E2>
-  static void run(E1& lhs, const E2& rhs, stream_view stream)
+  static constexpr bool value = false;
+};
+
+template <typename T>
+struct row_scalar
+{
+  template <size_type N>
+  GT_INLINE void seek(const gt::shape_type<N>&)
+  {}
+  GT_INLINE bool unit_stride() const { return true; }
+  GT_INLINE T operator()(index_type) const { return value; }
+  GT_INLINE T unit(index_type) const { return value; }
+
+  T value;
+};
+
+template <typename P, size_type N>
+struct row_strided
+{
+  GT_INLINE void seek(const gt::shape_type<N>& idx)
   {
-    // printf("assigner<3, host>\n");
-    for (int k = 0; k < lhs.shape(2); k++) {
-      for (int j = 0; j < lhs.shape(1); j++) {
-        for (int i = 0; i < lhs.shape(0); i++) {
-          lhs(i, j, k) = rhs(i, j, k);
-        }
+    index_type off = 0;
+    for (int d = 0; d < N; d++) {
+      off += idx[d] * strides[d];
+    }
+    p = base + off;
+  }
+  GT_INLINE bool unit_stride() const { return s == 1; }
+  GT_INLINE decltype(auto) operator()(index_type i) const { return p[i * s]; }
+  GT_INLINE decltype(auto) unit(index_type i) const { return p[i]; }
+
+  P base;
+  strides_type<N> strides;
+  index_type s;
+  P p;
+};
+
+template <typename F, typename R>
+struct row_unary
+{
+  template <size_type N>
+  GT_INLINE void seek(const gt::shape_type<N>& idx)
+  {
+    r.seek(idx);
+  }
+  GT_INLINE bool unit_stride() const { return r.unit_stride(); }
+  GT_INLINE auto operator()(index_type i) const { return f(r(i)); }
+  GT_INLINE auto unit(index_type i) const { return f(r.unit(i)); }
+
+  F f;
+  R r;
+};
+
+template <typename F, typename R1, typename R2>
+struct row_binary
+{
+  template <size_type N>
+  GT_INLINE void seek(const gt::shape_type<N>& idx)
+  {
+    r1.seek(idx);
+    r2.seek(idx);
+  }
+  GT_INLINE bool unit_stride() const
+  {
+    return r1.unit_stride() && r2.unit_stride();
+  }
+  GT_INLINE auto operator()(index_type i) const { return f(r1(i), r2(i)); }
+  GT_INLINE auto unit(index_type i) const { return f(r1.unit(i), r2.unit(i)); }
+
+  F f;
+  R1 r1;
+  R2 r2;
+};
+
+template <typename T, size_type N>
+struct row_binder<gscalar<T>, N>
+{
+  static constexpr bool value = true;
+
+  static bool check(const gscalar<T>&) { return true; }
+
+  static auto bind(const gscalar<T>& e, int inner)
+  {
+    return row_scalar<std::decay_t<T>>{e()};
+  }
+};
+
+template <typename E, size_type N>
+struct row_binder<E, N, std::enable_if_t<maybe_data_strided<E>::value>>
+{
+  static constexpr bool value = expr_dimension<E>() == N;
+
+  static bool check(const E& e) { return maybe_data_strided<E>::check(e); }
+
+  static auto bind(const E& e, int inner)
+  {
+    using pointer = decltype(&e.data_access(0));
+    auto shape = e.shape();
+    auto strides = e.strides();
+    for (int d = 0; d < N; d++) {
+      if (shape[d] == 1) {
+        strides[d] = 0;
       }
     }
+    pointer base = &e.data_access(0);
+    return row_strided<pointer, N>{base, strides, strides[inner], base};
   }
 };
 
-template <>
-struct assigner<4, space::host>
+template <typename F, typename E, size_type N>
+struct row_binder<gfunction<F, E, gt_empty_expr>, N>
+{
+  using inner_binder = row_binder<std::decay_t<E>, N>;
+
+  static constexpr bool value = inner_binder::value;
+
+  static bool check(const gfunction<F, E, gt_empty_expr>& e)
+  {
+    return inner_binder::check(e.e_);
+  }
+
+  static auto bind(const gfunction<F, E, gt_empty_expr>& e, int inner)
+  {
+    auto r = inner_binder::bind(e.e_, inner);
+    return row_unary<std::decay_t<F>, decltype(r)>{e.f_, r};
+  }
+};
+
+template <typename F, typename E1, typename E2, size_type N>
+struct row_binder<gfunction<F, E1, E2>, N>
+{
+  using binder1 = row_binder<std::decay_t<E1>, N>;
+  using binder2 = row_binder<std::decay_t<E2>, N>;
+
+  static constexpr bool value = binder1::value && binder2::value;
+
+  static bool check(const gfunction<F, E1, E2>& e)
+  {
+    return binder1::check(e.e1_) && binder2::check(e.e2_);
+  }
+
+  static auto bind(const gfunction<F, E1, E2>& e, int inner)
+  {
+    auto r1 = binder1::bind(e.e1_, inner);
+    auto r2 = binder2::bind(e.e2_, inner);
+    return row_binary<std::decay_t<F>, decltype(r1), decltype(r2)>{e.f_, r1,
+                                                                   r2};
+  }
+};
+
+// ----------------------------------------------------------------------
+// assign_transposed
+//
+// When the fastest varying dimensions d0 of lhs and d1 of rhs differ, e.g.,
+// for a transposed rhs, rows along d0 read one element per cache line of rhs,
+// and one page per element once rhs rows are a page or more apart, so long
+// rows run out of TLB entries. assign_transposed goes through the d0 x d1
+// planes in blocks instead, transpose_block_rows along d0 by transpose_block
+// along d1, which touch few enough lines and pages of rhs that each is fully
+// used while it's cached, while lhs is still written in unit stride runs of
+// transpose_block_rows.
+//
+// Planes up to transpose_blocked_bytes (lhs and rhs together), which fit in
+// L2 on current CPUs, keep the row loops, which are as fast there. For rhs row
+// strides that are multiples of the page size, all lines of a block map to
+// the same few cache sets, so the blocks are square, and they're used for any
+// plane size, since the rows hit the same conflicts.
+
+constexpr int transpose_block = 32;
+constexpr int transpose_block_rows = 128;
+constexpr size_type transpose_blocked_bytes = size_type(1) << 20;
+constexpr size_type transpose_page_bytes = 4096;
+
+template <size_type N, typename L, typename R>
+inline void assign_transposed(const gt::shape_type<N>& shape, L* l,
+                              const strides_type<N>& ls, R* r,
+                              const strides_type<N>& rs, int d0, int d1,
+                              int block0)
+{
+  // one call per point of the other dimensions
+  gt::shape_type<N> outer = shape;
+  gt::shape_type<N> order;
+  outer[d0] = 1;
+  outer[d1] = 1;
+  order[0] = d0;
+  for (int d = 0, k = 1; d < N; d++) {
+    if (d != d0) {
+      order[k++] = d;
+    }
+  }
+
+  const int n0 = shape[d0];
+  const int n1 = shape[d1];
+  const index_type l0 = ls[d0], l1 = ls[d1];
+  const index_type r0 = rs[d0], r1 = rs[d1];
+  for_each_row(outer, order, [&](const gt::shape_type<N>& idx) {
+    index_type lo = 0, ro = 0;
+    for (int d = 0; d < N; d++) {
+      lo += idx[d] * ls[d];
+      ro += idx[d] * rs[d];
+    }
+    for (int jb = 0; jb < n1; jb += transpose_block) {
+      const int je = std::min(jb + transpose_block, n1);
+      for (int ib = 0; ib < n0; ib += block0) {
+        const int ie = std::min(ib + block0, n0);
+        for (int j = jb; j < je; j++) {
+          auto* lp = l + lo + j * l1;
+          auto* rp = r + ro + j * r1;
+          if (l0 == 1) {
+            for (int i = ib; i < ie; i++) {
+              lp[i] = rp[i * r0];
+            }
+          } else {
+            for (int i = ib; i < ie; i++) {
+              lp[i * l0] = rp[i * r0];
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+template <size_type N>
+struct odometer_assigner
 {
   template <typename E1, typename E2>
-  static void run(E1& lhs, const E2& rhs, stream_view stream)
+  static void run(E1& lhs, const E2& rhs)
   {
-    // printf("assigner<4, host>\n");
-    for (int l = 0; l < lhs.shape(3); l++) {
-      for (int k = 0; k < lhs.shape(2); k++) {
-        for (int j = 0; j < lhs.shape(1); j++) {
-          for (int i = 0; i < lhs.shape(0); i++) {
-            lhs(i, j, k, l) = rhs(i, j, k, l);
+    using data_strided = std::integral_constant<
+      bool, maybe_data_strided<std::decay_t<E1>>::value &&
+              maybe_data_strided<std::decay_t<E2>>::value>;
+    run(lhs, rhs, data_strided{});
+  }
+
+private:
+  template <typename E1, typename E2>
+  static void run(E1& lhs, const E2& rhs, std::true_type)
+  {
+    if (lhs.size() == 0) {
+      return;
+    }
+    if (!maybe_data_strided<std::decay_t<E1>>::check(lhs) ||
+        !maybe_data_strided<std::decay_t<E2>>::check(rhs)) {
+      run(lhs, rhs, std::false_type{});
+      return;
+    }
+    auto rhs_shape = rhs.shape();
+    auto rhs_strides = rhs.strides();
+    for (int d = 0; d < N; d++) {
+      if (rhs_shape[d] == 1) {
+        rhs_strides[d] = 0;
+      }
+    }
+    auto* l = &lhs.data_access(0);
+    auto* r = &rhs.data_access(0);
+    const auto shape = lhs.shape();
+    const int d0 = stride_order(shape, lhs.strides())[0];
+    const int d1 = stride_order(rhs_shape, rhs_strides)[0];
+    auto mag = [](index_type s) { return s < 0 ? -s : s; };
+    if (d0 != d1 && shape[d0] > 1 && shape[d1] > 1 &&
+        mag(rhs_strides[d1]) < mag(rhs_strides[d0])) {
+      const size_type plane_bytes =
+        size_type(shape[d0]) * shape[d1] * (sizeof(*l) + sizeof(*r));
+      const size_type row_stride_bytes = mag(rhs_strides[d0]) * sizeof(*r);
+      const bool page_aliased = row_stride_bytes % transpose_page_bytes == 0;
+      if (plane_bytes > transpose_blocked_bytes || page_aliased) {
+        assign_transposed(shape, l, lhs.strides(), r, rhs_strides, d0, d1,
+                          page_aliased ? transpose_block
+                                       : transpose_block_rows);
+        return;
+      }
+    }
+    for_each_strided_row(
+      lhs.shape(), sarray<strides_type<N>, 2>(lhs.strides(), rhs_strides),
+      [&](const sarray<index_type, 2>& off, index_type n,
+          const sarray<index_type, 2>& s) {
+        auto* lp = l + off[0];
+        auto* rp = r + off[1];
+        if (s[0] == 1 && s[1] == 1) {
+          for (index_type i = 0; i < n; i++) {
+            lp[i] = rp[i];
+          }
+        } else if (s[0] == 1 && s[1] == 0) {
+          for (index_type i = 0; i < n; i++) {
+            lp[i] = *rp;
+          }
+        } else {
+          for (index_type i = 0; i < n; i++) {
+            lp[i * s[0]] = rp[i * s[1]];
           }
         }
+      });
+  }
+
+  template <typename E1, typename E2>
+  static void run(E1& lhs, const E2& rhs, std::false_type)
+  {
+    using by_rows = std::integral_constant<
+      bool, maybe_data_strided<std::decay_t<E1>>::value &&
+              row_binder<std::decay_t<E2>, N>::value>;
+    run_indexed(lhs, rhs, by_rows{});
+  }
+
+  template <typename E1, typename E2>
+  static void run_indexed(E1& lhs, const E2& rhs, std::true_type)
+  {
+    if (!maybe_data_strided<std::decay_t<E1>>::check(lhs) ||
+        !row_binder<std::decay_t<E2>, N>::check(rhs)) {
+      run_indexed(lhs, rhs, std::false_type{});
+      return;
+    }
+    const auto shape = lhs.shape();
+    const auto ls = lhs.strides();
+    const int inner = memory_order(lhs)[0];
+    const int n = shape[inner];
+    const index_type l_inner = ls[inner];
+    auto* l = &lhs.data_access(0);
+    auto row = row_binder<std::decay_t<E2>, N>::bind(rhs, inner);
+    const bool unit = l_inner == 1 && row.unit_stride();
+    for_each_row(shape, memory_order(lhs), [&](const gt::shape_type<N>& idx) {
+      index_type off = 0;
+      for (int d = 0; d < N; d++) {
+        off += idx[d] * ls[d];
+      }
+      row.seek(idx);
+      auto* lp = l + off;
+      if (unit) {
+        for (int i = 0; i < n; i++) {
+          lp[i] = row.unit(i);
+        }
+      } else {
+        for (int i = 0; i < n; i++) {
+          lp[i * l_inner] = row(i);
+        }
       }
+    });
+  }
+
+  template <typename E1, typename E2>
+  static void run_indexed(E1& lhs, const E2& rhs, std::false_type)
+  {
+    auto shape = lhs.shape();
+    auto order = memory_order(lhs);
+    const int inner = order[0];
+    if (inner == 0) {
+      for_each_row(shape, order, [&](gt::shape_type<N>& idx) {
+        for (int i = 0; i < shape[0]; i++) {
+          idx[0] = i;
+          index_expression(lhs, idx) = index_expression(rhs, idx);
+        }
+      });
+    } else {
+      for_each_row(shape, order, [&](gt::shape_type<N>& idx) {
+        for (int i = 0; i < shape[inner]; i++) {
+          idx[inner] = i;
+          index_expression(lhs, idx) = index_expression(rhs, idx);
+        }
+      });
     }
   }
 };
 
+// whether a strided rhs isn't stored in index order, e.g., transposed
+template <typename E>
+inline bool is_transposed(const E& e, std::true_type)
+{
+  return !is_index_order(e);
+}
+
+template <typename E>
+inline bool is_transposed(const E& e, std::false_type)
+{
+  return false;
+}
+
+template <typename E>
+inline bool is_transposed(const E& e)
+{
+  using data_strided =
+    std::integral_constant<bool, maybe_data_strided<std::decay_t<E>>::value>;
+  return is_transposed(e, data_strided{});
+}
+
+// ranks 2 and 3 keep plain nested loops when lhs and a strided rhs are stored
+// in index order, the odometer takes everything else, including a size one
+// first dimension, where it runs the rows along one that varies instead
 template <>
-struct assigner<5, space::host>
+struct assigner<2, space::host>
 {
   template <typename E1, typename E2>
   static void run(E1& lhs, const E2& rhs, stream_view stream)
   {
-    // printf("assigner<5, host>\n");
-    for (int m = 0; m < lhs.shape(4); m++) {
-      for (int l = 0; l < lhs.shape(3); l++) {
-        for (int k = 0; k < lhs.shape(2); k++) {
-          for (int j = 0; j < lhs.shape(1); j++) {
-            for (int i = 0; i < lhs.shape(0); i++) {
-              lhs(i, j, k, l, m) = rhs(i, j, k, l, m);
-            }
-          }
-        }
+    // printf("assigner<2, host>\n");
+    if (!is_index_order(lhs) || is_transposed(rhs) || lhs.shape(0) == 1) {
+      odometer_assigner<2>::run(lhs, rhs);
+      return;
+    }
+    for (int j = 0; j < lhs.shape(1); j++) {
+      for (int i = 0; i < lhs.shape(0); i++) {
+        lhs(i, j) = rhs(i, j);
       }
     }
   }
 };
 
 template <>
-struct assigner<6, space::host>
+struct assigner<3, space::host>
 {
   template <typename E1, typename E2>
   static void run(E1& lhs, const E2& rhs, stream_view stream)
   {
-    // printf("assigner<6, host>\n");
-    for (int n = 0; n < lhs.shape(5); n++) {
-      for (int m = 0; m < lhs.shape(4); m++) {
-        for (int l = 0; l < lhs.shape(3); l++) {
-          for (int k = 0; k < lhs.shape(2); k++) {
-            for (int j = 0; j < lhs.shape(1); j++) {
-              for (int i = 0; i < lhs.shape(0); i++) {
-                lhs(i, j, k, l, m, n) = rhs(i, j, k, l, m, n);
-              }
-            }
-          }
+    // printf("assigner<3, host>\n");
+    if (!is_index_order(lhs) || is_transposed(rhs) || lhs.shape(0) == 1) {
+      odometer_assigner<3>::run(lhs, rhs);
+      return;
+    }
+    for (int k = 0; k < lhs.shape(2); k++) {
+      for (int j = 0; j < lhs.shape(1); j++) {
+        for (int i = 0; i < lhs.shape(0); i++) {
+          lhs(i, j, k) = rhs(i, j, k);
         }
       }
     }
   }
 };
 
+// ranks 4 and up, where the odometer beats nested loops
+template <size_type N>
+struct assigner<N, space::host>
+{
+  template <typename E1, typename E2>
+  static void run(E1& lhs, const E2& rhs, stream_view stream)
+  {
+    odometer_assigner<N>::run(lhs, rhs);
+  }
+};
+
 #if defined(GTENSOR_DEVICE_CUDA) || defined(GTENSOR_DEVICE_HIP)
 
 #ifdef GTENSOR_PER_DIM_KERNELS
@@ -343,12 +934,11 @@ struct assigner<6, space::device>
 
 #else // not defined GTENSOR_PER_DIM_KERNELS
 
-template <typename Elhs, typename Erhs, size_type N>
-__global__ void kernel_assign_N(Elhs lhs, Erhs rhs, size_type size,
-                                gt::shape_type<N> strides)
+template <typename Elhs, typename Erhs, typename I, typename S>
+__global__ void kernel_assign_N(Elhs lhs, Erhs rhs, I size, S strides)
 {
   // workaround ROCm 5.2.0 compiler bug
-  size_type i = threadIdx.x + static_cast<size_type>(blockIdx.x) * blockDim.x;
+  I i = threadIdx.x + static_cast<I>(blockIdx.x) * blockDim.x;
 
   if (i < size) {
     auto idx = unravel(i, strides);
@@ -363,7 +953,6 @@ struct assigner<N, space::device>
   static void run(E1& lhs, const E2& rhs, stream_view stream)
   {
     auto size = calc_size(lhs.shape());
-    auto strides = calc_strides(lhs.shape());
     unsigned int block_size = BS_LINEAR;
     if (block_size > size) {
       block_size = static_cast<unsigned int>(size);
@@ -373,9 +962,17 @@ struct assigner<N, space::device>
     dim3 numBlocks(gt::div_ceil(size, block_size));
 
     gpuSyncIfEnabledStream(stream);
-    gtLaunchKernel(kernel_assign_N, numBlocks, numThreads, 0,
-                   stream.get_backend_stream(), lhs.to_kernel(),
-                   rhs.to_kernel(), size, strides);
+    if (index_fits_32(size)) {
+      auto strides = calc_fast_strides(lhs.shape());
+      gtLaunchKernel(kernel_assign_N, numBlocks, numThreads, 0,
+                     stream.get_backend_stream(), lhs.to_kernel(),
+                     rhs.to_kernel(), static_cast<int>(size), strides);
+    } else {
+      auto strides = calc_strides<size_type>(lhs.shape());
+      gtLaunchKernel(kernel_assign_N, numBlocks, numThreads, 0,
+                     stream.get_backend_stream(), lhs.to_kernel(),
+                     rhs.to_kernel(), size, strides);
+    }
     gpuSyncIfEnabledStream(stream);
   }
 };
@@ -477,10 +1074,24 @@ struct assigner<N, space::device>
   {
     gpuSyncIfEnabledStream(stream);
 
-    sycl::queue& q = stream.get_backend_stream();
     // use linear indexing for simplicity
+    if (index_fits_32(calc_size(lhs.shape()))) {
+      submit<int>(lhs, rhs, calc_fast_strides(lhs.shape()), stream);
+    } else {
+      submit<size_type>(lhs, rhs, calc_strides<size_type>(lhs.shape()),
+                        stream);
+    }
+
+    gpuSyncIfEnabledStream(stream);
+  }
+
+private:
+  template <typename I, typename E1, typename E2, typename S>
+  static void submit(E1& lhs, const E2& rhs, const S& strides,
+                     gt::stream_view stream)
+  {
+    sycl::queue& q = stream.get_backend_stream();
     auto size = calc_size(lhs.shape());
-    auto strides = calc_strides(lhs.shape());
     auto k_lhs = lhs.to_kernel();
     auto k_rhs = rhs.to_kernel();
     using ltype = decltype(k_lhs);
@@ -493,23 +1104,21 @@ struct assigner<N, space::device>
       q.copy(&k_rhs, d_rhs_p, 1).wait();
 
       auto e = q.submit([&](sycl::handler& cgh) {
-        using kname = gt::backend::sycl::AssignN<E1, E2, ltype, rtype>;
+        using kname = gt::backend::sycl::AssignN<E1, E2, ltype, rtype, I>;
         cgh.parallel_for<kname>(sycl::range<1>(size), [=](sycl::id<1> i) {
-          auto idx = unravel(i, strides);
+          auto idx = unravel(static_cast<I>(i[0]), strides);
           index_expression(k_lhs, idx) = index_expression(*d_rhs_p, idx);
         });
       });
     } else {
       auto e = q.submit([&](sycl::handler& cgh) {
-        using kname = gt::backend::sycl::AssignN<E1, E2, ltype, rtype>;
+        using kname = gt::backend::sycl::AssignN<E1, E2, ltype, rtype, I>;
         cgh.parallel_for<kname>(sycl::range<1>(size), [=](sycl::id<1> i) {
-          auto idx = unravel(i, strides);
+          auto idx = unravel(static_cast<I>(i[0]), strides);
           index_expression(k_lhs, idx) = index_expression(k_rhs, idx);
         });
       });
     }
-
-    gpuSyncIfEnabledStream(stream);
   }
 };
 
@@ -551,6 +1160,20 @@ void assign(E1& lhs, const gscalar<T>& val,
                                                                     stream);
 }
 
+// ======================================================================
+// masked_assign
+//
+// lhs = rhs where mask is true, lhs unchanged elsewhere, in a single pass.
+// Every element of lhs is written, which keeps the loop branch-free; mask and
+// rhs can be expressions or scalars that broadcast to the shape of lhs.
+
+template <typename E1, typename EM, typename E2>
+void masked_assign(E1&& lhs, const EM& mask, const E2& rhs,
+                   gt::stream_view stream = gt::stream_view())
+{
+  assign(lhs, where(mask, rhs, lhs), stream);
+}
+
 } // namespace gt
 
 #endif
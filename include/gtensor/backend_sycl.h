@@ -30,7 +30,7 @@ template <typename E1, typename E2, typename K1, typename K2>
 class Assign2;
 template <typename E1, typename E2, typename K1, typename K2>
 class Assign3;
-template <typename E1, typename E2, typename K1, typename K2>
+template <typename E1, typename E2, typename K1, typename K2, typename I>
 class AssignN;
 
 template <typename F>
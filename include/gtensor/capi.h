@@ -52,6 +52,73 @@ gt_backend_is_device_address(void* p);
 void gt_backend_prefetch_device(void* p, size_t nbytes);
 void gt_backend_prefetch_host(void* p, size_t nbytes);
 
+/**
+ * Fused operations on existing device (or managed) buffers of n contiguous
+ * elements, in the four BLAS precisions (s, d, c, z). They run on the given
+ * stream, which is NULL for the default stream, and otherwise a
+ * cudaStream_t / hipStream_t, or a pointer to a sycl::queue.
+ *
+ * Reductions (sum, nrm2, maxabs, dot) write their result to a host scalar
+ * and wait for the stream; dot conjugates x for complex types. The others
+ * are asynchronous: axpby computes y = a * x + b * y, scal_copy y = a * x
+ * (in place if x == y).
+ *
+ * Complex values have the layout of C99 / Fortran interoperable complex.
+ */
+
+typedef struct
+{
+  float re, im;
+} gt_complex_float;
+
+typedef struct
+{
+  double re, im;
+} gt_complex_double;
+
+void gt_ssum(int n, const float* x, float* result, void* stream);
+void gt_dsum(int n, const double* x, double* result, void* stream);
+void gt_csum(int n, const gt_complex_float* x, gt_complex_float* result,
+             void* stream);
+void gt_zsum(int n, const gt_complex_double* x, gt_complex_double* result,
+             void* stream);
+
+void gt_snrm2(int n, const float* x, float* result, void* stream);
+void gt_dnrm2(int n, const double* x, double* result, void* stream);
+void gt_cnrm2(int n, const gt_complex_float* x, float* result, void* stream);
+void gt_znrm2(int n, const gt_complex_double* x, double* result, void* stream);
+
+void gt_smaxabs(int n, const float* x, float* result, void* stream);
+void gt_dmaxabs(int n, const double* x, double* result, void* stream);
+void gt_cmaxabs(int n, const gt_complex_float* x, float* result, void* stream);
+void gt_zmaxabs(int n, const gt_complex_double* x, double* result,
+                void* stream);
+
+void gt_sdot(int n, const float* x, const float* y, float* result,
+             void* stream);
+void gt_ddot(int n, const double* x, const double* y, double* result,
+             void* stream);
+void gt_cdot(int n, const gt_complex_float* x, const gt_complex_float* y,
+             gt_complex_float* result, void* stream);
+void gt_zdot(int n, const gt_complex_double* x, const gt_complex_double* y,
+             gt_complex_double* result, void* stream);
+
+void gt_saxpby(int n, float a, const float* x, float b, float* y,
+               void* stream);
+void gt_daxpby(int n, double a, const double* x, double b, double* y,
+               void* stream);
+void gt_caxpby(int n, gt_complex_float a, const gt_complex_float* x,
+               gt_complex_float b, gt_complex_float* y, void* stream);
+void gt_zaxpby(int n, gt_complex_double a, const gt_complex_double* x,
+               gt_complex_double b, gt_complex_double* y, void* stream);
+
+void gt_sscal_copy(int n, float a, const float* x, float* y, void* stream);
+void gt_dscal_copy(int n, double a, const double* x, double* y, void* stream);
+void gt_cscal_copy(int n, gt_complex_float a, const gt_complex_float* x,
+                   gt_complex_float* y, void* stream);
+void gt_zscal_copy(int n, gt_complex_double a, const gt_complex_double* x,
+                   gt_complex_double* y, void* stream);
+
 #ifdef __cplusplus
 }
 #endif
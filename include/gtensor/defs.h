@@ -3,6 +3,7 @@
 #define GTENSOR_DEFS_H
 
 #include <cstddef>
+#include <cstdint>
 
 // This really should be defined by the build system, but it'll cause
 // compatibility issues with plain old make, so let's be cautious.
@@ -25,6 +26,23 @@ class sarray;
 template <size_type N>
 using shape_type = sarray<int, N>;
 
+// index policy
+//
+// Extents are always int, but strides and linear offsets of arrays with
+// more than 2^31 - 1 elements don't fit into an int. GTENSOR_INDEX64 makes
+// them 64 bit, at the cost of 64-bit index arithmetic in every access.
+// Either way, launches and assigns that unravel a linear index pick 32-bit
+// indexing at runtime whenever the total size allows it.
+
+#ifdef GTENSOR_INDEX64
+using index_type = std::int64_t;
+#else
+using index_type = int;
+#endif
+
+template <size_type N>
+using strides_type = sarray<index_type, N>;
+
 template <typename T1, typename T2>
 auto div_ceil(const T1 n, const T2 d)
 {
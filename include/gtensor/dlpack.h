@@ -0,0 +1,399 @@
+#ifndef GTENSOR_DLPACK_H
+#define GTENSOR_DLPACK_H
+
+#include "gtensor.h"
+
+#include "dlpack/dlpack.h"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace gt
+{
+
+// ======================================================================
+// DLPack interoperability
+//
+// to_dlpack() exports a container or span as a DLManagedTensor, sharing the
+// data. Shape and strides are passed through in gtensor's index order, i.e.
+// a column-major container shows up with unit stride in its first
+// dimension. Exporting an rvalue container moves it into the managed
+// tensor, which then owns the data until its deleter is called. Exporting a
+// span (or an lvalue container) only borrows the data, which has to outlive
+// the managed tensor.
+//
+// from_dlpack<T, N, S>() imports a DLTensor as a gtensor_span, again without
+// copying. dlpack_tensor<T, N, S> additionally takes ownership of a
+// DLManagedTensor and calls its deleter when it goes out of scope.
+
+namespace detail
+{
+
+// ----------------------------------------------------------------------
+// dlpack_dtype
+
+template <typename T, typename Enable = void>
+struct dlpack_dtype;
+
+template <typename T>
+struct dlpack_dtype<T, std::enable_if_t<std::is_integral<T>::value &&
+                                         !std::is_same<T, bool>::value>>
+{
+  static DLDataType get()
+  {
+    return {static_cast<std::uint8_t>(std::is_signed<T>::value ? kDLInt
+                                                                : kDLUInt),
+            static_cast<std::uint8_t>(8 * sizeof(T)), 1};
+  }
+};
+
+template <>
+struct dlpack_dtype<bool>
+{
+  static DLDataType get() { return {kDLBool, 8, 1}; }
+};
+
+template <typename T>
+struct dlpack_dtype<T, std::enable_if_t<std::is_floating_point<T>::value>>
+{
+  static DLDataType get()
+  {
+    return {kDLFloat, static_cast<std::uint8_t>(8 * sizeof(T)), 1};
+  }
+};
+
+template <typename R>
+struct dlpack_dtype<gt::complex<R>>
+{
+  static DLDataType get()
+  {
+    return {kDLComplex, static_cast<std::uint8_t>(16 * sizeof(R)), 1};
+  }
+};
+
+#if defined(GTENSOR_ENABLE_FP16)
+
+template <>
+struct dlpack_dtype<gt::float16_t>
+{
+  static DLDataType get() { return {kDLFloat, 16, 1}; }
+};
+
+template <>
+struct dlpack_dtype<gt::complex_float16_t>
+{
+  static DLDataType get() { return {kDLComplex, 32, 1}; }
+};
+
+#endif
+
+// ----------------------------------------------------------------------
+// dlpack_device
+//
+// DLPack device type for memory in space S, and which DLPack device types
+// can be imported into S
+
+template <typename S>
+struct dlpack_device;
+
+template <>
+struct dlpack_device<gt::space::host_only>
+{
+  static DLDevice get() { return {kDLCPU, 0}; }
+  static bool accepts(DLDeviceType t)
+  {
+    return t == kDLCPU || t == kDLCUDAHost || t == kDLROCMHost ||
+           t == kDLCUDAManaged;
+  }
+};
+
+template <typename S, DLDeviceType Type>
+struct dlpack_device_gpu
+{
+  static DLDevice get()
+  {
+    return {Type, gt::backend::clib::device_get()};
+  }
+  static bool accepts(DLDeviceType t)
+  {
+    return t == Type || (Type == kDLCUDA && t == kDLCUDAManaged);
+  }
+};
+
+#ifdef GTENSOR_DEVICE_CUDA
+template <>
+struct dlpack_device<gt::space::cuda>
+  : dlpack_device_gpu<gt::space::cuda, kDLCUDA>
+{};
+template <>
+struct dlpack_device<gt::space::cuda_managed>
+  : dlpack_device_gpu<gt::space::cuda_managed, kDLCUDAManaged>
+{};
+template <>
+struct dlpack_device<gt::space::cuda_host>
+  : dlpack_device<gt::space::host_only>
+{};
+#endif
+
+#ifdef GTENSOR_DEVICE_HIP
+template <>
+struct dlpack_device<gt::space::hip>
+  : dlpack_device_gpu<gt::space::hip, kDLROCM>
+{};
+template <>
+struct dlpack_device<gt::space::hip_managed>
+  : dlpack_device_gpu<gt::space::hip_managed, kDLROCM>
+{};
+template <>
+struct dlpack_device<gt::space::hip_host>
+  : dlpack_device<gt::space::host_only>
+{};
+#endif
+
+#ifdef GTENSOR_DEVICE_SYCL
+template <>
+struct dlpack_device<gt::space::sycl>
+  : dlpack_device_gpu<gt::space::sycl, kDLOneAPI>
+{};
+template <>
+struct dlpack_device<gt::space::sycl_managed>
+  : dlpack_device_gpu<gt::space::sycl_managed, kDLOneAPI>
+{};
+template <>
+struct dlpack_device<gt::space::sycl_host>
+  : dlpack_device<gt::space::host_only>
+{};
+#endif
+
+#ifdef GTENSOR_HAVE_THRUST
+#if defined(GTENSOR_DEVICE_CUDA)
+template <>
+struct dlpack_device<gt::space::thrust>
+  : dlpack_device_gpu<gt::space::thrust, kDLCUDA>
+{};
+template <>
+struct dlpack_device<gt::space::thrust_managed>
+  : dlpack_device_gpu<gt::space::thrust_managed, kDLCUDAManaged>
+{};
+#elif defined(GTENSOR_DEVICE_HIP)
+template <>
+struct dlpack_device<gt::space::thrust>
+  : dlpack_device_gpu<gt::space::thrust, kDLROCM>
+{};
+template <>
+struct dlpack_device<gt::space::thrust_managed>
+  : dlpack_device_gpu<gt::space::thrust_managed, kDLROCM>
+{};
+#endif
+template <>
+struct dlpack_device<gt::space::thrust_host>
+  : dlpack_device<gt::space::host_only>
+{};
+#endif
+
+// ----------------------------------------------------------------------
+// dlpack_context
+//
+// manager_ctx of exported tensors: holds the shape and strides arrays the
+// DLTensor points to, and the owned container, if any
+
+template <size_type N, typename Owner>
+struct dlpack_context
+{
+  dlpack_context(Owner&& owner) : owner(std::move(owner)) {}
+
+  DLManagedTensor managed;
+  std::int64_t shape[N > 0 ? N : 1];
+  std::int64_t strides[N > 0 ? N : 1];
+  Owner owner;
+
+  static void deleter(DLManagedTensor* self)
+  {
+    delete static_cast<dlpack_context*>(self->manager_ctx);
+  }
+};
+
+struct dlpack_no_owner
+{};
+
+template <typename S, typename T, size_type N, typename Owner>
+inline DLManagedTensor* init_dlpack(dlpack_context<N, Owner>* ctx, T* data,
+                                    const gt::shape_type<N>& shape,
+                                    const gt::strides_type<N>& strides)
+{
+  std::int64_t stride = 1;
+  for (int d = 0; d < N; d++) {
+    ctx->shape[d] = shape[d];
+    // size one dimensions have stride 0 in gtensor, give them the compact
+    // stride so that consumers recognize contiguous data
+    ctx->strides[d] = shape[d] == 1 ? stride : strides[d];
+    stride = ctx->strides[d] * shape[d];
+  }
+
+  DLTensor& t = ctx->managed.dl_tensor;
+  t.data = const_cast<std::remove_const_t<T>*>(data);
+  t.device = dlpack_device<S>::get();
+  t.ndim = N;
+  t.dtype = dlpack_dtype<std::remove_const_t<T>>::get();
+  t.shape = ctx->shape;
+  t.strides = ctx->strides;
+  t.byte_offset = 0;
+  ctx->managed.manager_ctx = ctx;
+  ctx->managed.deleter = &dlpack_context<N, Owner>::deleter;
+  return &ctx->managed;
+}
+
+template <typename S, typename T, size_type N>
+inline DLManagedTensor* make_dlpack_borrowed(T* data,
+                                             const gt::shape_type<N>& shape,
+                                             const gt::strides_type<N>& strides)
+{
+  auto ctx = new dlpack_context<N, dlpack_no_owner>(dlpack_no_owner{});
+  return init_dlpack<S>(ctx, data, shape, strides);
+}
+
+} // namespace detail
+
+// ======================================================================
+// to_dlpack
+
+// non-owning export of a span
+template <typename T, size_type N, typename S>
+inline DLManagedTensor* to_dlpack(const gtensor_span<T, N, S>& s)
+{
+  return detail::make_dlpack_borrowed<S>(gt::raw_pointer_cast(s.data()),
+                                         s.shape(), s.strides());
+}
+
+// non-owning export of a container, which has to outlive the result
+template <typename EC, size_type N, typename L>
+inline DLManagedTensor* to_dlpack(gtensor_container<EC, N, L>& c)
+{
+  using S = typename space::storage_traits<EC>::space_type;
+  return detail::make_dlpack_borrowed<S>(gt::raw_pointer_cast(c.data()),
+                                         c.shape(), c.strides());
+}
+
+// owning export: the container is moved into the result, and destroyed by
+// its deleter
+template <typename EC, size_type N, typename L>
+inline DLManagedTensor* to_dlpack(gtensor_container<EC, N, L>&& c)
+{
+  using S = typename space::storage_traits<EC>::space_type;
+  auto ctx =
+    new detail::dlpack_context<N, gtensor_container<EC, N, L>>(std::move(c));
+  auto& owner = ctx->owner;
+  return detail::init_dlpack<S>(ctx, gt::raw_pointer_cast(owner.data()),
+                                owner.shape(), owner.strides());
+}
+
+// ======================================================================
+// from_dlpack
+//
+// view a DLTensor as a gtensor_span<T, N, S>. The element type, rank and
+// memory space have to match, otherwise std::runtime_error is thrown. The
+// data is not owned by the span.
+
+template <typename T, size_type N, typename S = gt::space::host>
+inline gtensor_span<T, N, S> from_dlpack(const DLTensor& t)
+{
+  const DLDataType dtype = detail::dlpack_dtype<std::remove_const_t<T>>::get();
+  if (t.dtype.code != dtype.code || t.dtype.bits != dtype.bits ||
+      t.dtype.lanes != dtype.lanes) {
+    throw std::runtime_error("gt::from_dlpack: element type mismatch");
+  }
+  if (t.ndim != N) {
+    throw std::runtime_error("gt::from_dlpack: expected rank " +
+                             std::to_string(N) + ", got " +
+                             std::to_string(t.ndim));
+  }
+  if (!detail::dlpack_device<S>::accepts(t.device.device_type)) {
+    throw std::runtime_error("gt::from_dlpack: device type " +
+                             std::to_string(t.device.device_type) +
+                             " not accessible from this space");
+  }
+
+  gt::shape_type<N> shape;
+  gt::strides_type<N> strides;
+  std::int64_t stride = 1;
+  for (int d = N - 1; d >= 0; d--) {
+    // NULL strides mean compact row-major
+    std::int64_t s = t.strides ? t.strides[d] : stride;
+    if (t.shape[d] > std::numeric_limits<int>::max() ||
+        s > std::numeric_limits<gt::index_type>::max() ||
+        s < std::numeric_limits<gt::index_type>::min()) {
+      throw std::runtime_error("gt::from_dlpack: extent or stride too large");
+    }
+    shape[d] = t.shape[d];
+    // gtensor broadcasts size one dimensions through their stride 0
+    strides[d] = t.shape[d] == 1 ? 0 : s;
+    stride *= t.shape[d];
+  }
+
+  auto data = reinterpret_cast<T*>(static_cast<char*>(t.data) + t.byte_offset);
+  return gtensor_span<T, N, S>(gt::space_pointer_cast<S>(data), shape, strides);
+}
+
+// ======================================================================
+// dlpack_tensor
+//
+// takes ownership of a DLManagedTensor (e.g. from another library's
+// __dlpack__ / to_dlpack), exposes it as a span and calls the producer's
+// deleter on destruction. If the tensor can't be imported, the constructor
+// throws and ownership stays with the caller.
+
+template <typename T, size_type N, typename S = gt::space::host>
+class dlpack_tensor
+{
+public:
+  using span_type = gtensor_span<T, N, S>;
+
+  explicit dlpack_tensor(DLManagedTensor* managed)
+    : managed_(managed), span_(from_dlpack<T, N, S>(managed->dl_tensor))
+  {}
+
+  dlpack_tensor(dlpack_tensor&& other)
+    : managed_(other.managed_), span_(other.span_)
+  {
+    other.managed_ = nullptr;
+  }
+
+  dlpack_tensor& operator=(dlpack_tensor&& other)
+  {
+    std::swap(managed_, other.managed_);
+    std::swap(span_, other.span_);
+    return *this;
+  }
+
+  dlpack_tensor(const dlpack_tensor&) = delete;
+  dlpack_tensor& operator=(const dlpack_tensor&) = delete;
+
+  ~dlpack_tensor()
+  {
+    if (managed_ && managed_->deleter) {
+      managed_->deleter(managed_);
+    }
+  }
+
+  const span_type& span() const { return span_; }
+
+  // give up ownership without calling the deleter
+  DLManagedTensor* release()
+  {
+    auto managed = managed_;
+    managed_ = nullptr;
+    return managed;
+  }
+
+private:
+  DLManagedTensor* managed_;
+  span_type span_;
+};
+
+} // namespace gt
+
+#endif // GTENSOR_DLPACK_H
@@ -3,6 +3,7 @@
 #define GTENSOR_EXPRESSION_H
 
 #include <string>
+#include <utility>
 
 #include "defs.h"
 #include "gtensor_forward.h"
@@ -124,6 +125,26 @@ GT_INLINE decltype(auto) index_expression(E&& expr, shape_type<6> idx)
   return expr(idx[0], idx[1], idx[2], idx[3], idx[4], idx[5]);
 }
 
+namespace detail
+{
+
+template <typename E, typename S, size_type... I>
+GT_INLINE decltype(auto) index_expression(E&& expr, const S& idx,
+                                          std::index_sequence<I...>)
+{
+  return expr(idx[I]...);
+}
+
+} // namespace detail
+
+// any higher rank
+template <typename E, size_type N>
+GT_INLINE decltype(auto) index_expression(E&& expr, shape_type<N> idx)
+{
+  return detail::index_expression(std::forward<E>(expr), idx,
+                                  std::make_index_sequence<N>());
+}
+
 } // namespace gt
 
 #endif
@@ -32,13 +32,14 @@ MAKE_CFI_type(gt::complex<float>, CFI_type_float_Complex);
 MAKE_CFI_type(gt::complex<double>, CFI_type_double_Complex);
 
 template <typename T, std::size_t N>
-std::pair<gt::shape_type<N>, gt::shape_type<N>> to_shape_strides(
+std::pair<gt::shape_type<N>, gt::strides_type<N>> to_shape_strides(
   farray<T, N>* nd)
 {
   assert(nd->desc.rank == N);
   // complex type is broken in gfortran < 12 (?)
   // assert(nd->desc.type == detail::CFI_type<T>::value);
-  gt::shape_type<N> shape, strides;
+  gt::shape_type<N> shape;
+  gt::strides_type<N> strides;
   for (int d = 0; d < N; d++) {
     shape[d] = nd->desc.dim[d].extent;
     strides[d] = (shape[d] == 1 ? 0 : nd->desc.dim[d].sm / sizeof(T));
@@ -48,6 +49,25 @@ std::pair<gt::shape_type<N>, gt::shape_type<N>> to_shape_strides(
 
 } // namespace detail
 
+// number of elements, for descriptors of any rank (including assumed-rank
+// `dimension(..)` dummies, where N is not checked)
+template <typename T, std::size_t N>
+std::size_t size(const farray<T, N>* nd)
+{
+  std::size_t n = 1;
+  for (int d = 0; d < nd->desc.rank; d++) {
+    n *= nd->desc.dim[d].extent;
+  }
+  return n;
+}
+
+template <typename T, std::size_t N>
+bool is_contiguous(const farray<T, N>* nd)
+{
+  return CFI_is_contiguous(
+           reinterpret_cast<const CFI_cdesc_t*>(&nd->desc)) != 0;
+}
+
 template <std::size_t N, typename T, typename S = space::host>
 gtensor_span<T, N, S> adapt(farray<T, N>* nd)
 {
@@ -0,0 +1,393 @@
+#ifndef GTENSOR_GATHER_H
+#define GTENSOR_GATHER_H
+
+#include "gtensor.h"
+
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#ifdef GTENSOR_DEVICE_SYCL
+#include <sycl/sycl.hpp>
+#endif
+
+namespace gt
+{
+
+// ======================================================================
+// gather / scatter
+//
+// gather(a, idx) is the lazy expression with the shape of idx whose
+// elements are a(idx(i...)), where the values of idx are linear indices
+// into a in logical (column-major) order, so for 1-d a simply a(idx(i)).
+// Like any other expression, it can be combined with gfunction operators
+// and assigned, so e.g. out = 2 * gather(a, idx) + b runs as one kernel.
+// Indices are not bounds checked.
+//
+// scatter(out, idx, v) does out(idx(i...)) = v(i...), and
+// scatter_add(out, idx, v) does out(idx(i...)) += v(i...) such that
+// repeated indices accumulate, where v is an expression of the shape of
+// idx, or a scalar. With scatter_strategy::atomic, elements are added with
+// device atomics in parallel. With scatter_strategy::sorted (host only,
+// device expressions fall back to atomic), the positions are stably sorted
+// by index first, so each segment of equal indices is summed in order and
+// written once; the result doesn't depend on scheduling, and each target is
+// touched once. For scatter with repeated indices, which value wins is
+// unspecified.
+//
+// On the host, indexed loads and stores are prefetched a fixed distance
+// ahead along the first (fastest) dimension, which hides much of the
+// latency of random access into arrays that don't fit in cache.
+
+enum class scatter_strategy
+{
+  atomic,
+  sorted
+};
+
+namespace detail
+{
+
+constexpr int gather_prefetch_distance = 16;
+
+template <typename T>
+GT_INLINE void prefetch(const T* p)
+{
+#if !defined(GTENSOR_DEVICE_ONLY) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_prefetch(p);
+#endif
+}
+
+template <typename T>
+GT_INLINE void atomic_add(T* p, T value)
+{
+#if defined(GTENSOR_DEVICE_ONLY) &&                                            \
+  (defined(GTENSOR_DEVICE_CUDA) || defined(GTENSOR_DEVICE_HIP))
+  atomicAdd(p, value);
+#elif defined(GTENSOR_DEVICE_SYCL)
+  ::sycl::atomic_ref<T, ::sycl::memory_order::relaxed,
+                     ::sycl::memory_scope::device,
+                     ::sycl::access::address_space::generic_space>(*p)
+    .fetch_add(value);
+#else
+  // host launches are serial
+  *p += value;
+#endif
+}
+
+template <typename R>
+GT_INLINE void atomic_add(gt::complex<R>* p, gt::complex<R> value)
+{
+  R* parts = reinterpret_cast<R*>(p);
+  atomic_add(&parts[0], value.real());
+  atomic_add(&parts[1], value.imag());
+}
+
+} // namespace detail
+
+// ======================================================================
+// ggather
+
+template <typename E, typename I>
+class ggather;
+
+template <typename E, typename I>
+struct gtensor_inner_types<ggather<E, I>>
+{
+  using space_type = space_t<expr_space_type<E>, expr_space_type<I>>;
+  constexpr static size_type dimension = expr_dimension<I>();
+
+  using value_type = expr_value_type<E>;
+  using reference = value_type;
+  using const_reference = value_type;
+};
+
+template <typename E, typename I>
+class ggather : public expression<ggather<E, I>>
+{
+public:
+  using self_type = ggather<E, I>;
+  using base_type = expression<self_type>;
+  using inner_types = gtensor_inner_types<self_type>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  // read only, like gfunction
+  using const_kernel_type =
+    ggather<to_kernel_t<std::add_const_t<E>>, to_kernel_t<std::add_const_t<I>>>;
+  using kernel_type = const_kernel_type;
+
+  constexpr static size_type dimension() { return inner_types::dimension; };
+
+  using shape_type = gt::shape_type<dimension()>;
+  using source_strides_type = gt::unravel_strides<expr_dimension<E>()>;
+
+  ggather(E&& e, I&& idx)
+    : e_(std::forward<E>(e)),
+      idx_(std::forward<I>(idx)),
+      e_strides_(e_.shape()),
+      e_size_(e_.size())
+  {}
+
+  GT_INLINE shape_type shape() const { return idx_.shape(); }
+  GT_INLINE int shape(int i) const { return idx_.shape(i); }
+  GT_INLINE size_type size() const { return idx_.size(); }
+
+  template <typename... Args>
+  GT_INLINE value_type operator()(Args... args) const
+  {
+    prefetch_ahead(args...);
+    return source(idx_(args...));
+  }
+
+  const_kernel_type to_kernel() const
+  {
+    return const_kernel_type(e_.to_kernel(), idx_.to_kernel(), e_strides_,
+                             e_size_);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    return "gather(" + e_.typestr() + ", " + idx_.typestr() + ")";
+  }
+
+  // used by to_kernel()
+  ggather(E&& e, I&& idx, const source_strides_type& e_strides,
+          size_type e_size)
+    : e_(std::forward<E>(e)),
+      idx_(std::forward<I>(idx)),
+      e_strides_(e_strides),
+      e_size_(e_size)
+  {}
+
+private:
+  template <typename J>
+  GT_INLINE decltype(auto) source(J j) const
+  {
+    return index_expression(e_, e_strides_.unravel(size_type(j)));
+  }
+
+  // host only: touch the element that will be gathered a few iterations
+  // from now, if the source is addressable
+  template <typename... Rest>
+  GT_INLINE void prefetch_ahead(int i0, Rest... rest) const
+  {
+#ifndef GTENSOR_DEVICE_ONLY
+    prefetch_ahead_impl(
+      std::integral_constant<
+        bool, std::is_same<space_type, space::host>::value &&
+                std::is_lvalue_reference<decltype(source(0))>::value>{},
+      i0, rest...);
+#endif
+  }
+
+  GT_INLINE void prefetch_ahead() const {}
+
+  template <typename... Args>
+  GT_INLINE void prefetch_ahead_impl(std::false_type, Args... args) const
+  {}
+
+  template <typename... Rest>
+  GT_INLINE void prefetch_ahead_impl(std::true_type, int i0,
+                                     Rest... rest) const
+  {
+    const int ahead = i0 + detail::gather_prefetch_distance;
+    if (ahead < idx_.shape(0)) {
+      size_type j = idx_(ahead, rest...);
+      if (j < e_size_) {
+        detail::prefetch(&source(j));
+      }
+    }
+  }
+
+  E e_;
+  I idx_;
+  source_strides_type e_strides_;
+  size_type e_size_;
+};
+
+template <typename E, typename I>
+inline auto gather(E&& e, I&& idx)
+{
+  static_assert(std::is_integral<expr_value_type<I>>::value,
+                "gt::gather: indices must be integers");
+  return ggather<to_expression_t<E>, to_expression_t<I>>(std::forward<E>(e),
+                                                         std::forward<I>(idx));
+}
+
+// ======================================================================
+// scatter, scatter_add
+
+namespace detail
+{
+
+template <typename EO, typename EI, typename EV>
+inline auto scatter_shape(const EO& out, const EI& idx, const EV& v)
+{
+  static_assert(std::is_integral<expr_value_type<EI>>::value,
+                "gt::scatter: indices must be integers");
+  using shape_type = expr_shape_type<EI>;
+  const shape_type shape = idx.shape();
+  if (expr_dimension<EV>() > 0) {
+    shape_type v_shape;
+    calc_shape(v_shape, idx, v);
+    if (v_shape != shape) {
+      throw std::runtime_error(
+        "gt::scatter: values must have the shape of the indices");
+    }
+  }
+  return shape;
+}
+
+// one thread per position (i0, rest...) of idx and v
+template <bool Add, bool Host, typename T, size_type NO, typename KO,
+          typename KI, typename KV>
+struct scatter_kernel
+{
+  template <typename... Rest>
+  GT_INLINE void operator()(int i0, Rest... rest) const
+  {
+    if (Host && i0 + gather_prefetch_distance < n0) {
+      size_type j = k_idx(i0 + gather_prefetch_distance, rest...);
+      if (j < out_size) {
+        prefetch(&index_expression(k_out, out_strides.unravel(j)));
+      }
+    }
+    auto& target = index_expression(
+      k_out, out_strides.unravel(size_type(k_idx(i0, rest...))));
+    T value = k_v(i0, rest...);
+    if (Add) {
+      atomic_add(&target, value);
+    } else {
+      target = value;
+    }
+  }
+
+  KO k_out;
+  KI k_idx;
+  KV k_v;
+  unravel_strides<NO> out_strides;
+  int n0;
+  size_type out_size;
+};
+
+// launched over the shape of idx, so the launch picks 32 or 64-bit linear
+// indexing from the total size like any other
+template <bool Add, typename EO, typename EI, typename EV>
+inline void scatter_launch(EO& out, const EI& idx, const EV& v,
+                           gt::stream_view stream)
+{
+  using S = expr_space_type<EO>;
+  using T = expr_value_type<EO>;
+  constexpr auto N = expr_dimension<EI>();
+  constexpr auto NO = expr_dimension<EO>();
+  auto shape = scatter_shape(out, idx, v);
+
+  auto k_out = out.to_kernel();
+  auto k_idx = idx.to_kernel();
+  auto k_v = v.to_kernel();
+  constexpr bool host = std::is_same<S, space::host>::value;
+  using kernel = scatter_kernel<Add, host, T, NO, decltype(k_out),
+                                decltype(k_idx), decltype(k_v)>;
+
+  gt::launch<N, S>(shape,
+                   kernel{k_out, k_idx, k_v, unravel_strides<NO>(out.shape()),
+                          shape[0], size_type(out.size())},
+                   stream);
+}
+
+template <typename S>
+struct scatter_add_sorted
+{
+  // no sorted strategy on devices
+  template <typename EO, typename EI, typename EV>
+  static void run(EO& out, const EI& idx, const EV& v, gt::stream_view stream)
+  {
+    scatter_launch<true>(out, idx, v, stream);
+  }
+};
+
+template <>
+struct scatter_add_sorted<space::host>
+{
+  template <typename EO, typename EI, typename EV>
+  static void run(EO& out, const EI& idx, const EV& v, gt::stream_view stream)
+  {
+    using T = expr_value_type<EO>;
+    using J = expr_value_type<EI>;
+    constexpr auto N = expr_dimension<EI>();
+    auto shape = scatter_shape(out, idx, v);
+    const size_type n = calc_size(shape);
+
+    // flat copies in logical order, evaluates expressions once
+    gt::gtensor<J, N, space::host> h_idx(shape);
+    h_idx = idx;
+    gt::gtensor<T, N, space::host> h_v(shape);
+    h_v = v;
+    const J* pidx = h_idx.data();
+    const T* pv = h_v.data();
+
+    std::vector<size_type> order(n);
+    std::iota(order.begin(), order.end(), size_type(0));
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_type a, size_type b) { return pidx[a] < pidx[b]; });
+
+    auto out_strides = unravel_strides<expr_dimension<EO>()>(out.shape());
+    size_type k = 0;
+    while (k < n) {
+      const J target = pidx[order[k]];
+      T acc = pv[order[k]];
+      for (k++; k < n && pidx[order[k]] == target; k++) {
+        if (k + gather_prefetch_distance < n) {
+          prefetch(&pv[order[k + gather_prefetch_distance]]);
+        }
+        acc += pv[order[k]];
+      }
+      index_expression(out, out_strides.unravel(size_type(target))) += acc;
+    }
+  }
+};
+
+} // namespace detail
+
+template <typename EO, typename EI, typename EV>
+inline void scatter(EO&& out, const EI& idx, const EV& v,
+                    gt::stream_view stream = gt::stream_view{})
+{
+  detail::scatter_launch<false>(out, idx, to_expression_t<const EV&>(v),
+                                stream);
+}
+
+template <typename EO, typename EI, typename EV>
+inline void scatter_add(EO&& out, const EI& idx, const EV& v,
+                        scatter_strategy strategy = scatter_strategy::atomic,
+                        gt::stream_view stream = gt::stream_view{})
+{
+  using S = expr_space_type<EO>;
+  if (strategy == scatter_strategy::sorted) {
+    detail::scatter_add_sorted<S>::run(out, idx, to_expression_t<const EV&>(v),
+                                       stream);
+  } else {
+    detail::scatter_launch<true>(out, idx, to_expression_t<const EV&>(v),
+                                 stream);
+  }
+}
+
+} // namespace gt
+
+#endif // GTENSOR_GATHER_H
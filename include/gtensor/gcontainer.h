@@ -114,9 +114,10 @@ inline void gcontainer<D>::fill(const value_type v)
 template <typename D>
 inline void gcontainer<D>::resize(const shape_type& shape)
 {
-  this->shape_ = shape;
-  this->strides_ = calc_strides(shape);
+  // resize storage first, so the shape stays consistent if it throws
   storage().resize(calc_size(shape));
+  this->shape_ = shape;
+  this->strides_ = calc_strides(shape, typename inner_types::layout_type{});
 }
 
 #pragma nv_exec_check_disable
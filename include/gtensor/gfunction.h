@@ -5,6 +5,7 @@
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 #include "complex_ops.h"
 #include "defs.h"
@@ -168,6 +169,19 @@ GT_INLINE void calc_shape(S& shape, const Es&... es)
 struct gt_empty_expr
 {};
 
+namespace detail
+{
+
+// evaluates an expression along rows of the host odometer, see assign.h
+template <typename E, size_type N, typename Enable = void>
+struct row_binder;
+
+// builds the kernel of an expression with its leaves transformed by a
+// policy, see wrap.h
+struct kernel_transform;
+
+} // namespace detail
+
 // declare generic gfunction; unary and binary versions are defined below
 template <typename F, typename E1, typename E2>
 class gfunction;
@@ -243,6 +257,10 @@ public:
   inline std::string typestr() const&;
 
 private:
+  template <typename, size_type, typename>
+  friend struct detail::row_binder;
+  friend struct detail::kernel_transform;
+
   F f_;
   E e_;
 };
@@ -296,6 +314,10 @@ public:
   inline std::string typestr() const&;
 
 private:
+  template <typename, size_type, typename>
+  friend struct detail::row_binder;
+  friend struct detail::kernel_transform;
+
   F f_;
   E1 e1_;
   E2 e2_;
@@ -449,6 +471,10 @@ MAKE_BINARY_OP(plus, +)
 MAKE_BINARY_OP(minus, -)
 MAKE_BINARY_OP(multiply, *)
 MAKE_BINARY_OP(divide, /)
+MAKE_BINARY_OP(less, <)
+MAKE_BINARY_OP(greater, >)
+MAKE_BINARY_OP(less_equal, <=)
+MAKE_BINARY_OP(greater_equal, >=)
 
 #undef MAKE_BINARY_OP
 
@@ -523,6 +549,118 @@ inline std::string gfunction<F, E1, gt_empty_expr>::typestr() const&
   return s.str();
 }
 
+// ======================================================================
+// gwhere
+//
+// where(cond, a, b) is the lazy elementwise select, a where cond is true
+// and b elsewhere, with all three broadcast to a common shape. Both a and b
+// are evaluated everywhere, so the select compiles to a blend rather than a
+// branch, and host loops over it still vectorize. The value type is the
+// common type of a and b.
+
+template <typename C, typename E1, typename E2>
+class gwhere;
+
+template <typename C, typename E1, typename E2>
+struct gtensor_inner_types<gwhere<C, E1, E2>>
+{
+  using space_type =
+    space_t<expr_space_type<C>, expr_space_type<E1>, expr_space_type<E2>>;
+  constexpr static size_type dimension = helper::calc_dimension<C, E1, E2>();
+
+  using value_type =
+    std::common_type_t<expr_value_type<E1>, expr_value_type<E2>>;
+  using reference = value_type;
+  using const_reference = value_type;
+};
+
+template <typename C, typename E1, typename E2>
+class gwhere : public expression<gwhere<C, E1, E2>>
+{
+public:
+  using self_type = gwhere<C, E1, E2>;
+  using base_type = expression<self_type>;
+  using inner_types = gtensor_inner_types<self_type>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  // Note: important for const correctness. See gview for explanation.
+  using const_kernel_type = gwhere<to_kernel_t<std::add_const_t<C>>,
+                                   to_kernel_t<std::add_const_t<E1>>,
+                                   to_kernel_t<std::add_const_t<E2>>>;
+  using kernel_type = const_kernel_type;
+
+  constexpr static size_type dimension() { return inner_types::dimension; };
+
+  using shape_type = gt::shape_type<dimension()>;
+
+  gwhere(C&& c, E1&& e1, E2&& e2)
+    : c_(std::forward<C>(c)),
+      e1_(std::forward<E1>(e1)),
+      e2_(std::forward<E2>(e2))
+  {
+    // force shape check on host
+    shape();
+  }
+
+  GT_INLINE shape_type shape() const
+  {
+    shape_type shape;
+    calc_shape(shape, c_, e1_, e2_);
+    return shape;
+  }
+  GT_INLINE int shape(int i) const { return shape()[i]; }
+  GT_INLINE size_type size() const { return calc_size(shape()); }
+
+  template <typename... Args>
+  GT_INLINE value_type operator()(Args... args) const
+  {
+    const value_type a = e1_(args...);
+    const value_type b = e2_(args...);
+    return static_cast<bool>(c_(args...)) ? a : b;
+  }
+
+  const_kernel_type to_kernel() const
+  {
+    return const_kernel_type(c_.to_kernel(), e1_.to_kernel(),
+                             e2_.to_kernel());
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "where(" << c_.typestr() << ", " << e1_.typestr() << ", "
+      << e2_.typestr() << ")";
+    return s.str();
+  }
+
+private:
+  C c_;
+  E1 e1_;
+  E2 e2_;
+};
+
+template <typename C, typename E1, typename E2>
+inline auto where(C&& c, E1&& e1, E2&& e2)
+{
+  return gwhere<to_expression_t<C>, to_expression_t<E1>, to_expression_t<E2>>(
+    std::forward<C>(c), std::forward<E1>(e1), std::forward<E2>(e2));
+}
+
 // ======================================================================
 // ggenerator
 
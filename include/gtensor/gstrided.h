@@ -48,7 +48,7 @@ public:
   constexpr static size_type dimension() { return inner_types::dimension; }
 
   using shape_type = gt::shape_type<dimension()>;
-  using strides_type = gt::shape_type<dimension()>;
+  using strides_type = gt::strides_type<dimension()>;
 
   using base_type::derived;
 
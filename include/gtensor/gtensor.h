@@ -3,6 +3,7 @@
 #define GTENSOR_GTENSOR_H
 
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 #include "defs.h"
@@ -30,11 +31,12 @@ namespace gt
 // ======================================================================
 // gtensor_container
 
-template <typename EC, size_type N>
-struct gtensor_inner_types<gtensor_container<EC, N>>
+template <typename EC, size_type N, typename L>
+struct gtensor_inner_types<gtensor_container<EC, N, L>>
 {
   using space_type = typename space::storage_traits<EC>::space_type;
   constexpr static size_type dimension = N;
+  using layout_type = L;
 
   using storage_type = EC;
   using value_type = typename storage_type::value_type;
@@ -44,11 +46,12 @@ struct gtensor_inner_types<gtensor_container<EC, N>>
   using const_reference = typename storage_type::const_reference;
 };
 
-template <typename EC, size_type N>
-class gtensor_container : public gcontainer<gtensor_container<EC, N>>
+template <typename EC, size_type N, typename L>
+class gtensor_container : public gcontainer<gtensor_container<EC, N, L>>
 {
 public:
-  using self_type = gtensor_container<EC, N>;
+  using self_type = gtensor_container<EC, N, L>;
+  using layout_type = L;
   using base_type = gcontainer<self_type>;
   using inner_types = gtensor_inner_types<self_type>;
   using storage_type = typename inner_types::storage_type;
@@ -78,6 +81,7 @@ public:
   template <typename E, typename = std::enable_if_t<
                           std::is_convertible<E, value_type>::value>>
   gtensor_container(const shape_type& shape, E fill_value);
+  gtensor_container(const shape_type& shape, storage_type&& storage);
 
   using base_type::operator=;
 
@@ -103,9 +107,9 @@ private:
 // ======================================================================
 // gtensor_container implementation
 
-template <typename T, size_type N>
-inline gtensor_container<T, N>::gtensor_container(const shape_type& shape)
-  : base_type(shape, calc_strides(shape)), storage_(calc_size(shape))
+template <typename T, size_type N, typename L>
+inline gtensor_container<T, N, L>::gtensor_container(const shape_type& shape)
+  : base_type(shape, calc_strides(shape, L{})), storage_(calc_size(shape))
 {
 #if defined(GTENSOR_USE_THRUST) && defined(GTENSOR_DEVICE_HIP)
   // NOTE: rocThrust backend appears to not synchronize uninitialized zero fill
@@ -115,17 +119,27 @@ inline gtensor_container<T, N>::gtensor_container(const shape_type& shape)
 #endif
 }
 
-template <typename T, size_type N>
+template <typename T, size_type N, typename L>
 template <typename E, typename Enabled>
-inline gtensor_container<T, N>::gtensor_container(const shape_type& shape,
-                                                  E fill_value)
-  : base_type(shape, calc_strides(shape)), storage_(calc_size(shape))
+inline gtensor_container<T, N, L>::gtensor_container(const shape_type& shape,
+                                                     E fill_value)
+  : base_type(shape, calc_strides(shape, L{})), storage_(calc_size(shape))
 {
   this->fill(fill_value);
 }
 
-template <typename EC, size_type N>
-inline gtensor_container<EC, N>::gtensor_container(
+template <typename T, size_type N, typename L>
+inline gtensor_container<T, N, L>::gtensor_container(const shape_type& shape,
+                                                     storage_type&& storage)
+  : base_type(shape, calc_strides(shape, L{})), storage_(std::move(storage))
+{
+  if (storage_.size() < calc_size(shape)) {
+    throw std::runtime_error("gtensor_container: storage too small for shape");
+  }
+}
+
+template <typename EC, size_type N, typename L>
+inline gtensor_container<EC, N, L>::gtensor_container(
   helper::nd_initializer_list_t<value_type, N> il)
   : base_type({}, {})
 {
@@ -134,7 +148,7 @@ inline gtensor_container<EC, N>::gtensor_container(
   base_type::resize(shape);
 #if defined(GTENSOR_HAVE_DEVICE) && !defined(GTENSOR_USE_THRUST)
   if (std::is_same<space_type, space::device>::value) {
-    gtensor<value_type, N, space::host> host_temp(shape);
+    gtensor<value_type, N, space::host, L> host_temp(shape);
     helper::nd_initializer_list_copy<N>(il, host_temp);
     gt::copy_n(host_temp.data(), host_temp.size(), base_type::data());
   } else {
@@ -145,56 +159,57 @@ inline gtensor_container<EC, N>::gtensor_container(
 #endif
 }
 
-template <typename T, size_type N>
+template <typename T, size_type N, typename L>
 template <typename E>
-inline gtensor_container<T, N>::gtensor_container(const expression<E>& e)
+inline gtensor_container<T, N, L>::gtensor_container(const expression<E>& e)
 {
   this->resize(e.derived().shape());
   *this = e.derived();
 }
 
-template <typename T, size_type N>
-GT_INLINE auto gtensor_container<T, N>::storage_impl() const
+template <typename T, size_type N, typename L>
+GT_INLINE auto gtensor_container<T, N, L>::storage_impl() const
   -> const storage_type&
 {
   return storage_;
 }
 
-template <typename T, size_type N>
-GT_INLINE auto gtensor_container<T, N>::storage_impl() -> storage_type&
+template <typename T, size_type N, typename L>
+GT_INLINE auto gtensor_container<T, N, L>::storage_impl() -> storage_type&
 {
   return storage_;
 }
 
 #pragma nv_exec_check_disable
-template <typename T, size_type N>
-GT_INLINE auto gtensor_container<T, N>::data_access_impl(size_t i) const
+template <typename T, size_type N, typename L>
+GT_INLINE auto gtensor_container<T, N, L>::data_access_impl(size_t i) const
   -> const_reference
 {
   return storage_[i];
 }
 
 #pragma nv_exec_check_disable
-template <typename T, size_type N>
-GT_INLINE auto gtensor_container<T, N>::data_access_impl(size_t i) -> reference
+template <typename T, size_type N, typename L>
+GT_INLINE auto gtensor_container<T, N, L>::data_access_impl(size_t i)
+  -> reference
 {
   return storage_[i];
 }
 
-template <typename T, size_type N>
-inline auto gtensor_container<T, N>::to_kernel() const -> const_kernel_type
+template <typename T, size_type N, typename L>
+inline auto gtensor_container<T, N, L>::to_kernel() const -> const_kernel_type
 {
   return const_kernel_type(this->data(), this->shape(), this->strides());
 }
 
-template <typename T, size_type N>
-inline auto gtensor_container<T, N>::to_kernel() -> kernel_type
+template <typename T, size_type N, typename L>
+inline auto gtensor_container<T, N, L>::to_kernel() -> kernel_type
 {
   return kernel_type(this->data(), this->shape(), this->strides());
 }
 
-template <typename T, size_type N>
-inline std::string gtensor_container<T, N>::typestr() const&
+template <typename T, size_type N, typename L>
+inline std::string gtensor_container<T, N, L>::typestr() const&
 {
   std::stringstream s;
   s << "d" << N << "<" << get_type_name<typename T::value_type>() << ">"
@@ -202,10 +217,11 @@ inline std::string gtensor_container<T, N>::typestr() const&
   return s.str();
 }
 
-template <typename T, size_type N>
-inline bool gtensor_container<T, N>::is_f_contiguous() const
+template <typename T, size_type N, typename L>
+inline bool gtensor_container<T, N, L>::is_f_contiguous() const
 {
-  return true;
+  return std::is_same<L, layout::column_major>::value ||
+         this->strides() == calc_strides(this->shape());
 }
 
 // ======================================================================
@@ -300,11 +316,11 @@ __global__ void kernel_launch(gt::shape_type<6> shape, F f)
 
 #else // not GTENSOR_PER_DIM_KERNELS
 
-template <typename F, size_type N>
-__global__ void kernel_launch_N(F f, size_type size, gt::shape_type<N> strides)
+template <typename F, typename I, typename S>
+__global__ void kernel_launch_N(F f, I size, S strides)
 {
   // workaround ROCm 5.2.0 compiler bug
-  size_type i = threadIdx.x + static_cast<size_type>(blockIdx.x) * blockDim.x;
+  I i = threadIdx.x + static_cast<I>(blockIdx.x) * blockDim.x;
 
   if (i < size) {
     auto idx = unravel(i, strides);
@@ -423,6 +439,30 @@ struct launch<6, space::host>
   }
 };
 
+// any rank, see for_each_row
+template <int N>
+struct launch<N, space::host>
+{
+  template <typename F>
+  static void run(const gt::shape_type<N>& shape, F&& f, gt::stream_view stream)
+  {
+    detail::for_each_row(shape, [&](gt::shape_type<N>& idx) {
+      for (int i = 0; i < shape[0]; i++) {
+        idx[0] = i;
+        call(f, idx, std::make_index_sequence<N>());
+      }
+    });
+  }
+
+private:
+  template <typename F, size_type... I>
+  static void call(F& f, const gt::shape_type<N>& idx,
+                   std::index_sequence<I...>)
+  {
+    f(idx[I]...);
+  }
+};
+
 #if defined(GTENSOR_DEVICE_CUDA) || defined(GTENSOR_DEVICE_HIP)
 
 #ifdef GTENSOR_PER_DIM_KERNELS
@@ -533,7 +573,6 @@ struct launch<N, space::device>
   static void run(const gt::shape_type<N>& shape, F&& f, gt::stream_view stream)
   {
     auto size = calc_size(shape);
-    auto strides = calc_strides(shape);
     unsigned int block_size = BS_LINEAR;
     if (block_size > size) {
       block_size = static_cast<unsigned int>(size);
@@ -543,9 +582,17 @@ struct launch<N, space::device>
     dim3 numBlocks(gt::div_ceil(size, block_size));
 
     gpuSyncIfEnabledStream(stream);
-    gtLaunchKernel(kernel_launch_N, numBlocks, numThreads, 0,
-                   stream.get_backend_stream(), std::forward<F>(f), size,
-                   strides);
+    if (index_fits_32(size)) {
+      auto strides = calc_fast_strides(shape);
+      gtLaunchKernel(kernel_launch_N, numBlocks, numThreads, 0,
+                     stream.get_backend_stream(), std::forward<F>(f),
+                     static_cast<int>(size), strides);
+    } else {
+      auto strides = calc_strides<size_type>(shape);
+      gtLaunchKernel(kernel_launch_N, numBlocks, numThreads, 0,
+                     stream.get_backend_stream(), std::forward<F>(f), size,
+                     strides);
+    }
     gpuSyncIfEnabledStream(stream);
   }
 };
@@ -637,28 +684,113 @@ struct launch<N, space::device>
 
     sycl::queue q = stream.get_backend_stream();
     auto size = calc_size(shape);
-    auto strides = calc_strides(shape);
+    if (index_fits_32(size)) {
+      submit<int>(q, shape, calc_fast_strides(shape), f);
+    } else {
+      submit<size_type>(q, shape, calc_strides<size_type>(shape), f);
+    }
+
+    gpuSyncIfEnabledStream(stream);
+  }
+
+private:
+  template <typename I, typename S, typename F>
+  static void submit(sycl::queue& q, const gt::shape_type<N>& shape,
+                     const S& strides, F&& f)
+  {
+    auto size = calc_size(shape);
     auto e = q.submit([&](sycl::handler& cgh) {
       // using kname = gt::backend::sycl::LaunchN<decltype(f)>;
       cgh.parallel_for(sycl::range<1>(size), [=](sycl::id<1> i) {
-        auto idx = unravel(i, strides);
+        auto idx = unravel(static_cast<I>(i[0]), strides);
         index_expression(f, idx);
       });
     });
-
-    gpuSyncIfEnabledStream(stream);
   }
 };
 
 #endif
 
+// ----------------------------------------------------------------------
+// layout_launch
+//
+// launch in the memory order of layout L: the launch runs over the permuted
+// shape (shape[O]...), which makes dimension O[0] the fastest varying one,
+// and permuted_kernel maps the indices back to the order f expects.
+
+template <size_type D, size_type... O>
+constexpr size_type position()
+{
+  const size_type order[] = {O...};
+  size_type k = 0;
+  while (order[k] != D) {
+    k++;
+  }
+  return k;
+}
+
+template <typename F, size_type... O>
+struct permuted_kernel
+{
+  template <typename... J>
+  GT_INLINE void operator()(J... j) const
+  {
+    const std::common_type_t<J...> idx[] = {j...};
+    call(idx, std::make_index_sequence<sizeof...(O)>());
+  }
+
+  mutable F f;
+
+private:
+  template <typename I, size_type... D>
+  GT_INLINE void call(const I* idx, std::index_sequence<D...>) const
+  {
+    f(idx[position<D, O...>()]...);
+  }
+};
+
+template <int N, typename S, typename L>
+struct layout_launch
+{
+  template <typename F>
+  static void run(const gt::shape_type<N>& shape, F&& f, gt::stream_view stream)
+  {
+    run(shape, std::forward<F>(f), stream, layout_order_t<L, N>{});
+  }
+
+private:
+  template <typename F, size_type... O>
+  static void run(const gt::shape_type<N>& shape, F&& f, gt::stream_view stream,
+                  std::index_sequence<O...>)
+  {
+    using kernel_type = permuted_kernel<std::decay_t<F>, O...>;
+    launch<N, S>::run(gt::shape_type<N>(shape[O]...),
+                      kernel_type{std::forward<F>(f)}, stream);
+  }
+};
+
+template <int N, typename S>
+struct layout_launch<N, S, layout::column_major>
+{
+  template <typename F>
+  static void run(const gt::shape_type<N>& shape, F&& f, gt::stream_view stream)
+  {
+    launch<N, S>::run(shape, std::forward<F>(f), stream);
+  }
+};
+
 } // namespace detail
 
-template <int N, typename F>
+// launch<N, S, L>, launch_host<N, L> call f(i, j, ...) for all indices of
+// shape, with the loops / threads in the memory order of layout L
+// (column_major by default)
+
+template <int N, typename L = layout::column_major, typename F>
 inline void launch_host(const gt::shape_type<N>& shape, F&& f,
                         gt::stream_view stream = gt::stream_view{})
 {
-  detail::launch<N, space::host>::run(shape, std::forward<F>(f), stream);
+  detail::layout_launch<N, space::host, L>::run(shape, std::forward<F>(f),
+                                                stream);
 }
 
 template <int N, typename F>
@@ -668,11 +800,11 @@ inline void launch(const gt::shape_type<N>& shape, F&& f,
   detail::launch<N, space::device>::run(shape, std::forward<F>(f), stream);
 }
 
-template <int N, typename S, typename F>
+template <int N, typename S, typename L = layout::column_major, typename F>
 inline void launch(const gt::shape_type<N>& shape, F&& f,
                    gt::stream_view stream = gt::stream_view{})
 {
-  detail::launch<N, S>::run(shape, std::forward<F>(f), stream);
+  detail::layout_launch<N, S, L>::run(shape, std::forward<F>(f), stream);
 }
 
 // ======================================================================
@@ -684,6 +816,33 @@ using gtensor_device = gtensor<T, N, space::device>;
 template <typename T, size_type N>
 using gtensor_span_device = gtensor_span<T, N, space::device>;
 
+// ======================================================================
+// gtensor_external, adopt
+//
+// Owning container for a buffer that was allocated elsewhere, e.g. by a
+// foreign allocator. adopt() takes ownership of the buffer without copying;
+// it's released by calling deleter(data) when the container is destroyed.
+// The container can be moved, but not copied.
+
+template <typename T, size_type N, typename S = space::host>
+using gtensor_external =
+  gtensor_container<backend::external_storage<T, S>, N>;
+
+template <typename S = gt::space::host, typename T, size_type N,
+          typename D>
+inline auto adopt(T* data, const gt::shape_type<N>& shape, D&& deleter)
+{
+  return gtensor_external<T, N, S>(
+    shape, backend::external_storage<T, S>(data, calc_size(shape),
+                                           std::forward<D>(deleter)));
+}
+
+template <typename T, size_type N, typename D>
+inline auto adopt_device(T* data, const gt::shape_type<N>& shape, D&& deleter)
+{
+  return adopt<gt::space::device>(data, shape, std::forward<D>(deleter));
+}
+
 // ======================================================================
 // empty
 
@@ -851,7 +1010,11 @@ std::enable_if_t<gt::has_data_and_size<SRC>::value &&
                  gt::has_data_and_size<DST>::value>
 copy(const SRC& src, DST&& dst)
 {
-  if (!dst.is_f_contiguous()) {
+  if (!dst.is_f_contiguous() && src.shape() == dst.shape() &&
+      src.strides() == dst.strides() && detail::is_dense(dst)) {
+    // same dense layout, e.g., both row-major
+    gt::copy_n(src.data(), src.size(), dst.data());
+  } else if (!dst.is_f_contiguous()) {
     auto dst_tmp = gt::empty_like(dst);
     gt::copy(src, dst_tmp);
     dst = dst_tmp;
@@ -860,7 +1023,11 @@ copy(const SRC& src, DST&& dst)
       assert(src.size() == dst.size());
       gt::copy_n(src.data(), src.size(), dst.data());
     } else {
-      gt::copy(gt::eval(src), dst);
+      // not eval(), which passes containers of other layouts through
+      using src_tmp_type =
+        gtensor<std::remove_cv_t<expr_value_type<SRC>>, expr_dimension<SRC>(),
+                expr_space_type<SRC>>;
+      gt::copy(src_tmp_type(src), dst);
     }
   }
 }
@@ -0,0 +1,311 @@
+#ifndef GTENSOR_GTENSOR_FIXED_H
+#define GTENSOR_GTENSOR_FIXED_H
+
+#include "gtensor.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace gt
+{
+
+// ======================================================================
+// fixed_shape
+//
+// A shape whose extents are known at compile time. The size and the
+// (col-major, 0 for size one dimensions) strides are constant expressions,
+// so an index computes as a sum of constant multiples of its components.
+
+template <int... Extents>
+struct fixed_shape
+{
+  static_assert(sizeof...(Extents) > 0, "fixed_shape: no extents");
+
+  constexpr static size_type dimension() { return sizeof...(Extents); }
+
+  GT_INLINE constexpr static int extent(int d)
+  {
+    const int extents[] = {Extents...};
+    return extents[d];
+  }
+
+  GT_INLINE constexpr static index_type stride(int d)
+  {
+    index_type stride = 1;
+    for (int i = 0; i < d; i++) {
+      stride *= extent(i);
+    }
+    return extent(d) == 1 ? 0 : stride;
+  }
+
+  GT_INLINE constexpr static size_type size()
+  {
+    const int extents[] = {Extents...};
+    size_type size = 1;
+    for (auto extent : extents) {
+      size *= extent;
+    }
+    return size;
+  }
+
+  GT_INLINE static gt::shape_type<dimension()> shape()
+  {
+    return gt::shape_type<dimension()>(Extents...);
+  }
+
+  GT_INLINE static gt::strides_type<dimension()> strides()
+  {
+    return strides(std::make_index_sequence<dimension()>());
+  }
+
+  template <typename... Args>
+  GT_INLINE constexpr static index_type index(Args... args)
+  {
+    static_assert(sizeof...(Args) == dimension(),
+                  "fixed_shape: wrong number of indices");
+    return index(std::make_index_sequence<dimension()>(), args...);
+  }
+
+private:
+  template <size_type... I>
+  GT_INLINE static gt::strides_type<dimension()> strides(
+    std::index_sequence<I...>)
+  {
+    return gt::strides_type<dimension()>(stride(I)...);
+  }
+
+  template <size_type... I, typename... Args>
+  GT_INLINE constexpr static index_type index(std::index_sequence<I...>,
+                                              Args... args)
+  {
+    // the strides as template arguments, to force them to be constants
+    const index_type terms[] = {
+      index_type(args) *
+      std::integral_constant<index_type, stride(I)>::value...};
+    index_type idx = 0;
+    for (auto term : terms) {
+      idx += term;
+    }
+    return idx;
+  }
+};
+
+// ======================================================================
+// gfixed
+//
+// Common base of gtensor_fixed, which stores its elements inline, and
+// gtensor_fixed_span, its non-owning kernel type. Shapes, strides and loop
+// bounds of assignments to and from these fold into constants. They are host
+// expressions that mix with any other host expression, including dynamic
+// shape ones, as long as the shapes match at run time.
+
+template <typename D, int... Extents>
+class gfixed : public expression<D>
+{
+public:
+  using base_type = expression<D>;
+  using inner_types = gtensor_inner_types<D>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  using fixed_shape_type = gt::fixed_shape<Extents...>;
+  constexpr static size_type dimension() { return sizeof...(Extents); }
+  using shape_type = gt::shape_type<dimension()>;
+  using strides_type = gt::strides_type<dimension()>;
+
+  using base_type::derived;
+
+  GT_INLINE static shape_type shape() { return fixed_shape_type::shape(); }
+  GT_INLINE constexpr static int shape(int i)
+  {
+    return fixed_shape_type::extent(i);
+  }
+  GT_INLINE static strides_type strides()
+  {
+    return fixed_shape_type::strides();
+  }
+  GT_INLINE constexpr static size_type size()
+  {
+    return fixed_shape_type::size();
+  }
+
+  template <typename... Args>
+  GT_INLINE decltype(auto) operator()(Args... args) const
+  {
+    return derived().data_access(fixed_shape_type::index(args...));
+  }
+  template <typename... Args>
+  GT_INLINE decltype(auto) operator()(Args... args)
+  {
+    return derived().data_access(fixed_shape_type::index(args...));
+  }
+
+  template <typename E>
+  D& operator=(const expression<E>& e)
+  {
+    assign(derived(), e.derived());
+    return derived();
+  }
+
+  void fill(const value_type v) { assign(derived(), scalar(v)); }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &
+  {
+    return gt::view(derived(), std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(derived(), std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this).derived(), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "f" << dimension() << "<" << get_type_name<value_type>() << ">"
+      << shape();
+    return s.str();
+  }
+};
+
+// ======================================================================
+// gtensor_fixed_span
+
+template <typename T, int... Extents>
+class gtensor_fixed_span;
+
+template <typename T, int... Extents>
+struct gtensor_inner_types<gtensor_fixed_span<T, Extents...>>
+{
+  using space_type = space::host;
+  constexpr static size_type dimension = sizeof...(Extents);
+
+  using value_type = T;
+  using reference = T&;
+  using const_reference = T&;
+};
+
+template <typename T, int... Extents>
+class gtensor_fixed_span
+  : public gfixed<gtensor_fixed_span<T, Extents...>, Extents...>
+{
+public:
+  using self_type = gtensor_fixed_span<T, Extents...>;
+  using base_type = gfixed<self_type, Extents...>;
+  using typename base_type::reference;
+  using pointer = T*;
+
+  using base_type::operator=;
+
+  GT_INLINE explicit gtensor_fixed_span(pointer data) : data_(data) {}
+  gtensor_fixed_span(const gtensor_fixed_span&) = default;
+
+  self_type& operator=(const self_type& other)
+  {
+    return base_type::operator=(other);
+  }
+
+  self_type to_kernel() const { return *this; }
+
+  GT_INLINE pointer data() const { return data_; }
+  GT_INLINE reference data_access(size_type i) const { return data_[i]; }
+
+private:
+  pointer data_;
+};
+
+// ======================================================================
+// gtensor_fixed
+//
+// gtensor_fixed<T, Extents...> holds its elements inline, like sarray, so it
+// has no allocation, can live on the stack and is trivially copyable for
+// trivially copyable T. It's zero-initialized by default.
+
+template <typename T, int... Extents>
+class gtensor_fixed;
+
+template <typename T, int... Extents>
+struct gtensor_inner_types<gtensor_fixed<T, Extents...>>
+{
+  using space_type = space::host;
+  constexpr static size_type dimension = sizeof...(Extents);
+
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+};
+
+template <typename T, int... Extents>
+class gtensor_fixed : public gfixed<gtensor_fixed<T, Extents...>, Extents...>
+{
+public:
+  using self_type = gtensor_fixed<T, Extents...>;
+  using base_type = gfixed<self_type, Extents...>;
+  using typename base_type::const_reference;
+  using typename base_type::reference;
+  using typename base_type::shape_type;
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  using kernel_type = gtensor_fixed_span<T, Extents...>;
+  using const_kernel_type = gtensor_fixed_span<const T, Extents...>;
+
+  using base_type::dimension;
+  using base_type::operator=;
+
+  gtensor_fixed() = default;
+  gtensor_fixed(helper::nd_initializer_list_t<T, dimension()> il)
+  {
+    if (helper::nd_initializer_list_shape<dimension()>(il) != this->shape()) {
+      throw std::runtime_error("gtensor_fixed: initializer list shape " +
+                               to_string(helper::nd_initializer_list_shape<
+                                         dimension()>(il)) +
+                               " != " + to_string(this->shape()));
+    }
+    helper::nd_initializer_list_copy<dimension()>(il, *this);
+  }
+  template <typename E>
+  gtensor_fixed(const expression<E>& e)
+  {
+    *this = e.derived();
+  }
+
+  const_kernel_type to_kernel() const { return const_kernel_type(data()); }
+  kernel_type to_kernel() { return kernel_type(data()); }
+
+  GT_INLINE const_pointer data() const { return data_; }
+  GT_INLINE pointer data() { return data_; }
+  GT_INLINE const_reference data_access(size_type i) const { return data_[i]; }
+  GT_INLINE reference data_access(size_type i) { return data_[i]; }
+
+private:
+  T data_[base_type::size()] = {};
+};
+
+namespace detail
+{
+
+template <typename T, int... Extents>
+struct is_data_strided<gtensor_fixed<T, Extents...>> : std::true_type
+{};
+
+template <typename T, int... Extents>
+struct is_data_strided<gtensor_fixed_span<T, Extents...>> : std::true_type
+{};
+
+} // namespace detail
+
+} // namespace gt
+
+#endif // GTENSOR_GTENSOR_FIXED_H
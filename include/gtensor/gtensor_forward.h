@@ -3,6 +3,7 @@
 #define GTENSOR_FORWARD_H
 
 #include "defs.h"
+#include "layout.h"
 #include "space.h"
 
 namespace gt
@@ -28,13 +29,14 @@ struct space_traits2<host>
 
 } // namespace space
 
-template <typename EC, size_type N>
+template <typename EC, size_type N, typename L = layout::column_major>
 class gtensor_container;
 
-template <typename T, size_type N, typename S = space::host>
+template <typename T, size_type N, typename S = space::host,
+          typename L = layout::column_major>
 using gtensor =
   gtensor_container<typename space::space_traits2<S>::template storage_type<T>,
-                    N>;
+                    N, L>;
 } // namespace gt
 
 #endif
@@ -74,23 +74,23 @@ public:
   // Implicit conversion from a gtensor object with the same or compatible
   // element type
   template <
-    class EC,
+    class EC, class L,
     std::enable_if_t<
       is_allowed_element_type_conversion<typename EC::value_type, T>::value &&
         std::is_same<S, typename space::storage_traits<EC>::space_type>::value,
       int> = 0>
-  gtensor_span(gtensor_container<EC, N>& other)
+  gtensor_span(gtensor_container<EC, N, L>& other)
     : base_type{other.shape(), other.strides()},
       storage_{other.data(), other.size()}
   {}
 
   template <
-    class EC,
+    class EC, class L,
     std::enable_if_t<
       is_allowed_element_type_conversion<typename EC::value_type, T>::value &&
         std::is_same<S, typename space::storage_traits<EC>::space_type>::value,
       int> = 0>
-  gtensor_span(const gtensor_container<EC, N>& other)
+  gtensor_span(const gtensor_container<EC, N, L>& other)
     : base_type{other.shape(), other.strides()},
       storage_{other.data(), other.size()}
   {}
@@ -244,6 +244,21 @@ GT_INLINE auto adapt(T* data, const shape_type<N>& shape)
   return adapt<N, gt::space::host, T>(data, shape);
 }
 
+// with the strides of layout L, e.g. adapt<2>(p, shape, layout::row_major{})
+// for a C array
+template <size_type N, typename S, typename T, typename L>
+GT_INLINE auto adapt(gt::space_pointer<T, S> data, const shape_type<N>& shape,
+                     L)
+{
+  return gtensor_span<T, N, S>(data, shape, calc_strides(shape, L{}));
+}
+
+template <size_type N, typename T, typename L>
+GT_INLINE auto adapt(T* data, const shape_type<N>& shape, L layout)
+{
+  return adapt<N, gt::space::host, T>(data, shape, layout);
+}
+
 // Note: constructing shape from existing int array is not device safe,
 // so should be inline not GT_INLINE
 template <size_type N, typename T>
@@ -1,7 +1,9 @@
 #ifndef GTENSOR_DEVICE_STORAGE_H
 #define GTENSOR_DEVICE_STORAGE_H
 
+#include <functional>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
 
 #include "device_backend.h"
@@ -119,6 +121,103 @@ using managed_storage = device_storage<T, gt::managed_allocator<T>>;
 template <typename T, typename A = gt::host_allocator<T>>
 using host_storage = gtensor_storage<T, A, space::host>;
 
+/*! A storage that adopts an externally allocated buffer in space S, and
+ * releases it by calling a user provided deleter, e.g. the free function of
+ * a foreign allocator. It is move-only, so ownership of the buffer can be
+ * transferred but the data is never copied. The buffer can't grow; resizing
+ * to more than the adopted size throws.
+ */
+template <typename T, typename S>
+class external_storage
+{
+public:
+  using value_type = T;
+  using pointer = gt::space_pointer<T, S>;
+  using const_pointer = gt::space_pointer<const T, S>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = gt::size_type;
+  using space_type = S;
+  using deleter_type = std::function<void(T*)>;
+
+  external_storage() : data_(), size_(0), capacity_(0) {}
+
+  external_storage(T* data, size_type count, deleter_type deleter)
+    : data_(data), size_(count), capacity_(count), deleter_(std::move(deleter))
+  {}
+
+  ~external_storage() { reset(); }
+
+  external_storage(const external_storage&) = delete;
+  external_storage& operator=(const external_storage&) = delete;
+
+  external_storage(external_storage&& other)
+    : data_(other.data_),
+      size_(other.size_),
+      capacity_(other.capacity_),
+      deleter_(std::move(other.deleter_))
+  {
+    other.data_ = {};
+    other.size_ = other.capacity_ = 0;
+    other.deleter_ = nullptr;
+  }
+
+  external_storage& operator=(external_storage&& other)
+  {
+    if (this != &other) {
+      reset();
+      data_ = other.data_;
+      size_ = other.size_;
+      capacity_ = other.capacity_;
+      deleter_ = std::move(other.deleter_);
+      other.data_ = {};
+      other.size_ = other.capacity_ = 0;
+      other.deleter_ = nullptr;
+    }
+    return *this;
+  }
+
+  reference operator[](size_type i) { return data_[i]; }
+  const_reference operator[](size_type i) const { return data_[i]; }
+
+  void resize(size_type new_size)
+  {
+    if (new_size > capacity_) {
+      throw std::runtime_error(
+        "gt::backend::external_storage: can't grow adopted buffer");
+    }
+    size_ = new_size;
+  }
+
+  size_type size() const { return size_; }
+  size_type capacity() const { return capacity_; }
+  pointer data() { return data_; }
+  const_pointer data() const { return data_; }
+
+  // give up ownership of the buffer without calling the deleter
+  T* release()
+  {
+    T* p = gt::raw_pointer_cast(data_);
+    data_ = {};
+    size_ = capacity_ = 0;
+    deleter_ = nullptr;
+    return p;
+  }
+
+private:
+  void reset()
+  {
+    if (deleter_ && gt::raw_pointer_cast(data_)) {
+      deleter_(gt::raw_pointer_cast(data_));
+    }
+  }
+
+  pointer data_;
+  size_type size_;
+  size_type capacity_;
+  deleter_type deleter_;
+};
+
 template <typename T, typename A, typename O>
 inline void gtensor_storage<T, A, O>::resize(
   gtensor_storage::size_type new_size, bool discard)
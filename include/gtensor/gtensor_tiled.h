@@ -0,0 +1,832 @@
+#ifndef GTENSOR_GTENSOR_TILED_H
+#define GTENSOR_GTENSOR_TILED_H
+
+#include "gtensor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <utility>
+
+namespace gt
+{
+
+// ======================================================================
+// layout::tiled, layout::morton
+//
+// Storage orders for large 2-d / 3-d grids, where column-major puts the
+// neighbors of an element along the slow dimensions far apart in memory:
+//
+//   layout::tiled<T0, T1, ...>  tiles of T0 x T1 x ... elements, each stored
+//                               contiguously, column-major within a tile and
+//                               across tiles. Tile extents that are powers of
+//                               two make the index calculation shifts and
+//                               masks.
+//   layout::morton              Z-order, the bits of the indices interleaved,
+//                               in cubes of a power of two
+//
+// Neither can be described by strides, so they aren't layouts of
+// gtensor_container; gtensor_tiled<T, N, L> stores its elements in one of
+// them. The storage is padded to whole tiles / cubes. Stencils over tiled
+// storage should go through launch_tiles, which accesses a tile at a time
+// through constant strides, rather than through the per-element index.
+
+namespace layout
+{
+
+template <int... Tile>
+struct tiled
+{};
+
+struct morton
+{};
+
+} // namespace layout
+
+namespace detail
+{
+
+// ----------------------------------------------------------------------
+// tiled_index
+//
+// tiled_index<L, N>(shape) maps an index to the storage offset in layout L
+
+template <typename L, size_type N>
+class tiled_index;
+
+template <int... Tile, size_type N>
+class tiled_index<layout::tiled<Tile...>, N>
+{
+  static_assert(sizeof...(Tile) == N, "layout::tiled: wrong rank");
+
+public:
+  tiled_index() = default;
+
+  explicit tiled_index(const gt::shape_type<N>& shape)
+  {
+    const gt::shape_type<N> tile_shape(Tile...);
+    index_type stride = tile_size();
+    for (int d = 0; d < N; d++) {
+      ntiles_[d] = (shape[d] + tile_shape[d] - 1) / tile_shape[d];
+      tile_strides_[d] = stride;
+      stride *= ntiles_[d];
+    }
+  }
+
+  GT_INLINE constexpr static index_type tile_size()
+  {
+    const int tiles[] = {Tile...};
+    index_type size = 1;
+    for (auto tile : tiles) {
+      size *= tile;
+    }
+    return size;
+  }
+
+  GT_INLINE constexpr static index_type local_stride(int d)
+  {
+    const int tiles[] = {Tile...};
+    index_type stride = 1;
+    for (int i = 0; i < d; i++) {
+      stride *= tiles[i];
+    }
+    return stride;
+  }
+
+  GT_INLINE const gt::shape_type<N>& ntiles() const { return ntiles_; }
+  GT_INLINE const gt::strides_type<N>& tile_strides() const
+  {
+    return tile_strides_;
+  }
+  GT_INLINE index_type storage_size() const
+  {
+    return tile_strides_[N - 1] * ntiles_[N - 1];
+  }
+
+  template <typename... Args>
+  GT_INLINE index_type operator()(Args... args) const
+  {
+    static_assert(sizeof...(Args) == N, "tiled_index: wrong number of indices");
+    return offset(std::make_index_sequence<N>(), size_type(args)...);
+  }
+
+private:
+  template <size_type... D, typename... I>
+  GT_INLINE index_type offset(std::index_sequence<D...>, I... idx) const
+  {
+    // unsigned, with the tile extents and strides within a tile as
+    // constants, so that powers of two divide by a shift
+    const index_type terms[] = {index_type(
+      idx / Tile * tile_strides_[D] +
+      idx % Tile *
+        std::integral_constant<index_type, local_stride(D)>::value)...};
+    index_type offset = 0;
+    for (auto term : terms) {
+      offset += term;
+    }
+    return offset;
+  }
+
+  gt::shape_type<N> ntiles_;
+  gt::strides_type<N> tile_strides_;
+};
+
+// Z-order within cubes of 2^b elements per dimension, where 2^b is the
+// largest power of two that doesn't exceed the extents other than one, and the
+// cubes in column-major order; so a 256^3 grid is one cube, a 2048 x 2048 x 16
+// grid 128 x 128 x 1 cubes of 16^3. The extents are padded to multiples of
+// 2^b.
+
+template <size_type N>
+class tiled_index<layout::morton, N>
+{
+public:
+  tiled_index() = default;
+
+  explicit tiled_index(const gt::shape_type<N>& shape)
+  {
+    bits_ = 31;
+    ndims_ = 0;
+    for (int d = 0; d < N; d++) {
+      int bits = 0;
+      while ((index_type(2) << bits) <= shape[d]) {
+        bits++;
+      }
+      if (shape[d] > 1) {
+        bits_ = std::min(bits_, bits);
+        ndims_++;
+      }
+    }
+    if (ndims_ == 0) {
+      bits_ = 0;
+    }
+    // size one dimensions don't take part in the interleaving
+    const index_type side = index_type(1) << bits_;
+    index_type stride = index_type(1) << (ndims_ * bits_);
+    int shift = 0;
+    for (int d = 0; d < N; d++) {
+      masks_[d] = shape[d] > 1 ? std::uint32_t(side - 1) : 0;
+      shifts_[d] = shape[d] > 1 ? shift++ : 0;
+      cube_strides_[d] = stride;
+      stride *= (shape[d] + side - 1) / side;
+    }
+    storage_size_ = stride;
+  }
+
+  GT_INLINE index_type storage_size() const { return storage_size_; }
+
+  template <typename... Args>
+  GT_INLINE index_type operator()(Args... args) const
+  {
+    static_assert(sizeof...(Args) == N, "tiled_index: wrong number of indices");
+    const std::uint32_t idx[] = {std::uint32_t(args)...};
+    switch (ndims_) {
+      case 2: return offset<2>(idx);
+      case 3: return offset<3>(idx);
+      default: return offset<0>(idx);
+    }
+  }
+
+private:
+  template <int M>
+  GT_INLINE index_type offset(const std::uint32_t* idx) const
+  {
+    std::uint64_t z = 0;
+    index_type cube = 0;
+    for (int d = 0; d < N; d++) {
+      z |= spread(idx[d] & masks_[d], std::integral_constant<int, M>{})
+           << shifts_[d];
+      cube += index_type(idx[d] >> bits_) * cube_strides_[d];
+    }
+    return cube + index_type(z);
+  }
+
+  // the bits of x, M - 1 zero bits between each
+  GT_INLINE static std::uint64_t spread(std::uint32_t x,
+                                        std::integral_constant<int, 2>)
+  {
+    std::uint64_t r = x;
+    r = (r | (r << 16)) & 0x0000ffff0000ffffull;
+    r = (r | (r << 8)) & 0x00ff00ff00ff00ffull;
+    r = (r | (r << 4)) & 0x0f0f0f0f0f0f0f0full;
+    r = (r | (r << 2)) & 0x3333333333333333ull;
+    r = (r | (r << 1)) & 0x5555555555555555ull;
+    return r;
+  }
+
+  GT_INLINE static std::uint64_t spread(std::uint32_t x,
+                                        std::integral_constant<int, 3>)
+  {
+    std::uint64_t r = x;
+    r = (r | (r << 32)) & 0x001f00000000ffffull;
+    r = (r | (r << 16)) & 0x001f0000ff0000ffull;
+    r = (r | (r << 8)) & 0x100f00f00f00f00full;
+    r = (r | (r << 4)) & 0x10c30c30c30c30c3ull;
+    r = (r | (r << 2)) & 0x1249249249249249ull;
+    return r;
+  }
+
+  // any other number of dimensions, one bit at a time
+  GT_INLINE std::uint64_t spread(std::uint32_t x,
+                                 std::integral_constant<int, 0>) const
+  {
+    std::uint64_t r = 0;
+    for (int b = 0; x != 0; b++, x >>= 1) {
+      r |= std::uint64_t(x & 1) << (b * ndims_);
+    }
+    return r;
+  }
+
+  int bits_;
+  int ndims_;
+  sarray<std::uint32_t, N> masks_;
+  sarray<int, N> shifts_;
+  gt::strides_type<N> cube_strides_;
+  index_type storage_size_;
+};
+
+// ----------------------------------------------------------------------
+// for_each_tile_row
+//
+// Calls f(idx, offset, n) for each row of each tile of a tiled layout, in
+// storage order: the n elements at idx, idx + (1, 0, ...), ... are stored at
+// offset, offset + 1, ... Tiles at the upper boundaries are clipped to shape.
+
+template <size_type N, int... Tile, typename F>
+inline void for_each_tile_row(
+  const gt::shape_type<N>& shape,
+  const tiled_index<layout::tiled<Tile...>, N>& index, F&& f)
+{
+  using index_type_ = tiled_index<layout::tiled<Tile...>, N>;
+  const gt::shape_type<N> tile_shape(Tile...);
+  const auto& ntiles = index.ntiles();
+  const auto& tile_strides = index.tile_strides();
+
+  for_each_row(ntiles, [&](gt::shape_type<N>& t) {
+    for (int t0 = 0; t0 < ntiles[0]; t0++) {
+      t[0] = t0;
+      gt::shape_type<N> lo, extent;
+      index_type offset = 0;
+      for (int d = 0; d < N; d++) {
+        lo[d] = t[d] * tile_shape[d];
+        extent[d] = std::min(tile_shape[d], shape[d] - lo[d]);
+        offset += t[d] * tile_strides[d];
+      }
+      for_each_row(extent, [&](gt::shape_type<N>& l) {
+        gt::shape_type<N> idx;
+        index_type row = offset;
+        idx[0] = lo[0];
+        for (int d = 1; d < N; d++) {
+          idx[d] = lo[d] + l[d];
+          row += l[d] * index_type_::local_stride(d);
+        }
+        f(idx, row, extent[0]);
+      });
+    }
+  });
+}
+
+} // namespace detail
+
+// ======================================================================
+// gtiled
+//
+// Common base of gtensor_tiled, which owns its storage, and
+// gtensor_tiled_span, its kernel type. Both are host expressions that mix with
+// any other expression of the same shape, and can be viewed. Assignments to
+// layout::tiled, and from it to anything else, run tile by tile, so the tiled
+// side is accessed sequentially and the other side one tile at a time.
+
+template <typename D>
+class gtiled : public expression<D>
+{
+public:
+  using base_type = expression<D>;
+  using inner_types = gtensor_inner_types<D>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+  using layout_type = typename inner_types::layout_type;
+
+  constexpr static size_type dimension() { return inner_types::dimension; }
+  using shape_type = gt::shape_type<dimension()>;
+  using tiled_index_type = detail::tiled_index<layout_type, dimension()>;
+
+  using base_type::derived;
+
+  gtiled() = default;
+  GT_INLINE gtiled(const shape_type& shape)
+    : shape_(shape), index_(tiled_index_type(shape))
+  {}
+
+  GT_INLINE const shape_type& shape() const { return shape_; }
+  GT_INLINE int shape(int i) const { return shape_[i]; }
+  GT_INLINE size_type size() const { return calc_size(shape_); }
+  GT_INLINE const tiled_index_type& index() const { return index_; }
+
+  template <typename... Args>
+  GT_INLINE decltype(auto) operator()(Args... args) const
+  {
+    return derived().data()[index_(args...)];
+  }
+  template <typename... Args>
+  GT_INLINE decltype(auto) operator()(Args... args)
+  {
+    return derived().data()[index_(args...)];
+  }
+
+  template <typename E>
+  D& operator=(const expression<E>& e);
+
+  void fill(const value_type v)
+  {
+    std::fill(derived().data(), derived().data() + index_.storage_size(), v);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &
+  {
+    return gt::view(derived(), std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(derived(), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "t" << dimension() << "<" << get_type_name<value_type>() << ">"
+      << shape();
+    return s.str();
+  }
+
+private:
+  shape_type shape_;
+  tiled_index_type index_;
+};
+
+namespace detail
+{
+
+// lhs = rhs, broadcasting the size one dimensions of rhs by indexing them at
+// 0, as gtiled isn't strided
+template <typename E1, typename E2>
+inline void assign_broadcast(E1& lhs, const E2& rhs)
+{
+  auto shape = lhs.shape();
+  auto rhs_shape = rhs.shape();
+  for_each_row(shape, [&](gt::shape_type<expr_dimension<E1>()>& idx) {
+    auto rhs_idx = idx;
+    for (int d = 1; d < expr_dimension<E1>(); d++) {
+      if (rhs_shape[d] == 1) {
+        rhs_idx[d] = 0;
+      }
+    }
+    for (int i = 0; i < shape[0]; i++) {
+      idx[0] = i;
+      rhs_idx[0] = rhs_shape[0] == 1 ? 0 : i;
+      index_expression(lhs, idx) = index_expression(rhs, rhs_idx);
+    }
+  });
+}
+
+template <typename D, typename E, int... Tile>
+inline void assign_tiled(D& lhs, const E& rhs, layout::tiled<Tile...>)
+{
+  auto* data = lhs.data();
+  for_each_tile_row(lhs.shape(), lhs.index(),
+                    [&](gt::shape_type<D::dimension()>& idx,
+                        index_type offset, int n) {
+                      const int i0 = idx[0];
+                      for (int i = 0; i < n; i++) {
+                        idx[0] = i0 + i;
+                        data[offset + i] = index_expression(rhs, idx);
+                      }
+                    });
+}
+
+template <typename D, typename E>
+inline void assign_tiled(D& lhs, const E& rhs, layout::morton)
+{
+  auto shape = lhs.shape();
+  for_each_row(shape, [&](gt::shape_type<D::dimension()>& idx) {
+    for (int i = 0; i < shape[0]; i++) {
+      idx[0] = i;
+      index_expression(lhs, idx) = index_expression(rhs, idx);
+    }
+  });
+}
+
+template <typename E, typename D, int... Tile>
+inline void assign_from_tiled(E& lhs, const D& rhs, layout::tiled<Tile...>)
+{
+  const auto* data = rhs.data();
+  for_each_tile_row(rhs.shape(), rhs.index(),
+                    [&](gt::shape_type<D::dimension()>& idx,
+                        index_type offset, int n) {
+                      const int i0 = idx[0];
+                      for (int i = 0; i < n; i++) {
+                        idx[0] = i0 + i;
+                        index_expression(lhs, idx) = data[offset + i];
+                      }
+                    });
+}
+
+template <typename E, typename D>
+inline void assign_from_tiled(E& lhs, const D& rhs, layout::morton)
+{
+  assigner<D::dimension(), space::host>::run(lhs, rhs, gt::stream_view{});
+}
+
+template <typename E, typename D>
+inline void assign_from_tiled(E& lhs, const D& rhs)
+{
+  static_assert(expr_dimension<E>() == D::dimension(),
+                "cannot assign expressions of different dimension");
+  valid_assign_broadcast_or_throw(lhs.shape(), rhs.shape());
+  if (lhs.shape() != rhs.shape()) {
+    assign_broadcast(lhs, rhs);
+  } else {
+    assign_from_tiled(lhs, rhs, typename D::layout_type{});
+  }
+}
+
+} // namespace detail
+
+template <typename D>
+template <typename E>
+inline D& gtiled<D>::operator=(const expression<E>& e)
+{
+  static_assert(dimension() == expr_dimension<E>(),
+                "cannot assign expressions of different dimension");
+  detail::valid_assign_broadcast_or_throw(shape(), e.derived().shape());
+  if (shape() != e.derived().shape()) {
+    detail::assign_broadcast(derived(), e.derived());
+  } else {
+    detail::assign_tiled(derived(), e.derived(), layout_type{});
+  }
+  return derived();
+}
+
+// ======================================================================
+// gtensor_tiled_span
+
+template <typename T, size_type N, typename L>
+class gtensor_tiled_span;
+
+template <typename T, size_type N, typename L>
+struct gtensor_inner_types<gtensor_tiled_span<T, N, L>>
+{
+  using space_type = space::host;
+  constexpr static size_type dimension = N;
+  using layout_type = L;
+
+  using value_type = T;
+  using reference = T&;
+  using const_reference = T&;
+};
+
+template <typename T, size_type N, typename L>
+class gtensor_tiled_span : public gtiled<gtensor_tiled_span<T, N, L>>
+{
+public:
+  using self_type = gtensor_tiled_span<T, N, L>;
+  using base_type = gtiled<self_type>;
+  using typename base_type::shape_type;
+  using pointer = T*;
+
+  using base_type::operator=;
+
+  GT_INLINE gtensor_tiled_span(pointer data, const shape_type& shape)
+    : base_type(shape), data_(data)
+  {}
+  gtensor_tiled_span(const gtensor_tiled_span&) = default;
+
+  self_type& operator=(const self_type& other)
+  {
+    return base_type::operator=(other);
+  }
+
+  self_type to_kernel() const { return *this; }
+
+  GT_INLINE pointer data() const { return data_; }
+
+private:
+  pointer data_;
+};
+
+// ======================================================================
+// gtensor_tiled
+
+template <typename T, size_type N, typename L>
+class gtensor_tiled;
+
+template <typename T, size_type N, typename L>
+struct gtensor_inner_types<gtensor_tiled<T, N, L>>
+{
+  using space_type = space::host;
+  constexpr static size_type dimension = N;
+  using layout_type = L;
+
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+};
+
+template <typename T, size_type N, typename L>
+class gtensor_tiled : public gtiled<gtensor_tiled<T, N, L>>
+{
+public:
+  using self_type = gtensor_tiled<T, N, L>;
+  using base_type = gtiled<self_type>;
+  using typename base_type::shape_type;
+  using typename base_type::value_type;
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  using kernel_type = gtensor_tiled_span<T, N, L>;
+  using const_kernel_type = gtensor_tiled_span<const T, N, L>;
+
+  using base_type::operator=;
+
+  gtensor_tiled() = default;
+  explicit gtensor_tiled(const shape_type& shape)
+    : base_type(shape), storage_(this->index().storage_size())
+  {}
+  gtensor_tiled(const shape_type& shape, const value_type v)
+    : gtensor_tiled(shape)
+  {
+    this->fill(v);
+  }
+  template <typename E>
+  gtensor_tiled(const expression<E>& e) : gtensor_tiled(e.derived().shape())
+  {
+    *this = e.derived();
+  }
+
+  // resizes to the shape of e, like gtensor
+  template <typename E>
+  self_type& operator=(const expression<E>& e)
+  {
+    if (e.derived().shape() != this->shape()) {
+      *this = self_type(e.derived().shape());
+    }
+    return base_type::operator=(e);
+  }
+
+  const_kernel_type to_kernel() const
+  {
+    return const_kernel_type(data(), this->shape());
+  }
+  kernel_type to_kernel() { return kernel_type(data(), this->shape()); }
+
+  const_pointer data() const { return storage_.data(); }
+  pointer data() { return storage_.data(); }
+
+private:
+  space::host_vector<T> storage_;
+};
+
+// ======================================================================
+// assign from tiled
+//
+// Converting to column-major, or any other lhs, tile by tile. Also takes care
+// of broadcasting from gtiled, which the generic assign can't do as it isn't
+// strided.
+
+template <typename E1, typename T, size_type N, typename L>
+void assign(E1& lhs, const gtensor_tiled<T, N, L>& rhs,
+            gt::stream_view stream = gt::stream_view())
+{
+  detail::assign_from_tiled(lhs, rhs);
+}
+
+template <typename E1, typename T, size_type N, typename L>
+void assign(E1& lhs, const gtensor_tiled_span<T, N, L>& rhs,
+            gt::stream_view stream = gt::stream_view())
+{
+  detail::assign_from_tiled(lhs, rhs);
+}
+
+// ======================================================================
+// launch in tile order
+
+namespace detail
+{
+
+template <int N, int... Tile>
+struct layout_launch<N, space::host, layout::tiled<Tile...>>
+{
+  template <typename F>
+  static void run(const gt::shape_type<N>& shape, F&& f, gt::stream_view stream)
+  {
+    tiled_index<layout::tiled<Tile...>, N> index(shape);
+    for_each_tile_row(shape, index,
+                      [&](gt::shape_type<N>& idx, index_type, int n) {
+                        const int i0 = idx[0];
+                        for (int i = 0; i < n; i++) {
+                          idx[0] = i0 + i;
+                          index_expression(f, idx);
+                        }
+                      });
+  }
+};
+
+} // namespace detail
+
+// ======================================================================
+// tile_span
+//
+// tile_span<T, H, Tile...>(data, tile_strides) accesses the storage tile of
+// layout::tiled<Tile...> at data with indices local to the tile, through
+// strides that are compile-time constants. With H > 0, indices may reach up
+// to H points past the ends of the tile, into the neighboring tiles, which
+// are tile_strides away. That is computed without branches, so in loops
+// along the first dimension it's invariant for the other indices; the first
+// index itself is only wrapped within H of the ends of a row, see
+// launch_tiles.
+
+template <typename T, int H, int... Tile>
+class tile_span
+{
+public:
+  constexpr static size_type dimension() { return sizeof...(Tile); }
+
+  GT_INLINE tile_span(T* data,
+                      const gt::strides_type<dimension()>& tile_strides)
+    : data_(data), tile_strides_(tile_strides)
+  {
+    static_assert(std::min({Tile...}) >= H,
+                  "tile_span: halo wider than the tile");
+  }
+
+  template <typename... Args>
+  GT_INLINE T& operator()(Args... args) const
+  {
+    static_assert(sizeof...(Args) == dimension(),
+                  "tile_span: wrong number of indices");
+    return data_[offset(std::true_type{},
+                        std::make_index_sequence<dimension()>(), args...)];
+  }
+
+  GT_INLINE constexpr static int extent(int d)
+  {
+    const int tiles[] = {Tile...};
+    return tiles[d];
+  }
+
+  GT_INLINE constexpr static index_type stride(int d)
+  {
+    const int tiles[] = {Tile...};
+    index_type stride = 1;
+    for (int i = 0; i < d; i++) {
+      stride *= tiles[i];
+    }
+    return stride;
+  }
+
+protected:
+  // with Wrap0 false, the first index is inside of the tile
+  template <bool Wrap0, size_type... D, typename... I>
+  GT_INLINE index_type offset(std::integral_constant<bool, Wrap0>,
+                              std::index_sequence<D...>, I... idx) const
+  {
+    const index_type terms[] = {local_offset<D>(idx, Wrap0 || D > 0)...};
+    index_type offset = 0;
+    for (auto term : terms) {
+      offset += term;
+    }
+    return offset;
+  }
+
+  template <size_type D>
+  GT_INLINE index_type local_offset(int idx, bool wrap) const
+  {
+    constexpr int tile = extent(D);
+    constexpr index_type stride = tile_span::stride(D);
+    if (H == 0 || !wrap) {
+      return idx * stride;
+    }
+    // -1, 0, 1 for the previous, this, the next tile, without branches
+    const int t = int(idx >= tile) - int(idx < 0);
+    return (idx - t * tile) * stride + t * tile_strides_[D];
+  }
+
+  T* data_;
+  gt::strides_type<dimension()> tile_strides_;
+};
+
+namespace detail
+{
+
+// a tile_span for indices whose first dimension stays inside of the tile, so
+// that loops along it vectorize
+
+template <typename T, int H, int... Tile>
+class tile_row_span : public tile_span<T, H, Tile...>
+{
+  using base_type = tile_span<T, H, Tile...>;
+
+public:
+  using base_type::base_type;
+
+  template <typename... Args>
+  GT_INLINE T& operator()(Args... args) const
+  {
+    return this->data_[this->offset(
+      std::false_type{}, std::make_index_sequence<sizeof...(Tile)>(),
+      args...)];
+  }
+};
+
+template <typename F, typename O, typename A, size_type N, size_type... D>
+GT_INLINE void launch_tile_row(F& f, const O& o, const A& a, int begin,
+                               int end, const gt::shape_type<N>& idx,
+                               std::index_sequence<D...>)
+{
+  for (int i = begin; i < end; i++) {
+    f(o, a, i, idx[D + 1]...);
+  }
+}
+
+} // namespace detail
+
+// ======================================================================
+// launch_tiles
+//
+// launch_tiles<H>(out, in, lo, hi, f) calls f(o, a, i, j, ...) for the
+// points lo <= idx < hi of out, one storage tile of layout::tiled at a time,
+// with indices local to the tile: o is the tile of out, and a the same tile
+// of in, which f can read from a(i - H, ...) to a(i + H, ...). Both are read
+// and written in place, through tile_spans, so the loops over a tile need no
+// tiled_index and vectorize, unlike per-element access through
+// gtensor_tiled's operator(), and in is streamed through once, as in a
+// column-major sweep; only the halos are read from the neighboring tiles.
+// [lo, hi) has to keep the reads inside of in, e.g., lo = H, hi = shape - H.
+
+template <int H, typename T, typename U, size_type N, int... Tile, typename F>
+inline void launch_tiles(gtensor_tiled<T, N, layout::tiled<Tile...>>& out,
+                         const gtensor_tiled<U, N, layout::tiled<Tile...>>& in,
+                         const gt::shape_type<N>& lo,
+                         const gt::shape_type<N>& hi, F&& f)
+{
+  if (out.shape() != in.shape()) {
+    throw std::runtime_error("gt::launch_tiles: shapes of out " +
+                             to_string(out.shape()) + " and in " +
+                             to_string(in.shape()) + " differ");
+  }
+  const gt::shape_type<N> tile_shape(Tile...);
+  const auto& ntiles = out.index().ntiles();
+  const auto& tile_strides = out.index().tile_strides();
+
+  detail::for_each_row(ntiles, [&](gt::shape_type<N>& t) {
+    for (int t0 = 0; t0 < ntiles[0]; t0++) {
+      t[0] = t0;
+      gt::shape_type<N> begin, extent;
+      index_type offset = 0;
+      bool empty = false;
+      for (int d = 0; d < N; d++) {
+        const int t_lo = t[d] * tile_shape[d];
+        begin[d] = std::max(lo[d] - t_lo, 0);
+        const int end = std::min(hi[d] - t_lo, tile_shape[d]);
+        extent[d] = end - begin[d];
+        empty = empty || extent[d] <= 0;
+        offset += t[d] * tile_strides[d];
+      }
+      if (empty) {
+        continue;
+      }
+      const tile_span<T, 0, Tile...> o(out.data() + offset, tile_strides);
+      const tile_span<const U, H, Tile...> a(in.data() + offset, tile_strides);
+      const detail::tile_row_span<const U, H, Tile...> a_row(
+        in.data() + offset, tile_strides);
+      // the points within H of the ends of a row read past the tile in the
+      // first dimension
+      const int i_begin = begin[0], i_end = begin[0] + extent[0];
+      const int inner_begin = std::min(std::max(i_begin, H), i_end);
+      const int inner_end =
+        std::max(std::min(i_end, tile_shape[0] - H), inner_begin);
+      const auto rest = std::make_index_sequence<N - 1>();
+      extent[0] = 1;
+      detail::for_each_row(extent, [&](const gt::shape_type<N>& l) {
+        gt::shape_type<N> idx;
+        for (int d = 0; d < N; d++) {
+          idx[d] = begin[d] + l[d];
+        }
+        detail::launch_tile_row(f, o, a, i_begin, inner_begin, idx, rest);
+        detail::launch_tile_row(f, o, a_row, inner_begin, inner_end, idx,
+                                rest);
+        detail::launch_tile_row(f, o, a, inner_end, i_end, idx, rest);
+      });
+    }
+  });
+}
+
+} // namespace gt
+
+#endif // GTENSOR_GTENSOR_TILED_H
@@ -3,12 +3,14 @@
 #define GTENSOR_GVIEW_H
 
 #include <sstream>
+#include <stdexcept>
 
 #include "assign.h"
 #include "defs.h"
 #include "expression.h"
 #include "gslice.h"
 #include "helper.h"
+#include "layout.h"
 #include "meta.h"
 
 namespace gt
@@ -26,6 +28,8 @@ class gview_adaptor
 public:
   using space_type = expr_space_type<E>;
   using shape_type = expr_shape_type<E>;
+  using strides_type = gt::strides_type<shape_type::dimension>;
+  using unravel_strides_type = gt::unravel_strides<shape_type::dimension>;
 
   using inner_expression_type = std::decay_t<E>;
   using value_type = typename inner_expression_type::value_type;
@@ -33,11 +37,11 @@ public:
   using const_reference = typename inner_expression_type::const_reference;
 
   gview_adaptor(E&& e)
-    : e_(std::forward<E>(e)), strides_(calc_strides(e.shape()))
+    : e_(std::forward<E>(e)), strides_(e.shape())
   {}
 
   GT_INLINE shape_type shape() const { return e_.shape(); }
-  GT_INLINE shape_type strides() const { return strides_; }
+  GT_INLINE strides_type strides() const { return strides_.strides(); }
 
   decltype(auto) to_kernel() const
   {
@@ -57,19 +61,22 @@ public:
 
   GT_INLINE decltype(auto) data_access(size_type i) const
   {
-    shape_type idx = unravel(i, strides_);
+    shape_type idx = strides_.unravel(i);
     return access(std::make_index_sequence<idx.size()>(), idx);
   }
 
   GT_INLINE decltype(auto) data_access(size_type i)
   {
-    shape_type idx = unravel(i, strides_);
+    shape_type idx = strides_.unravel(i);
     return access(std::make_index_sequence<idx.size()>(), idx);
   }
 
   inline std::string typestr() const& { return e_.typestr(); }
 
 private:
+  template <typename E1, typename Enable>
+  friend struct maybe_data_strided;
+
   template <size_type... I>
   GT_INLINE decltype(auto) access(std::index_sequence<I...>,
                                   const shape_type& idx) const
@@ -84,8 +91,102 @@ private:
     return e_(idx[I]...);
   }
 
+  friend struct kernel_transform;
+
   E e_;
-  shape_type strides_;
+  unravel_strides_type strides_;
+};
+
+// ----------------------------------------------------------------------
+// reshape_adaptor
+//
+// Like gview_adaptor, for reshaping strided expressions whose strides can't
+// simply be replaced, i.e., views and containers in other layouts. If the
+// strides of e allow it (see calc_reshape_strides), the reshaped gview gets
+// strides into the storage of e and the adaptor passes its indices straight
+// through. Only otherwise does it unravel them into indices of e.
+
+template <typename E>
+class reshape_adaptor
+{
+public:
+  using space_type = expr_space_type<E>;
+  using shape_type = expr_shape_type<E>;
+  using strides_type = gt::strides_type<shape_type::dimension>;
+  using unravel_strides_type = gt::unravel_strides<shape_type::dimension>;
+
+  using inner_expression_type = std::decay_t<E>;
+  using value_type = typename inner_expression_type::value_type;
+  using reference = typename inner_expression_type::reference;
+  using const_reference = typename inner_expression_type::const_reference;
+
+  reshape_adaptor(E&& e, bool strided)
+    : e_(std::forward<E>(e)), strides_(e.shape()), strided_(strided)
+  {}
+
+  GT_INLINE shape_type shape() const { return e_.shape(); }
+  GT_INLINE strides_type strides() const { return strides_.strides(); }
+  GT_INLINE bool strided() const { return strided_; }
+
+  decltype(auto) to_kernel() const
+  {
+    auto k_e_ = e_.to_kernel();
+    using kernel_type = decltype(k_e_);
+    return reshape_adaptor<kernel_type>(std::forward<kernel_type>(k_e_),
+                                        strided_);
+  }
+
+  decltype(auto) to_kernel()
+  {
+    auto k_e_ = e_.to_kernel();
+    using kernel_type = decltype(k_e_);
+    return reshape_adaptor<kernel_type>(std::forward<kernel_type>(k_e_),
+                                        strided_);
+  }
+
+  GT_INLINE size_type size() const { return e_.size(); };
+
+  GT_INLINE decltype(auto) data_access(size_type i) const
+  {
+    if (strided_) {
+      return e_.data_access(i);
+    }
+    shape_type idx = strides_.unravel(i);
+    return access(std::make_index_sequence<idx.size()>(), idx);
+  }
+
+  GT_INLINE decltype(auto) data_access(size_type i)
+  {
+    if (strided_) {
+      return e_.data_access(i);
+    }
+    shape_type idx = strides_.unravel(i);
+    return access(std::make_index_sequence<idx.size()>(), idx);
+  }
+
+  inline std::string typestr() const& { return e_.typestr(); }
+
+private:
+  template <typename E1, typename Enable>
+  friend struct maybe_data_strided;
+
+  template <size_type... I>
+  GT_INLINE decltype(auto) access(std::index_sequence<I...>,
+                                  const shape_type& idx) const
+  {
+    return e_(idx[I]...);
+  }
+
+  template <size_type... I>
+  GT_INLINE decltype(auto) access(std::index_sequence<I...>,
+                                  const shape_type& idx)
+  {
+    return e_(idx[I]...);
+  }
+
+  E e_;
+  unravel_strides_type strides_;
+  bool strided_;
 };
 
 } // namespace detail
@@ -123,6 +224,23 @@ constexpr bool is_data_stride_expr()
   return is_gcontainer<E>::value || is_gtensor_span<E>::value;
 }
 
+template <typename E, typename Enable = void>
+struct is_index_order_container : std::false_type
+{};
+
+template <typename E>
+struct is_index_order_container<E, std::enable_if_t<is_gcontainer<E>::value>>
+  : std::is_same<typename std::decay_t<E>::layout_type, layout::column_major>
+{};
+
+// spans, and containers stored in index order, are reshaped by replacing
+// their strides
+template <typename E>
+constexpr bool is_reshape_direct_expr()
+{
+  return is_index_order_container<E>::value || is_gtensor_span<E>::value;
+}
+
 /*
 template <typename E>
 struct is_data_stride_expr : std::false_type
@@ -133,14 +251,14 @@ struct is_data_stride_expr<gtensor_span<T, N, S>> : std::true_type
 {};
 */
 
-// gcontainers and gtensor_spans have the default stride and layout, so they
-// are safe to override without layering via an adaptor
+// other strided expressions keep their strides when they can, see
+// reshape_adaptor
 template <typename E>
 struct select_reshape_gview_adaptor<
-  E, gt::meta::void_t<
-       std::enable_if_t<is_gcontainer<E>::value || is_gtensor_span<E>::value>>>
+  E, gt::meta::void_t<decltype(std::declval<E>().strides())>>
 {
-  using type = E;
+  using type =
+    std::conditional_t<is_reshape_direct_expr<E>(), E, reshape_adaptor<E>>;
 };
 
 } // namespace detail
@@ -158,6 +276,47 @@ using select_reshape_gview_adaptor_t =
 template <typename EC, size_type N>
 class gview;
 
+namespace detail
+{
+
+// see assign.h
+template <typename E>
+struct is_data_strided<
+  E, std::enable_if_t<is_gcontainer<E>::value || is_gtensor_span<E>::value>>
+  : std::true_type
+{};
+
+template <typename EC, size_type N>
+struct is_data_strided<gview<EC, N>> : is_data_strided<std::decay_t<EC>>
+{};
+
+// a reshape that kept the strides of a data strided expression is data
+// strided, too, so the odometer's strided paths take it after checking
+template <typename E>
+struct maybe_data_strided<reshape_adaptor<E>>
+{
+  using inner = maybe_data_strided<std::decay_t<E>>;
+
+  static constexpr bool value = inner::value;
+
+  static bool check(const reshape_adaptor<E>& e)
+  {
+    return e.strided() && inner::check(e.e_);
+  }
+};
+
+template <typename EC, size_type N>
+struct maybe_data_strided<gview<EC, N>>
+{
+  using inner = maybe_data_strided<std::decay_t<EC>>;
+
+  static constexpr bool value = inner::value;
+
+  static bool check(const gview<EC, N>& e) { return inner::check(e.e_); }
+};
+
+} // namespace detail
+
 template <typename EC, size_type N>
 struct gtensor_inner_types<gview<EC, N>>
 {
@@ -240,6 +399,9 @@ private:
   size_type offset_;
 
   friend class gstrided<self_type>;
+  friend struct detail::kernel_transform;
+  template <typename E, typename Enable>
+  friend struct detail::maybe_data_strided;
 
   template <typename S, size_type... I>
   GT_INLINE decltype(auto) access(std::index_sequence<I...>, const S& idx) const
@@ -360,8 +522,8 @@ namespace detail
 template <size_type OldN, size_type NewN>
 inline void calc_view(const std::vector<gdesc>& descs,
                       const shape_type<OldN>& old_shape,
-                      const shape_type<OldN>& old_strides,
-                      shape_type<NewN>& shape, shape_type<NewN>& strides,
+                      const strides_type<OldN>& old_strides,
+                      shape_type<NewN>& shape, strides_type<NewN>& strides,
                       size_type& offset)
 {
   offset = 0;
@@ -457,7 +619,8 @@ auto view(E&& _e, const std::vector<gdesc>& descs)
   EC e(std::forward<E>(_e));
 
   size_type offset;
-  gt::shape_type<N> shape, strides;
+  gt::shape_type<N> shape;
+  gt::strides_type<N> strides;
   detail::calc_view(descs, e.shape(), e.strides(), shape, strides, offset);
 
   return gview<EC, N>(std::forward<EC>(e), offset, shape, strides);
@@ -476,7 +639,8 @@ template <size_type N, typename E,
 auto view_strided(E& e, const std::vector<gdesc>& descs)
 {
   size_type offset;
-  gt::shape_type<N> shape, strides;
+  gt::shape_type<N> shape;
+  gt::strides_type<N> strides;
   detail::calc_view(descs, e.shape(), e.strides(), shape, strides, offset);
 
   return gtensor_span<expr_value_type<E>, N, expr_space_type<E>>(
@@ -494,7 +658,16 @@ auto view_strided(E& e, Args&&... args)
 // ======================================================================
 // reshape
 //
-//
+// reshape(e, shape) is e with the same elements in (column-major) index
+// order, but the given shape, where one extent can be -1 to have it
+// calculated. It doesn't copy: containers and spans get new strides into
+// the same data. So do views and other strided expressions as long as the
+// dimensions that get merged or split are laid out contiguously with
+// respect to each other, e.g. any reshape of a contiguous view, or merging
+// the last two dimensions of a(_s(1, -1), _all, _all). Only otherwise is
+// each index unravelled into one of e. Spans whose strides don't allow the
+// reshape can't be adapted, and throw.
+
 namespace detail
 {
 
@@ -522,30 +695,150 @@ inline void calc_reshape(const shape_type<OldN>& old_shape,
   assert(calc_size(shape) == old_size);
 }
 
+// Calculates the strides for shape that address the elements of old_shape,
+// old_strides in the same order, if possible. Size one dimensions aside, the
+// old and new dimensions split into the smallest groups with equal products,
+// and each group of old dimensions has to be contiguous in itself.
+template <size_type OldN, size_type NewN>
+inline bool calc_reshape_strides(const shape_type<OldN>& old_shape,
+                                 const strides_type<OldN>& old_strides,
+                                 const shape_type<NewN>& shape,
+                                 strides_type<NewN>& strides)
+{
+  if (calc_size(shape) == 0) {
+    strides = calc_strides(shape);
+    return true;
+  }
+
+  int old_dims[OldN + 1] = {};
+  index_type old_dim_strides[OldN + 1] = {};
+  int n_old = 0;
+  for (int d = 0; d < OldN; d++) {
+    if (old_shape[d] != 1) {
+      old_dims[n_old] = old_shape[d];
+      old_dim_strides[n_old] = old_strides[d];
+      n_old++;
+    }
+  }
+  int new_dims[NewN + 1] = {};
+  index_type new_dim_strides[NewN + 1] = {};
+  int n_new = 0;
+  for (int d = 0; d < NewN; d++) {
+    if (shape[d] != 1) {
+      new_dims[n_new++] = shape[d];
+    }
+  }
+
+  int oi = 0, ni = 0;
+  while (oi < n_old && ni < n_new) {
+    int oj = oi + 1, nj = ni + 1;
+    size_type old_prod = old_dims[oi], new_prod = new_dims[ni];
+    while (old_prod != new_prod) {
+      if (old_prod < new_prod && oj < n_old) {
+        old_prod *= old_dims[oj++];
+      } else if (new_prod < old_prod && nj < n_new) {
+        new_prod *= new_dims[nj++];
+      } else {
+        // the sizes don't match
+        return false;
+      }
+    }
+    for (int k = oi; k < oj - 1; k++) {
+      if (old_dim_strides[k + 1] != old_dim_strides[k] * old_dims[k]) {
+        return false;
+      }
+    }
+    new_dim_strides[ni] = old_dim_strides[oi];
+    for (int k = ni + 1; k < nj; k++) {
+      new_dim_strides[k] = new_dim_strides[k - 1] * new_dims[k - 1];
+    }
+    oi = oj;
+    ni = nj;
+  }
+  if (oi != n_old || ni != n_new) {
+    return false;
+  }
+
+  for (int d = 0, k = 0; d < NewN; d++) {
+    strides[d] = shape[d] == 1 ? 0 : new_dim_strides[k++];
+  }
+  return true;
+}
+
+template <typename E, size_type N>
+inline strides_type<N> reshape_strides_or_throw(const E& e,
+                                                const shape_type<N>& shape)
+{
+  strides_type<N> strides;
+  if (!calc_reshape_strides(e.shape(), e.strides(), shape, strides)) {
+    throw std::runtime_error("reshape: can't reshape " + to_string(e.shape()) +
+                             " with strides " + to_string(e.strides()) +
+                             " to " + to_string(shape) + " without a copy");
+  }
+  return strides;
+}
+
+template <typename EC>
+struct reshape_impl
+{
+  // EC replaces its strides
+  template <size_type N, typename E>
+  static auto run(E&& _e, const gt::shape_type<N>& shape)
+  {
+    EC e(std::forward<E>(_e));
+    auto strides = reshape_strides_or_throw(e, shape);
+    return gview<EC, N>(std::forward<EC>(e), 0, shape, strides);
+  }
+};
+
+template <typename E1>
+struct reshape_impl<gview_adaptor<E1>>
+{
+  template <size_type N, typename E>
+  static auto run(E&& _e, const gt::shape_type<N>& shape)
+  {
+    using EC = gview_adaptor<E1>;
+    EC e(std::forward<E>(_e));
+    return gview<EC, N>(std::forward<EC>(e), 0, shape, calc_strides(shape));
+  }
+};
+
+template <typename E1>
+struct reshape_impl<reshape_adaptor<E1>>
+{
+  template <size_type N, typename E>
+  static auto run(E&& _e, const gt::shape_type<N>& shape)
+  {
+    using EC = reshape_adaptor<E1>;
+    gt::strides_type<N> strides;
+    bool strided =
+      calc_reshape_strides(_e.shape(), _e.strides(), shape, strides);
+    if (!strided) {
+      strides = calc_strides(shape);
+    }
+    EC e(std::forward<E>(_e), strided);
+    return gview<EC, N>(std::forward<EC>(e), 0, shape, strides);
+  }
+};
+
 } // namespace detail
 
 template <size_type N, typename E, typename = void>
-inline auto reshape(E&& _e, gt::shape_type<N> shape)
+inline auto reshape(E&& e, gt::shape_type<N> shape)
 {
-  // Note: use gview adapter more broadly, in particular for nested views,
-  // since this routine simply replaces strides. The adapter is not needed
-  // for containers and spans, because their data layout implicitly encodes
-  // their striding. gviews on the other hand, do require an adapter.
   using EC = select_reshape_gview_adaptor_t<E>;
-
-  EC e(std::forward<E>(_e));
-
   detail::calc_reshape(e.shape(), shape);
-
-  return gview<EC, N>(std::forward<EC>(e), 0, shape, calc_strides(shape));
+  return detail::reshape_impl<EC>::run(std::forward<E>(e), shape);
 }
 
 template <size_type N, typename E,
-          typename = std::enable_if_t<detail::is_data_stride_expr<E>()>>
+          typename = std::enable_if_t<detail::is_reshape_direct_expr<E>()>>
 inline auto reshape(E& e, gt::shape_type<N> shape)
 {
   detail::calc_reshape(e.shape(), shape);
-  return adapt<N, expr_space_type<E>>(e.data(), shape);
+  using span_type = decltype(adapt<N, expr_space_type<E>>(e.data(), shape));
+  return span_type(e.data(), shape,
+                   detail::reshape_strides_or_throw(e, shape));
 }
 
 // ======================================================================
@@ -607,10 +900,10 @@ inline decltype(auto) flatten(E& e)
 namespace detail
 {
 
-template <typename Shape>
+template <typename Shape, typename Strides>
 inline void calc_swapaxes(int axis1, int axis2, const Shape& old_shape,
-                          const Shape& old_strides, Shape& shape,
-                          Shape& strides)
+                          const Strides& old_strides, Shape& shape,
+                          Strides& strides)
 {
   for (int d = 0; d < shape.size(); d++) {
     if (d == axis1) {
@@ -637,7 +930,7 @@ inline auto swapaxes(E&& _e, int axis1, int axis2)
 
   constexpr int N = expr_dimension<E>();
   expr_shape_type<E> shape;
-  expr_shape_type<E> strides;
+  gt::strides_type<expr_dimension<E>()> strides;
 
   detail::calc_swapaxes(axis1, axis2, e.shape(), e.strides(), shape, strides);
 
@@ -653,7 +946,7 @@ inline auto swapaxes(E& e, int axis1, int axis2)
 {
   constexpr int N = expr_dimension<E>();
   expr_shape_type<E> shape;
-  expr_shape_type<E> strides;
+  gt::strides_type<expr_dimension<E>()> strides;
 
   detail::calc_swapaxes(axis1, axis2, e.shape(), e.strides(), shape, strides);
 
@@ -667,11 +960,21 @@ inline auto swapaxes(E& e, int axis1, int axis2)
 namespace detail
 {
 
-template <typename Shape>
+template <typename Shape, typename Strides>
 inline void calc_transpose(const Shape& axes, const Shape& old_shape,
-                           const Shape& old_strides, Shape& shape,
-                           Shape& strides)
+                           const Strides& old_strides, Shape& shape,
+                           Strides& strides)
 {
+  Shape count;
+  for (int d = 0; d < shape.size(); d++) {
+    count[d] = 0;
+  }
+  for (int d = 0; d < shape.size(); d++) {
+    if (axes[d] < 0 || axes[d] >= shape.size() || count[axes[d]]++ > 0) {
+      throw std::runtime_error("transpose: axes " + to_string(axes) +
+                               " are not a permutation");
+    }
+  }
   for (int d = 0; d < shape.size(); d++) {
     shape[d] = old_shape[axes[d]];
     strides[d] = old_strides[axes[d]];
@@ -689,11 +992,10 @@ inline auto transpose(E&& _e, expr_shape_type<E> axes)
 
   constexpr int N = expr_dimension<E>();
   expr_shape_type<E> shape;
-  expr_shape_type<E> strides;
+  gt::strides_type<expr_dimension<E>()> strides;
   detail::calc_transpose(axes, e.shape(), e.strides(), shape, strides);
 
-  // FIXME, could use sanity checks
-  return gview<EC, N>(std::forward<E>(e), 0, shape, strides);
+  return gview<EC, N>(std::forward<EC>(e), 0, shape, strides);
 }
 
 template <typename E,
@@ -701,13 +1003,40 @@ template <typename E,
 inline auto transpose(E& e, expr_shape_type<E> axes)
 {
   expr_shape_type<E> shape;
-  expr_shape_type<E> strides;
+  gt::strides_type<expr_dimension<E>()> strides;
   detail::calc_transpose(axes, e.shape(), e.strides(), shape, strides);
 
   return gtensor_span<expr_value_type<E>, expr_dimension<E>(),
                       expr_space_type<E>>(e.data(), shape, strides);
 }
 
+// reverses the order of the dimensions
+template <typename E>
+inline auto transpose(E&& e)
+{
+  constexpr int N = expr_dimension<E>();
+  expr_shape_type<E> axes;
+  for (int d = 0; d < N; d++) {
+    axes[d] = N - 1 - d;
+  }
+  return transpose(std::forward<E>(e), axes);
+}
+
+// ======================================================================
+// permute_dims
+//
+// Dimension d of the result is dimension axes[d] of e, as transpose. It's
+// lazy: containers, spans and views give a span with permuted strides, other
+// expressions a view. Assigning the result of a permutation to a strided lhs
+// runs a blocked transpose where the fastest varying dimensions of lhs and rhs
+// differ, see assign.h.
+
+template <typename E>
+inline auto permute_dims(E&& e, expr_shape_type<E> axes)
+{
+  return transpose(std::forward<E>(e), axes);
+}
+
 } // namespace gt
 
 #endif
@@ -0,0 +1,180 @@
+#ifndef GTENSOR_HASH_H
+#define GTENSOR_HASH_H
+
+#include "gtensor.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace gt
+{
+
+// ======================================================================
+// hash
+//
+// 64-bit hash of the contents of an expression, taken over its elements in
+// logical (column-major) order, so a view and a container holding the same
+// values give the same hash. Elements are hashed bitwise (e.g. 0. and -0.
+// differ), and the shape is mixed in, so reshaped data hashes differently.
+//
+// The logical index space is cut into fixed size blocks that are hashed
+// independently by a kernel in the expression's space. Each block is walked
+// row by row, feeding consecutive elements of a row to several independent
+// accumulator lanes in turn. The block hashes are then combined pairwise in a
+// tree. Since the block decomposition only depends on the size, the result is
+// deterministic regardless of how blocks are scheduled. It is meant for
+// reproducibility checks and cache keys, not cryptographic use.
+
+namespace detail
+{
+
+namespace hash
+{
+
+constexpr std::uint64_t prime1 = 0x9e3779b185ebca87ull;
+constexpr std::uint64_t prime2 = 0xc2b2ae3d27d4eb4full;
+constexpr std::uint64_t prime3 = 0x165667b19e3779f9ull;
+constexpr std::uint64_t prime5 = 0x27d4eb2f165667c5ull;
+
+constexpr int n_lanes = 4;
+constexpr int block_size = 4096;
+
+GT_INLINE std::uint64_t rotl(std::uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+GT_INLINE std::uint64_t round(std::uint64_t acc, std::uint64_t word)
+{
+  return rotl(acc + word * prime2, 31) * prime1;
+}
+
+GT_INLINE std::uint64_t avalanche(std::uint64_t h)
+{
+  h ^= h >> 33;
+  h *= prime2;
+  h ^= h >> 29;
+  h *= prime3;
+  h ^= h >> 32;
+  return h;
+}
+
+GT_INLINE std::uint64_t combine(std::uint64_t a, std::uint64_t b)
+{
+  return avalanche(rotl(a, 27) * prime1 + round(prime5, b));
+}
+
+// feeds the bits of one element into a lane accumulator, 8 bytes at a time
+template <typename T>
+GT_INLINE std::uint64_t round_value(std::uint64_t acc, const T& value)
+{
+  constexpr int n_words = (sizeof(T) + 7) / 8;
+  std::uint64_t words[n_words] = {};
+  memcpy(words, &value, sizeof(T));
+  for (int w = 0; w < n_words; w++) {
+    acc = round(acc, words[w]);
+  }
+  return acc;
+}
+
+} // namespace hash
+
+} // namespace detail
+
+template <typename E>
+inline std::uint64_t hash(const E& e,
+                          gt::stream_view stream = gt::stream_view{})
+{
+  namespace h = detail::hash;
+  using S = expr_space_type<E>;
+  using T = std::decay_t<expr_value_type<E>>;
+  constexpr auto N = expr_dimension<E>();
+
+  const auto shape = e.shape();
+  const size_type size = e.size();
+  const int n_blocks = (size + h::block_size - 1) / h::block_size;
+
+  std::uint64_t result = h::prime5 + sizeof(T);
+  for (int d = 0; d < N; d++) {
+    result = h::combine(result, shape[d]);
+  }
+  if (n_blocks == 0) {
+    return h::avalanche(result);
+  }
+
+  gt::gtensor<std::uint64_t, 1, S> d_blocks(gt::shape(n_blocks));
+  auto k_blocks = d_blocks.to_kernel();
+  auto k_e = e.to_kernel();
+  auto strides = calc_strides(shape);
+
+  gt::launch<1, S>(
+    gt::shape(n_blocks),
+    GT_LAMBDA(int b) {
+      const size_type begin = size_type(b) * h::block_size;
+      const size_type end =
+        begin + h::block_size < size ? begin + h::block_size : size;
+
+      std::uint64_t lanes[h::n_lanes];
+      for (int l = 0; l < h::n_lanes; l++) {
+        lanes[l] = h::prime1 * (l + 1) + begin;
+      }
+
+      // unravel once, then walk the block row by row along the first
+      // dimension, stepping the outer dimensions like an odometer between
+      // rows. Within a row, groups of n_lanes consecutive elements go to
+      // fixed lanes, so the lane updates are independent.
+      auto idx = unravel(begin, strides);
+      for (size_type k = begin; k < end;) {
+        const int i0 = idx[0];
+        const size_type n_row = shape[0] - i0;
+        const int n = n_row < end - k ? n_row : end - k;
+        int i = 0;
+        for (; i + h::n_lanes <= n; i += h::n_lanes) {
+          for (int l = 0; l < h::n_lanes; l++) {
+            idx[0] = i0 + i + l;
+            lanes[l] = h::round_value(lanes[l], index_expression(k_e, idx));
+          }
+        }
+        for (int l = 0; i < n; i++, l++) {
+          idx[0] = i0 + i;
+          lanes[l] = h::round_value(lanes[l], index_expression(k_e, idx));
+        }
+        k += n;
+
+        idx[0] = 0;
+        for (int d = 1; d < N; d++) {
+          if (++idx[d] < shape[d]) {
+            break;
+          }
+          idx[d] = 0;
+        }
+      }
+
+      std::uint64_t acc = end - begin;
+      for (int l = 0; l < h::n_lanes; l++) {
+        acc = h::combine(acc, lanes[l]);
+      }
+      k_blocks(b) = acc;
+    },
+    stream);
+  stream.synchronize();
+
+  gt::gtensor<std::uint64_t, 1, gt::space::host> blocks(gt::shape(n_blocks));
+  gt::copy(d_blocks, blocks);
+
+  // pairwise tree reduction, an odd trailing hash moves up unchanged
+  for (int n = n_blocks; n > 1; n = (n + 1) / 2) {
+    for (int i = 0; i < n / 2; i++) {
+      blocks(i) = h::combine(blocks(2 * i), blocks(2 * i + 1));
+    }
+    if (n % 2) {
+      blocks(n / 2) = blocks(n - 1);
+    }
+  }
+
+  return h::avalanche(h::combine(result, blocks(0)));
+}
+
+} // namespace gt
+
+#endif // GTENSOR_HASH_H
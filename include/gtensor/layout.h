@@ -0,0 +1,103 @@
+#ifndef GTENSOR_LAYOUT_H
+#define GTENSOR_LAYOUT_H
+
+#include <utility>
+
+#include "defs.h"
+
+namespace gt
+{
+
+// ======================================================================
+// layout
+//
+// Layout policies decide the order in which gtensor_container stores its
+// elements:
+//
+//   layout::column_major   the first index varies fastest (the default)
+//   layout::row_major      the last index varies fastest, as in C
+//   layout::ordered<O...>  dimensions O..., fastest varying first, e.g.
+//                          ordered<1, 0, 2> for a 3-d array whose second
+//                          index varies fastest
+//
+// Indices always refer to the same elements, only the strides change, so
+// code written against the index space works for any layout. Host assigns
+// iterate in the memory order of the lhs, launch<N, S, L> in the memory
+// order of L.
+//
+// layout_order_t<L, N> is the order of L for rank N as an index_sequence,
+// fastest varying dimension first.
+
+namespace layout
+{
+
+struct column_major
+{};
+
+struct row_major
+{};
+
+template <size_type... Order>
+struct ordered
+{};
+
+} // namespace layout
+
+namespace detail
+{
+
+template <size_type N, size_type... I>
+constexpr auto reverse_sequence(std::index_sequence<I...>)
+{
+  return std::index_sequence<(N - 1 - I)...>{};
+}
+
+template <size_type... Order>
+constexpr bool is_permutation()
+{
+  const size_type order[] = {Order...};
+  for (size_type d = 0; d < sizeof...(Order); d++) {
+    int count = 0;
+    for (auto o : order) {
+      count += o == d;
+    }
+    if (count != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace detail
+
+template <typename L, size_type N>
+struct layout_order;
+
+template <size_type N>
+struct layout_order<layout::column_major, N>
+{
+  using type = std::make_index_sequence<N>;
+};
+
+template <size_type N>
+struct layout_order<layout::row_major, N>
+{
+  using type =
+    decltype(detail::reverse_sequence<N>(std::make_index_sequence<N>()));
+};
+
+template <size_type... Order, size_type N>
+struct layout_order<layout::ordered<Order...>, N>
+{
+  static_assert(sizeof...(Order) == N, "layout::ordered: wrong rank");
+  static_assert(detail::is_permutation<Order...>(),
+                "layout::ordered: not a permutation of the dimensions");
+  using type = std::index_sequence<Order...>;
+};
+
+template <typename L, size_type N>
+using layout_order_t = typename layout_order<L, N>::type;
+
+} // namespace gt
+
+#endif // GTENSOR_LAYOUT_H
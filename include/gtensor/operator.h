@@ -1,6 +1,7 @@
 #ifndef GTENSOR_OPERATOR_H
 #define GTENSOR_OPERATOR_H
 
+#include "assign.h"
 #include "defs.h"
 #include "gtl.h"
 #include "helper.h"
@@ -355,6 +356,30 @@ struct equals<6, 6, space::host, space::host>
   }
 };
 
+// any other rank, see for_each_row
+template <size_type N>
+struct equals<N, N, space::host, space::host>
+{
+  template <typename E1, typename E2>
+  static bool run(const E1& e1, const E2& e2)
+  {
+    if (e1.shape() != e2.shape()) {
+      return false;
+    }
+
+    bool equal = true;
+    for_each_row(e1.shape(), [&](gt::shape_type<N>& idx) {
+      for (int i = 0; i < e1.shape(0); i++) {
+        idx[0] = i;
+        if (index_expression(e1, idx) != index_expression(e2, idx)) {
+          equal = false;
+        }
+      }
+    });
+    return equal;
+  }
+};
+
 #ifdef GTENSOR_HAVE_DEVICE
 
 template <size_type N1, size_type N2>
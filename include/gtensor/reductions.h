@@ -420,8 +420,7 @@ inline void sum_axis_to(Eout&& out, Ein&& in, int axis,
 
   // Note: use logical indexing strides, not internal strides which may be
   // for addressing the underlying data for gview
-  auto strides_out = calc_strides(shape_out);
-  auto strides_in = calc_strides(shape_in);
+  auto strides_out = calc_fast_strides(shape_out);
 
   auto flat_out_shape = gt::shape(static_cast<int>(out.size()));
   int reduction_length = in.shape(axis);
@@ -0,0 +1,596 @@
+#ifndef GTENSOR_SEGMENTED_H
+#define GTENSOR_SEGMENTED_H
+
+#include "gtensor.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace gt
+{
+
+// ======================================================================
+// segmented expressions
+//
+// roll(e, shift, axis) is e shifted periodically by shift along axis, like
+// numpy.roll, so roll(e, 1, 0)(i, ...) is e(i - 1, ...) with the last
+// element wrapping around to the front. roll(e, shifts) rolls along all
+// dimensions at once. Negative shifts roll backwards. Rolling a roll adds
+// the shifts to it rather than nesting.
+//
+// concatenate(e1, e2, axis) is e1 followed by e2 along axis; all other
+// dimensions must match. More operands nest, e.g.
+// concatenate(concatenate(a, b), c).
+//
+// pad(e, before, after, value) is e with before[d] and after[d] elements
+// of value (0 by default) added on either side of dimension d, e.g. to
+// zero-pad the input of an FFT. For periodic, reflecting or clamped padding,
+// see wrap().
+//
+// All three are lazy, read-only expressions that combine with any other
+// expression. Reading an element selects between (clamped) candidate
+// locations rather than branching, which keeps loops over them vectorizable.
+// Assigning one directly, as in b = roll(a, 1, 0), avoids even that: the
+// assign splits into the few contiguous segments that the result is made of,
+// each of which is a plain assign from a view of the operand (or a fill), so
+// the whole assign costs one pass over memory. As for any assign, the lhs
+// must not overlap the operands.
+
+// ======================================================================
+// groll
+
+template <typename EC, size_type N>
+class groll;
+
+template <typename EC, size_type N>
+struct gtensor_inner_types<groll<EC, N>>
+{
+  using space_type = expr_space_type<EC>;
+  constexpr static size_type dimension = N;
+
+  using inner_expression_type = std::remove_reference_t<EC>;
+  using value_type = typename inner_expression_type::value_type;
+  using reference = typename inner_expression_type::const_reference;
+  using const_reference = typename inner_expression_type::const_reference;
+};
+
+template <typename EC, size_type N>
+class groll : public expression<groll<EC, N>>
+{
+public:
+  using self_type = groll<EC, N>;
+  using base_type = expression<self_type>;
+  using inner_types = gtensor_inner_types<self_type>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  using const_kernel_type = groll<to_kernel_t<std::add_const_t<EC>>, N>;
+  using kernel_type = const_kernel_type;
+
+  constexpr static size_type dimension() { return N; };
+
+  using shape_type = gt::shape_type<N>;
+
+  groll(EC&& e, const shape_type& shifts)
+    : e_(std::forward<EC>(e)), shape_(e_.shape()), shifts_(shifts)
+  {
+    // normalized to [0, shape)
+    for (int d = 0; d < N; d++) {
+      shifts_[d] = shape_[d] > 0 ? (shifts_[d] % shape_[d] + shape_[d]) %
+                                     shape_[d]
+                                 : 0;
+    }
+  }
+
+  GT_INLINE shape_type shape() const { return shape_; }
+  GT_INLINE int shape(int i) const { return shape_[i]; }
+  GT_INLINE size_type size() const { return calc_size(shape_); }
+
+  const shape_type& shifts() const { return shifts_; }
+  const std::decay_t<EC>& inner() const { return e_; }
+
+  // the same operand, rolled by shifts more
+  self_type rolled(const shape_type& shifts) const&
+  {
+    EC e = e_;
+    return self_type(std::forward<EC>(e), add_shifts(shifts));
+  }
+
+  self_type rolled(const shape_type& shifts) &&
+  {
+    return self_type(std::forward<EC>(e_), add_shifts(shifts));
+  }
+
+  template <typename... Args>
+  GT_INLINE const_reference operator()(Args... args) const
+  {
+    static_assert(sizeof...(Args) == N, "gt::groll: wrong number of indices");
+    return access(std::make_index_sequence<N>(), shape_type(int(args)...));
+  }
+
+  const_kernel_type to_kernel() const
+  {
+    return const_kernel_type(e_.to_kernel(), shifts_);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "roll(" << e_.typestr() << ")" << shifts_;
+    return s.str();
+  }
+
+private:
+  shape_type add_shifts(const shape_type& shifts) const
+  {
+    shape_type sum;
+    for (int d = 0; d < N; d++) {
+      sum[d] = shifts_[d] + shifts[d];
+    }
+    return sum;
+  }
+
+  template <size_type... I>
+  GT_INLINE const_reference access(std::index_sequence<I...>,
+                                   shape_type idx) const
+  {
+    for (int d = 0; d < N; d++) {
+      const int j = idx[d] - shifts_[d];
+      idx[d] = j < 0 ? j + shape_[d] : j;
+    }
+    return e_(idx[I]...);
+  }
+
+  EC e_;
+  shape_type shape_;
+  shape_type shifts_;
+};
+
+namespace detail
+{
+
+template <typename E>
+struct is_groll : std::false_type
+{};
+
+template <typename EC, size_type N>
+struct is_groll<groll<EC, N>> : std::true_type
+{};
+
+template <typename E>
+inline auto roll(E&& e, const expr_shape_type<E>& shifts, std::false_type)
+{
+  constexpr size_type N = expr_dimension<E>();
+  return groll<to_expression_t<E>, N>(std::forward<E>(e), shifts);
+}
+
+// a roll of a roll is one roll of the inner operand by the summed shifts,
+// so that it still assigns in segments
+template <typename E>
+inline auto roll(E&& e, const expr_shape_type<E>& shifts, std::true_type)
+{
+  return std::forward<E>(e).rolled(shifts);
+}
+
+} // namespace detail
+
+template <typename E>
+inline auto roll(E&& e, const expr_shape_type<E>& shifts)
+{
+  return detail::roll(std::forward<E>(e), shifts,
+                      detail::is_groll<std::decay_t<E>>{});
+}
+
+template <typename E>
+inline auto roll(E&& e, int shift, int axis)
+{
+  constexpr size_type N = expr_dimension<E>();
+  if (axis < 0 || axis >= N) {
+    throw std::runtime_error("gt::roll: invalid axis " +
+                             std::to_string(axis));
+  }
+  expr_shape_type<E> shifts;
+  for (int d = 0; d < N; d++) {
+    shifts[d] = d == axis ? shift : 0;
+  }
+  return roll(std::forward<E>(e), shifts);
+}
+
+// ======================================================================
+// gconcat
+
+template <typename E1, typename E2, size_type N>
+class gconcat;
+
+template <typename E1, typename E2, size_type N>
+struct gtensor_inner_types<gconcat<E1, E2, N>>
+{
+  using space_type = space_t<expr_space_type<E1>, expr_space_type<E2>>;
+  constexpr static size_type dimension = N;
+
+  using value_type =
+    std::common_type_t<expr_value_type<E1>, expr_value_type<E2>>;
+  using reference = value_type;
+  using const_reference = value_type;
+};
+
+template <typename E1, typename E2, size_type N>
+class gconcat : public expression<gconcat<E1, E2, N>>
+{
+public:
+  using self_type = gconcat<E1, E2, N>;
+  using base_type = expression<self_type>;
+  using inner_types = gtensor_inner_types<self_type>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  using const_kernel_type = gconcat<to_kernel_t<std::add_const_t<E1>>,
+                                    to_kernel_t<std::add_const_t<E2>>, N>;
+  using kernel_type = const_kernel_type;
+
+  constexpr static size_type dimension() { return N; };
+
+  using shape_type = gt::shape_type<N>;
+
+  gconcat(E1&& e1, E2&& e2, int axis)
+    : e1_(std::forward<E1>(e1)),
+      e2_(std::forward<E2>(e2)),
+      axis_(axis),
+      shape_(e1_.shape())
+  {
+    auto shape2 = e2_.shape();
+    bool valid = axis_ >= 0 && axis_ < N;
+    for (int d = 0; valid && d < N; d++) {
+      valid = d == axis_ ? shape_[d] > 0 && shape2[d] > 0
+                         : shape_[d] == shape2[d];
+    }
+    if (!valid) {
+      throw std::runtime_error("gt::concatenate: can't join " +
+                               to_string(shape_) + " and " +
+                               to_string(shape2) + " along axis " +
+                               std::to_string(axis));
+    }
+    n1_ = shape_[axis_];
+    shape_[axis_] += shape2[axis_];
+  }
+
+  GT_INLINE shape_type shape() const { return shape_; }
+  GT_INLINE int shape(int i) const { return shape_[i]; }
+  GT_INLINE size_type size() const { return calc_size(shape_); }
+
+  int axis() const { return axis_; }
+  const std::decay_t<E1>& first() const { return e1_; }
+  const std::decay_t<E2>& second() const { return e2_; }
+
+  template <typename... Args>
+  GT_INLINE value_type operator()(Args... args) const
+  {
+    static_assert(sizeof...(Args) == N,
+                  "gt::gconcat: wrong number of indices");
+    return access(std::make_index_sequence<N>(), shape_type(int(args)...));
+  }
+
+  const_kernel_type to_kernel() const
+  {
+    return const_kernel_type(e1_.to_kernel(), e2_.to_kernel(), axis_);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "concatenate(" << e1_.typestr() << ", " << e2_.typestr() << ", "
+      << axis_ << ")";
+    return s.str();
+  }
+
+private:
+  template <size_type... I>
+  GT_INLINE value_type access(std::index_sequence<I...>, shape_type idx) const
+  {
+    const int i = idx[axis_];
+    shape_type idx2 = idx;
+    idx[axis_] = i < n1_ ? i : n1_ - 1;
+    idx2[axis_] = i < n1_ ? 0 : i - n1_;
+    const value_type a = e1_(idx[I]...);
+    const value_type b = e2_(idx2[I]...);
+    return i < n1_ ? a : b;
+  }
+
+  E1 e1_;
+  E2 e2_;
+  int axis_;
+  shape_type shape_;
+  int n1_;
+};
+
+template <typename E1, typename E2>
+inline auto concatenate(E1&& e1, E2&& e2, int axis = 0)
+{
+  static_assert(expr_dimension<E1>() == expr_dimension<E2>(),
+                "gt::concatenate: expressions of different dimension");
+  constexpr size_type N = expr_dimension<E1>();
+  return gconcat<to_expression_t<E1>, to_expression_t<E2>, N>(
+    std::forward<E1>(e1), std::forward<E2>(e2), axis);
+}
+
+// ======================================================================
+// gpad
+
+template <typename EC, size_type N>
+class gpad;
+
+template <typename EC, size_type N>
+struct gtensor_inner_types<gpad<EC, N>>
+{
+  using space_type = expr_space_type<EC>;
+  constexpr static size_type dimension = N;
+
+  using value_type = expr_value_type<EC>;
+  using reference = value_type;
+  using const_reference = value_type;
+};
+
+template <typename EC, size_type N>
+class gpad : public expression<gpad<EC, N>>
+{
+public:
+  using self_type = gpad<EC, N>;
+  using base_type = expression<self_type>;
+  using inner_types = gtensor_inner_types<self_type>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  using const_kernel_type = gpad<to_kernel_t<std::add_const_t<EC>>, N>;
+  using kernel_type = const_kernel_type;
+
+  constexpr static size_type dimension() { return N; };
+
+  using shape_type = gt::shape_type<N>;
+
+  gpad(EC&& e, const shape_type& before, const shape_type& after,
+       value_type value)
+    : e_(std::forward<EC>(e)),
+      inner_shape_(e_.shape()),
+      before_(before),
+      after_(after),
+      value_(value)
+  {
+    for (int d = 0; d < N; d++) {
+      if (before_[d] < 0 || after_[d] < 0 || inner_shape_[d] == 0) {
+        throw std::runtime_error("gt::pad: invalid pad " + to_string(before_) +
+                                 ", " + to_string(after_) + " for shape " +
+                                 to_string(inner_shape_));
+      }
+    }
+  }
+
+  GT_INLINE shape_type shape() const
+  {
+    shape_type shape;
+    for (int d = 0; d < N; d++) {
+      shape[d] = before_[d] + inner_shape_[d] + after_[d];
+    }
+    return shape;
+  }
+  GT_INLINE int shape(int i) const
+  {
+    return before_[i] + inner_shape_[i] + after_[i];
+  }
+  GT_INLINE size_type size() const { return calc_size(shape()); }
+
+  const shape_type& before() const { return before_; }
+  const shape_type& after() const { return after_; }
+  value_type value() const { return value_; }
+  const std::decay_t<EC>& inner() const { return e_; }
+
+  template <typename... Args>
+  GT_INLINE value_type operator()(Args... args) const
+  {
+    static_assert(sizeof...(Args) == N, "gt::gpad: wrong number of indices");
+    return access(std::make_index_sequence<N>(), shape_type(int(args)...));
+  }
+
+  const_kernel_type to_kernel() const
+  {
+    return const_kernel_type(e_.to_kernel(), before_, after_, value_);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "pad(" << e_.typestr() << ")" << before_ << after_;
+    return s.str();
+  }
+
+private:
+  template <size_type... I>
+  GT_INLINE value_type access(std::index_sequence<I...>, shape_type idx) const
+  {
+    bool inside = true;
+    for (int d = 0; d < N; d++) {
+      const int j = idx[d] - before_[d];
+      inside = inside && j >= 0 && j < inner_shape_[d];
+      idx[d] = j < 0 ? 0 : (j < inner_shape_[d] ? j : inner_shape_[d] - 1);
+    }
+    const value_type v = e_(idx[I]...);
+    return inside ? v : value_;
+  }
+
+  EC e_;
+  shape_type inner_shape_;
+  shape_type before_;
+  shape_type after_;
+  value_type value_;
+};
+
+template <typename E>
+inline auto pad(E&& e, const expr_shape_type<E>& before,
+                const expr_shape_type<E>& after,
+                expr_value_type<E> value = expr_value_type<E>())
+{
+  constexpr size_type N = expr_dimension<E>();
+  return gpad<to_expression_t<E>, N>(std::forward<E>(e), before, after,
+                                     value);
+}
+
+// the same pad on both sides
+template <typename E>
+inline auto pad(E&& e, const expr_shape_type<E>& width,
+                expr_value_type<E> value = expr_value_type<E>())
+{
+  return pad(std::forward<E>(e), width, width, value);
+}
+
+// ======================================================================
+// segmented assigns
+//
+// Broadcasting a size one dimension of rhs over lhs works as usual; rolling
+// or padding can't happen along such a dimension anyway.
+
+template <typename E1, typename EC, size_type N>
+void assign(E1& lhs, const groll<EC, N>& rhs,
+            gt::stream_view stream = gt::stream_view())
+{
+  using namespace placeholders;
+  detail::valid_assign_broadcast_or_throw(lhs.shape(), rhs.shape());
+  auto shape = rhs.shape();
+  auto shifts = rhs.shifts();
+
+  std::vector<int> axes;
+  for (int d = 0; d < N; d++) {
+    if (shifts[d] > 0) {
+      axes.push_back(d);
+    }
+  }
+
+  // along each rolled dimension, the lhs is made of the tail of rhs followed
+  // by its head, so there are 2^(# of rolled dims) boxes
+  std::vector<gdesc> lhs_box(N, gdesc(_all));
+  std::vector<gdesc> rhs_box(N, gdesc(_all));
+  for (int m = 0; m < (1 << axes.size()); m++) {
+    for (int k = 0; k < axes.size(); k++) {
+      const int d = axes[k];
+      const int n = shape[d];
+      const int s = shifts[d];
+      if (m & (1 << k)) {
+        lhs_box[d] = _s(0, s);
+        rhs_box[d] = _s(n - s, n);
+      } else {
+        lhs_box[d] = _s(s, n);
+        rhs_box[d] = _s(0, n - s);
+      }
+    }
+    auto lhs_seg = view<N>(lhs, lhs_box);
+    assign(lhs_seg, view<N>(rhs.inner(), rhs_box), stream);
+  }
+}
+
+template <typename E1, typename EA, typename EB, size_type N>
+void assign(E1& lhs, const gconcat<EA, EB, N>& rhs,
+            gt::stream_view stream = gt::stream_view())
+{
+  using namespace placeholders;
+  detail::valid_assign_broadcast_or_throw(lhs.shape(), rhs.shape());
+  const int axis = rhs.axis();
+  const int n1 = rhs.first().shape(axis);
+
+  std::vector<gdesc> box(N, gdesc(_all));
+  box[axis] = _s(0, n1);
+  auto lhs_first = view<N>(lhs, box);
+  assign(lhs_first, rhs.first(), stream);
+  box[axis] = _s(n1, rhs.shape(axis));
+  auto lhs_second = view<N>(lhs, box);
+  assign(lhs_second, rhs.second(), stream);
+}
+
+template <typename E1, typename EC, size_type N>
+void assign(E1& lhs, const gpad<EC, N>& rhs,
+            gt::stream_view stream = gt::stream_view())
+{
+  using namespace placeholders;
+  detail::valid_assign_broadcast_or_throw(lhs.shape(), rhs.shape());
+  auto shape = rhs.shape();
+  auto before = rhs.before();
+  auto inner_shape = rhs.inner().shape();
+
+  std::vector<gdesc> box(N, gdesc(_all));
+  for (int d = 0; d < N; d++) {
+    if (shape[d] != inner_shape[d]) {
+      box[d] = _s(before[d], before[d] + inner_shape[d]);
+    }
+  }
+  auto lhs_inner = view<N>(lhs, box);
+  assign(lhs_inner, rhs.inner(), stream);
+
+  // as in assign_wrapped, the slabs of dimension d cover all of the
+  // dimensions after it and only the interior of the ones before it
+  const auto value = rhs.value();
+  auto fill_box = [&](int d, int start, int stop) {
+    if (stop > start) {
+      box[d] = _s(start, stop);
+      auto lhs_slab = view<N>(lhs, box);
+      assign(lhs_slab, scalar(value), stream);
+    }
+  };
+  for (int d = 0; d < N; d++) {
+    if (shape[d] == inner_shape[d]) {
+      continue;
+    }
+    for (int e = d + 1; e < N; e++) {
+      box[e] = _all;
+    }
+    fill_box(d, 0, before[d]);
+    fill_box(d, before[d] + inner_shape[d], shape[d]);
+    box[d] = _s(before[d], before[d] + inner_shape[d]);
+  }
+}
+
+} // namespace gt
+
+#endif // GTENSOR_SEGMENTED_H
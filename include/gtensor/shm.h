@@ -0,0 +1,262 @@
+#ifndef GTENSOR_SHM_H
+#define GTENSOR_SHM_H
+
+#include "gtensor.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gt
+{
+
+// ======================================================================
+// shared memory tensors
+//
+// Host tensors backed by named POSIX shared memory segments, so that
+// several processes on the same node can map the same data without
+// copies, e.g. large read-only tables.
+//
+// shm_create() makes a new segment and returns a tensor mapping it, which
+// the creating process then fills. Other processes call shm_attach() with
+// the same name and element type, and get a tensor of the shape recorded
+// in the segment. A process detaches by destroying its tensor. The segment
+// keeps a count of attached tensors, and the last one to detach removes the
+// name, after which the memory is freed once nothing maps it any more.
+// Tensors are moveable, not copyable, so each one is one reference.
+//
+// Attached tensors can be mapped read-only, in which case writes fault.
+// Ordering between the creator filling the data and others reading it is
+// up to the caller. A process that dies while attached leaks its
+// reference, and the segment then has to be removed with shm_unlink().
+//
+// Link against gtensor::gtshm, which pulls in librt where shm_open needs it.
+
+namespace detail
+{
+
+namespace shm
+{
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+              "gt shm: process shared reference counts need lock-free atomics");
+
+constexpr char magic[8] = {'G', 'T', 'S', 'H', 'M', 0, 0, 1};
+constexpr int max_rank = 8;
+
+// at the start of the segment, the data starts on the next page
+struct header
+{
+  char magic[8];
+  std::uint32_t elem_size;
+  std::uint32_t rank;
+  std::uint64_t shape[max_rank];
+  std::uint64_t data_offset;
+  std::uint64_t data_bytes;
+  // 0 while the creator is initializing, and after the last detach
+  std::atomic<int> ref_count;
+};
+
+inline std::string segment_name(const std::string& name)
+{
+  return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+inline std::runtime_error error(const std::string& what,
+                                const std::string& name)
+{
+  return std::runtime_error("gt::" + what + ": '" + name +
+                            "': " + std::strerror(errno));
+}
+
+inline std::size_t page_size() { return ::sysconf(_SC_PAGESIZE); }
+
+// drops one reference, the last one removes the name
+inline void detach(header* h, std::size_t map_bytes, const std::string& name)
+{
+  if (h->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    ::shm_unlink(name.c_str());
+  }
+  ::munmap(h, map_bytes);
+}
+
+template <typename T, size_type N>
+inline auto make_tensor(header* h, std::size_t map_bytes,
+                        const std::string& name)
+{
+  gt::shape_type<N> shape;
+  for (int d = 0; d < N; d++) {
+    shape[d] = h->shape[d];
+  }
+  T* data = reinterpret_cast<T*>(reinterpret_cast<char*>(h) + h->data_offset);
+  return gt::adopt(data, shape,
+                   [h, map_bytes, name](T*) { detach(h, map_bytes, name); });
+}
+
+} // namespace shm
+
+} // namespace detail
+
+template <typename T, size_type N>
+inline gtensor_external<T, N> shm_create(const std::string& name,
+                                         const gt::shape_type<N>& shape,
+                                         mode_t mode = 0600)
+{
+  namespace s = detail::shm;
+  static_assert(N <= s::max_rank, "gt::shm_create: rank too large");
+  static_assert(std::is_trivially_copyable<T>::value,
+                "gt::shm_create: element type must be trivially copyable");
+  const std::string seg = s::segment_name(name);
+
+  const std::size_t page = s::page_size();
+  const std::size_t data_offset = (sizeof(s::header) + page - 1) / page * page;
+  const std::size_t data_bytes = calc_size(shape) * sizeof(T);
+  const std::size_t map_bytes = data_offset + data_bytes;
+
+  int fd = ::shm_open(seg.c_str(), O_RDWR | O_CREAT | O_EXCL, mode);
+  if (fd < 0) {
+    throw s::error("shm_create", seg);
+  }
+  if (::ftruncate(fd, map_bytes) != 0) {
+    auto err = s::error("shm_create", seg);
+    ::close(fd);
+    ::shm_unlink(seg.c_str());
+    throw err;
+  }
+  void* p =
+    ::mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    auto err = s::error("shm_create", seg);
+    ::shm_unlink(seg.c_str());
+    throw err;
+  }
+
+  // the segment is zero filled, so ref_count reads as 0 (not ready) until
+  // it's published below
+  auto h = new (p) s::header();
+  std::memcpy(h->magic, s::magic, sizeof(s::magic));
+  h->elem_size = sizeof(T);
+  h->rank = N;
+  for (int d = 0; d < N; d++) {
+    h->shape[d] = shape[d];
+  }
+  h->data_offset = data_offset;
+  h->data_bytes = data_bytes;
+  h->ref_count.store(1, std::memory_order_release);
+
+  return s::make_tensor<T, N>(h, map_bytes, seg);
+}
+
+template <typename T, size_type N>
+inline gtensor_external<T, N> shm_attach(const std::string& name,
+                                         bool read_only = false)
+{
+  namespace s = detail::shm;
+  const std::string seg = s::segment_name(name);
+
+  int fd = ::shm_open(seg.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    throw s::error("shm_attach", seg);
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    auto err = s::error("shm_attach", seg);
+    ::close(fd);
+    throw err;
+  }
+  const std::size_t map_bytes = st.st_size;
+  if (map_bytes < sizeof(s::header)) {
+    ::close(fd);
+    throw std::runtime_error("gt::shm_attach: '" + seg +
+                             "' is not initialized yet");
+  }
+  void* p =
+    ::mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    throw s::error("shm_attach", seg);
+  }
+  auto h = static_cast<s::header*>(p);
+
+  // take a reference, unless the segment isn't ready or is going away
+  int count = h->ref_count.load(std::memory_order_acquire);
+  do {
+    if (count <= 0) {
+      ::munmap(p, map_bytes);
+      throw std::runtime_error("gt::shm_attach: '" + seg +
+                               "' is not initialized or being removed");
+    }
+  } while (!h->ref_count.compare_exchange_weak(count, count + 1,
+                                               std::memory_order_acq_rel));
+
+  const char* mismatch = nullptr;
+  if (std::memcmp(h->magic, s::magic, sizeof(s::magic)) != 0) {
+    mismatch = "is not a gtensor segment";
+  } else if (h->elem_size != sizeof(T) || h->rank != N) {
+    mismatch = "has a different element size or rank";
+  } else if (h->data_offset + h->data_bytes > map_bytes) {
+    mismatch = "is truncated";
+  }
+  if (mismatch) {
+    s::detach(h, map_bytes, seg);
+    throw std::runtime_error("gt::shm_attach: '" + seg + "' " + mismatch);
+  }
+
+  // the data starts on a page boundary, so the header stays writable for
+  // the reference count
+  if (read_only && h->data_bytes > 0 &&
+      ::mprotect(static_cast<char*>(p) + h->data_offset, h->data_bytes,
+                 PROT_READ) != 0) {
+    auto err = s::error("shm_attach", seg);
+    s::detach(h, map_bytes, seg);
+    throw err;
+  }
+
+  return s::make_tensor<T, N>(h, map_bytes, seg);
+}
+
+// number of tensors currently attached to a segment, across all processes
+inline int shm_use_count(const std::string& name)
+{
+  namespace s = detail::shm;
+  const std::string seg = s::segment_name(name);
+  int fd = ::shm_open(seg.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    throw s::error("shm_use_count", seg);
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(s::header)) {
+    ::close(fd);
+    return 0;
+  }
+  void* p = ::mmap(nullptr, sizeof(s::header), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    throw s::error("shm_use_count", seg);
+  }
+  int count =
+    static_cast<s::header*>(p)->ref_count.load(std::memory_order_acquire);
+  ::munmap(p, sizeof(s::header));
+  return count;
+}
+
+// removes the name right away, existing mappings stay valid; returns false
+// if there was no such segment
+inline bool shm_unlink(const std::string& name)
+{
+  return ::shm_unlink(detail::shm::segment_name(name).c_str()) == 0;
+}
+
+} // namespace gt
+
+#endif // GTENSOR_SHM_H
@@ -92,6 +92,12 @@ struct storage_traits<gt::backend::host_storage<T, A>>
   using space_type = space::host;
 };
 
+template <typename T, typename S>
+struct storage_traits<gt::backend::external_storage<T, S>>
+{
+  using space_type = S;
+};
+
 #ifdef GTENSOR_HAVE_DEVICE
 
 template <typename T, typename A>
@@ -0,0 +1,1048 @@
+#ifndef GTENSOR_STENCIL_H
+#define GTENSOR_STENCIL_H
+
+#include "gtensor.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gt
+{
+
+// ======================================================================
+// stencil
+//
+// stencil<Offsets...>(coeffs, a, axis = 0) is the lazy expression
+//
+//   sum_k coeffs[k] * a(..., i + Offsets[k] - lo, ...)
+//
+// along the given axis, where lo is the smallest offset. Like the
+// equivalent sum of shifted views, e.g. for a centered difference
+//
+//   0.5 * (a.view(_s(2, _)) - a.view(_s(_, -2)))
+//     == stencil<-1, 1>({-0.5, 0.5}, a)
+//
+// it only covers the points where all neighbors exist, so the result is
+// smaller by hi - lo along the axis. Since the offsets are known at compile
+// time, the sum is unrolled and only one index is computed per point.
+//
+// When a stencil is assigned directly, the host uses a tiled kernel,
+// dispatched through the host launch: along the first dimension, each line
+// is one loop over the unrolled sum, which vectorizes, so overlapping
+// neighbors are reused from registers and L1. Along other dimensions, the
+// first dimension is split into tiles of stencil_tile points that are swept
+// along the axis, so the rows shared by neighboring outputs stay in cache.
+// On devices, and as part of larger expressions, the stencil is evaluated
+// pointwise like any expression.
+
+namespace detail
+{
+
+template <int... Offsets>
+struct stencil_offsets
+{
+  constexpr static int size = sizeof...(Offsets);
+  constexpr static int lo = std::min({Offsets...});
+  constexpr static int hi = std::max({Offsets...});
+  constexpr static int width = hi - lo + 1;
+};
+
+// sum_k c[k] * w(Offsets[k] - lo), unrolled
+template <int... Offsets, typename C, typename W, std::size_t... K>
+GT_INLINE auto stencil_sum(std::integer_sequence<int, Offsets...>,
+                           std::index_sequence<K...>, const C& c, W&& w)
+{
+  constexpr int lo = stencil_offsets<Offsets...>::lo;
+  using T = std::decay_t<decltype(c[0] * w(0))>;
+  T sum = T(0);
+  using expand = int[];
+  (void)expand{0, (sum += c[K] * w(Offsets - lo), 0)...};
+  return sum;
+}
+
+} // namespace detail
+
+template <typename E, int... Offsets>
+class gstencil;
+
+template <typename E, int... Offsets>
+struct gtensor_inner_types<gstencil<E, Offsets...>>
+{
+  using space_type = expr_space_type<E>;
+  constexpr static size_type dimension = expr_dimension<E>();
+
+  using value_type = expr_value_type<E>;
+  using reference = value_type;
+  using const_reference = value_type;
+};
+
+template <typename E, int... Offsets>
+class gstencil : public expression<gstencil<E, Offsets...>>
+{
+public:
+  using self_type = gstencil<E, Offsets...>;
+  using base_type = expression<self_type>;
+  using inner_types = gtensor_inner_types<self_type>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  using offsets = detail::stencil_offsets<Offsets...>;
+  using coeffs_type = gt::sarray<value_type, offsets::size>;
+
+  // Note: important for const correctness. See gview for explanation.
+  using const_kernel_type =
+    gstencil<to_kernel_t<std::add_const_t<E>>, Offsets...>;
+  using kernel_type = const_kernel_type;
+
+  constexpr static size_type dimension() { return inner_types::dimension; };
+
+  using shape_type = gt::shape_type<dimension()>;
+
+  gstencil(const coeffs_type& coeffs, E&& e, int axis)
+    : coeffs_(coeffs), e_(std::forward<E>(e)), axis_(axis)
+  {
+    if (axis_ < 0 || axis_ >= dimension() ||
+        e_.shape(axis_) < offsets::width) {
+      throw std::runtime_error("gt::stencil: invalid axis " +
+                               std::to_string(axis) + " for shape " +
+                               to_string(e_.shape()));
+    }
+  }
+
+  GT_INLINE shape_type shape() const
+  {
+    shape_type shape = e_.shape();
+    shape[axis_] -= offsets::width - 1;
+    return shape;
+  }
+  GT_INLINE int shape(int i) const { return shape()[i]; }
+  GT_INLINE size_type size() const { return calc_size(shape()); }
+
+  GT_INLINE int axis() const { return axis_; }
+  GT_INLINE const coeffs_type& coeffs() const { return coeffs_; }
+  GT_INLINE const E& source() const { return e_; }
+
+  template <typename... Args>
+  GT_INLINE value_type operator()(Args... args) const
+  {
+    const shape_type idx{int(args)...};
+    return detail::stencil_sum(
+      std::integer_sequence<int, Offsets...>{},
+      std::make_index_sequence<offsets::size>{}, coeffs_, [&](int s) {
+        shape_type nidx = idx;
+        nidx[axis_] += s;
+        return index_expression(e_, nidx);
+      });
+  }
+
+  const_kernel_type to_kernel() const
+  {
+    return const_kernel_type(coeffs_, e_.to_kernel(), axis_);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "stencil<";
+    using expand = int[];
+    int k = 0;
+    (void)expand{0, (s << (k++ ? "," : "") << Offsets, 0)...};
+    s << ">[" << axis_ << "](" << e_.typestr() << ")";
+    return s.str();
+  }
+
+private:
+  coeffs_type coeffs_;
+  E e_;
+  int axis_;
+};
+
+template <int... Offsets, typename E>
+inline auto stencil(
+  const gt::sarray<expr_value_type<E>, sizeof...(Offsets)>& coeffs, E&& e,
+  int axis = 0)
+{
+  static_assert(sizeof...(Offsets) > 0, "gt::stencil: no offsets");
+  return gstencil<to_expression_t<E>, Offsets...>(coeffs, std::forward<E>(e),
+                                                  axis);
+}
+
+// ======================================================================
+// assign, tiled host kernel for stencils
+
+namespace detail
+{
+
+// points of the first dimension per tile
+constexpr int stencil_tile = 512;
+
+template <typename S>
+struct stencil_assigner
+{
+  template <typename E1, typename E2>
+  static void run(E1& lhs, const E2& rhs, gt::stream_view stream)
+  {
+    assigner<expr_dimension<E1>(), S>::run(lhs, rhs, stream);
+  }
+};
+
+template <>
+struct stencil_assigner<space::host>
+{
+  template <typename E1, typename EA, int... Offsets>
+  static void run(E1& lhs, const gstencil<EA, Offsets...>& rhs,
+                  gt::stream_view stream)
+  {
+    run_axis(lhs, rhs, stream,
+             std::make_integer_sequence<int, expr_dimension<E1>()>{});
+  }
+
+private:
+  // the axis becomes a compile time constant, so the index arithmetic below
+  // is as simple as in the regular assign loops
+  template <typename E1, typename E2, int... Axes>
+  static void run_axis(E1& lhs, const E2& rhs, gt::stream_view stream,
+                       std::integer_sequence<int, Axes...>)
+  {
+    auto k_lhs = lhs.to_kernel();
+    auto k_a = rhs.source().to_kernel();
+    using expand = int[];
+    (void)expand{0, (rhs.axis() == Axes
+                       ? (run_along<Axes>(k_lhs, rhs, k_a, stream), 0)
+                       : 0)...};
+  }
+
+  // Along the (contiguous) first dimension, each line is a plain loop over
+  // the unrolled sum, which vectorizes, and overlapping neighbors are reused
+  // from the vector registers and L1.
+  template <int Axis, typename E1, typename EA, int... Offsets, typename A>
+  static std::enable_if_t<Axis == 0> run_along(
+    E1& lhs, const gstencil<EA, Offsets...>& rhs, const A& a,
+    gt::stream_view stream)
+  {
+    using T = expr_value_type<E1>;
+    const auto c = rhs.coeffs();
+    auto shape = lhs.shape();
+    const int na = shape[0];
+    auto lines = shape;
+    lines[0] = 1;
+    auto line_strides = calc_strides(lines);
+
+    auto seq = std::integer_sequence<int, Offsets...>{};
+    auto kseq = std::make_index_sequence<sizeof...(Offsets)>{};
+
+    gt::launch<1, space::host>(
+      gt::shape(calc_size(lines)),
+      [&](int line) {
+        auto idx = unravel(line, line_strides);
+        for (int j = 0; j < na; j++) {
+          idx[0] = j;
+          index_expression(lhs, idx) =
+            T(stencil_sum(seq, kseq, c, [&](int s) {
+              auto aidx = idx;
+              aidx[0] += s;
+              return index_expression(a, aidx);
+            }));
+        }
+      },
+      stream);
+  }
+
+  // Along other dimensions, the first dimension is split into tiles, and
+  // each tile is swept along the axis, so the rows of the tile that
+  // neighboring outputs share stay in cache, while the loop over the tile
+  // still vectorizes.
+  template <int Axis, typename E1, typename EA, int... Offsets, typename A>
+  static std::enable_if_t<Axis != 0> run_along(
+    E1& lhs, const gstencil<EA, Offsets...>& rhs, const A& a,
+    gt::stream_view stream)
+  {
+    using T = expr_value_type<E1>;
+    constexpr int tile = stencil_tile;
+    const auto c = rhs.coeffs();
+    auto shape = lhs.shape();
+    const int n0 = shape[0];
+    const int na = shape[Axis];
+    auto tiles = shape;
+    tiles[0] = gt::div_ceil(n0, tile);
+    tiles[Axis] = 1;
+    auto tile_strides = calc_strides(tiles);
+
+    auto seq = std::integer_sequence<int, Offsets...>{};
+    auto kseq = std::make_index_sequence<sizeof...(Offsets)>{};
+
+    gt::launch<1, space::host>(
+      gt::shape(calc_size(tiles)),
+      [&](int t) {
+        auto idx = unravel(t, tile_strides);
+        const int i_begin = idx[0] * tile;
+        const int i_end = std::min(i_begin + tile, n0);
+        for (int j = 0; j < na; j++) {
+          idx[Axis] = j;
+          for (int i = i_begin; i < i_end; i++) {
+            idx[0] = i;
+            index_expression(lhs, idx) =
+              T(stencil_sum(seq, kseq, c, [&](int s) {
+                auto aidx = idx;
+                aidx[Axis] += s;
+                return index_expression(a, aidx);
+              }));
+          }
+        }
+      },
+      stream);
+  }
+};
+
+} // namespace detail
+
+template <typename E1, typename EA, int... Offsets>
+void assign(E1& lhs, const gstencil<EA, Offsets...>& rhs,
+            gt::stream_view stream = gt::stream_view())
+{
+  static_assert(expr_dimension<E1>() == expr_dimension<EA>(),
+                "cannot assign expressions of different dimension");
+  if (lhs.shape() != rhs.shape()) {
+    // broadcasting is rare enough for stencils to not need the fast path
+    detail::valid_assign_broadcast_or_throw(lhs.shape(), rhs.shape());
+    detail::assigner<expr_dimension<E1>(),
+                     space_t<expr_space_type<E1>, expr_space_type<EA>>>::
+      run(lhs, rhs, stream);
+    return;
+  }
+  detail::stencil_assigner<
+    space_t<expr_space_type<E1>, expr_space_type<EA>>>::run(lhs, rhs, stream);
+}
+
+// ======================================================================
+// stencil over several axes
+//
+// stencil<stencil_point<O...>...>(coeffs, a, axes) is the lazy expression
+//
+//   sum_k c_k * a(idx + P_k - lo)
+//
+// where stencil_point P_k has one offset per axis in axes, the offsets along
+// all other dimensions are zero, and lo is the smallest offset per axis. As
+// along one axis, the result only covers the points where all neighbors
+// exist, so it is smaller by hi - lo along each axis, e.g. the 5 point
+// Laplacian
+//
+//   stencil<stencil_point<0, -1>, stencil_point<-1, 0>, stencil_point<0, 0>,
+//           stencil_point<1, 0>, stencil_point<0, 1>>(
+//     {1., 1., -4., 1., 1.}, a, {0, 1})
+//
+// The coefficients are either constants, or an expression with one more
+// dimension than a, whose last dimension runs over the points and whose
+// other dimensions match or broadcast against the result, for coefficients
+// that vary in space.
+//
+// On the host, the stencil is a leaf of the odometer's row path (see
+// row_binder in assign.h) when a and the coefficients are data strided, also
+// as part of a larger expression: a row moves to its start with one dot
+// product, and each neighbor is then one load at an offset fixed for the
+// whole assign, so a point costs one load per neighbor and coefficient, with
+// no index arithmetic. Elsewhere the stencil is evaluated pointwise like any
+// expression.
+
+template <int... Offsets>
+struct stencil_point
+{
+  GT_INLINE constexpr static int rank() { return sizeof...(Offsets); }
+
+  GT_INLINE constexpr static int offset(int r)
+  {
+    const int offsets[] = {Offsets...};
+    return offsets[r];
+  }
+};
+
+namespace detail
+{
+
+template <typename... Points>
+struct stencil_points
+{
+  constexpr static int size = sizeof...(Points);
+  constexpr static int rank = std::min({Points::rank()...});
+
+  GT_INLINE constexpr static int lo(int r)
+  {
+    return std::min({Points::offset(r)...});
+  }
+  GT_INLINE constexpr static int hi(int r)
+  {
+    return std::max({Points::offset(r)...});
+  }
+};
+
+// coefficient k at idx, constant or from the expression
+template <typename T, size_type K, size_type N>
+GT_INLINE T stencil_coeff(const gt::sarray<T, K>& c, int k,
+                          const gt::shape_type<N>& idx)
+{
+  return c[k];
+}
+
+template <typename C, size_type N>
+GT_INLINE decltype(auto) stencil_coeff(const C& c, int k,
+                                       const gt::shape_type<N>& idx)
+{
+  gt::shape_type<N + 1> cidx;
+  for (int d = 0; d < N; d++) {
+    cidx[d] = idx[d];
+  }
+  cidx[N] = k;
+  return index_expression(c, cidx);
+}
+
+template <typename C>
+struct stencil_coeffs_kernel
+{
+  using type = to_kernel_t<std::add_const_t<C>>;
+
+  static type get(const C& c) { return c.to_kernel(); }
+};
+
+template <typename T, size_type K>
+struct stencil_coeffs_kernel<gt::sarray<T, K>>
+{
+  using type = gt::sarray<T, K>;
+
+  static type get(const gt::sarray<T, K>& c) { return c; }
+};
+
+template <typename C>
+using stencil_coeffs_kernel_t =
+  typename stencil_coeffs_kernel<std::decay_t<C>>::type;
+
+template <typename C>
+inline std::string stencil_coeffs_typestr(const C& c)
+{
+  return c.typestr();
+}
+
+template <typename T, size_type K>
+inline std::string stencil_coeffs_typestr(const gt::sarray<T, K>& c)
+{
+  return "const";
+}
+
+} // namespace detail
+
+template <typename E, typename C, typename... Points>
+class gstencil_nd;
+
+template <typename E, typename C, typename... Points>
+struct gtensor_inner_types<gstencil_nd<E, C, Points...>>
+{
+  using space_type = expr_space_type<E>;
+  constexpr static size_type dimension = expr_dimension<E>();
+
+  using value_type = std::decay_t<decltype(
+    detail::stencil_coeff(std::declval<const std::decay_t<C>&>(), 0,
+                          std::declval<gt::shape_type<dimension>>()) *
+    std::declval<expr_value_type<E>>())>;
+  using reference = value_type;
+  using const_reference = value_type;
+};
+
+template <typename E, typename C, typename... Points>
+class gstencil_nd : public expression<gstencil_nd<E, C, Points...>>
+{
+public:
+  using self_type = gstencil_nd<E, C, Points...>;
+  using base_type = expression<self_type>;
+  using inner_types = gtensor_inner_types<self_type>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  using points = detail::stencil_points<Points...>;
+  using axes_type = gt::sarray<int, points::rank>;
+
+  // Note: important for const correctness. See gview for explanation.
+  using const_kernel_type =
+    gstencil_nd<to_kernel_t<std::add_const_t<E>>,
+                detail::stencil_coeffs_kernel_t<C>, Points...>;
+  using kernel_type = const_kernel_type;
+
+  constexpr static size_type dimension() { return inner_types::dimension; };
+
+  using shape_type = gt::shape_type<dimension()>;
+
+  gstencil_nd(C&& coeffs, E&& e, const axes_type& axes)
+    : coeffs_(std::forward<C>(coeffs)), e_(std::forward<E>(e)), axes_(axes)
+  {
+    for (int r = 0; r < points::rank; r++) {
+      bool valid = axes_[r] >= 0 && axes_[r] < dimension() &&
+                   e_.shape(axes_[r]) > points::hi(r) - points::lo(r);
+      for (int q = 0; q < r; q++) {
+        valid = valid && axes_[q] != axes_[r];
+      }
+      if (!valid) {
+        throw std::runtime_error("gt::stencil: invalid axes " +
+                                 to_string(axes_) + " for shape " +
+                                 to_string(e_.shape()));
+      }
+    }
+    check_coeffs(coeffs_);
+  }
+
+  GT_INLINE shape_type shape() const
+  {
+    shape_type shape = e_.shape();
+    for (int r = 0; r < points::rank; r++) {
+      shape[axes_[r]] -= points::hi(r) - points::lo(r);
+    }
+    return shape;
+  }
+  GT_INLINE int shape(int i) const { return shape()[i]; }
+  GT_INLINE size_type size() const { return calc_size(shape()); }
+
+  GT_INLINE const axes_type& axes() const { return axes_; }
+  GT_INLINE const std::decay_t<C>& coeffs() const { return coeffs_; }
+  GT_INLINE const E& source() const { return e_; }
+
+  // the offset of each point in the data of a source with the given strides,
+  // relative to the neighbor that has the same index as the result point
+  template <typename S>
+  GT_INLINE gt::sarray<index_type, points::size> offsets(const S& strides) const
+  {
+    return {offset<Points>(strides)...};
+  }
+
+  template <typename... Args>
+  GT_INLINE value_type operator()(Args... args) const
+  {
+    const shape_type idx{int(args)...};
+    return eval(idx, std::index_sequence_for<Points...>{});
+  }
+
+  const_kernel_type to_kernel() const
+  {
+    return const_kernel_type(
+      detail::stencil_coeffs_kernel<std::decay_t<C>>::get(coeffs_),
+      e_.to_kernel(), axes_);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "stencil<" << points::size << " points>" << to_string(axes_) << "("
+      << detail::stencil_coeffs_typestr(coeffs_) << ", " << e_.typestr()
+      << ")";
+    return s.str();
+  }
+
+private:
+  template <std::size_t... K>
+  GT_INLINE value_type eval(const shape_type& idx,
+                            std::index_sequence<K...>) const
+  {
+    value_type sum = value_type(0);
+    using expand = int[];
+    (void)expand{0, (sum += detail::stencil_coeff(coeffs_, K, idx) *
+                           index_expression(e_, neighbor<Points>(idx)),
+                     0)...};
+    return sum;
+  }
+
+  template <typename P>
+  GT_INLINE shape_type neighbor(shape_type idx) const
+  {
+    for (int r = 0; r < points::rank; r++) {
+      idx[axes_[r]] += P::offset(r) - points::lo(r);
+    }
+    return idx;
+  }
+
+  template <typename P, typename S>
+  GT_INLINE index_type offset(const S& strides) const
+  {
+    index_type off = 0;
+    for (int r = 0; r < points::rank; r++) {
+      off += (P::offset(r) - points::lo(r)) * strides[axes_[r]];
+    }
+    return off;
+  }
+
+  template <typename T, size_type K>
+  void check_coeffs(const gt::sarray<T, K>&) const
+  {}
+
+  template <typename EC>
+  void check_coeffs(const EC& c) const
+  {
+    static_assert(expr_dimension<EC>() == dimension() + 1,
+                  "gt::stencil: coefficients need one more dimension");
+    auto shape = this->shape();
+    bool valid = c.shape(dimension()) == points::size;
+    for (int d = 0; d < dimension(); d++) {
+      valid = valid && (c.shape(d) == shape[d] || c.shape(d) == 1);
+    }
+    if (!valid) {
+      throw std::runtime_error("gt::stencil: coefficient shape " +
+                               to_string(c.shape()) + " doesn't match " +
+                               to_string(shape) + " x " +
+                               std::to_string(points::size) + " points");
+    }
+  }
+
+  C coeffs_;
+  E e_;
+  axes_type axes_;
+};
+
+template <typename... Points, typename E>
+inline auto stencil(
+  const gt::sarray<expr_value_type<E>, sizeof...(Points)>& coeffs, E&& e,
+  const gt::sarray<int, detail::stencil_points<Points...>::rank>& axes)
+{
+  static_assert(std::min({Points::rank()...}) ==
+                  std::max({Points::rank()...}),
+                "gt::stencil: points of different rank");
+  using C = gt::sarray<expr_value_type<E>, sizeof...(Points)>;
+  return gstencil_nd<to_expression_t<E>, C, Points...>(
+    C(coeffs), std::forward<E>(e), axes);
+}
+
+template <typename... Points, typename C, typename E,
+          typename = std::enable_if_t<is_expression<C>::value>>
+inline auto stencil(
+  C&& coeffs, E&& e,
+  const gt::sarray<int, detail::stencil_points<Points...>::rank>& axes)
+{
+  static_assert(std::min({Points::rank()...}) ==
+                  std::max({Points::rank()...}),
+                "gt::stencil: points of different rank");
+  return gstencil_nd<to_expression_t<E>, to_expression_t<C>, Points...>(
+    std::forward<C>(coeffs), std::forward<E>(e), axes);
+}
+
+namespace detail
+{
+
+// row evaluation on the host, see row_binder in assign.h: the coefficients
+// of point k at element i of the row, constant or strided
+
+template <typename T, size_type K>
+struct row_stencil_const
+{
+  template <size_type N>
+  GT_INLINE void seek(const gt::shape_type<N>&)
+  {}
+  GT_INLINE bool unit_stride() const { return true; }
+  GT_INLINE T operator()(index_type, int k) const { return c[k]; }
+  GT_INLINE T unit(index_type, int k) const { return c[k]; }
+
+  gt::sarray<T, K> c;
+};
+
+template <typename P, size_type N>
+struct row_stencil_coeffs
+{
+  GT_INLINE void seek(const gt::shape_type<N>& idx)
+  {
+    index_type off = 0;
+    for (int d = 0; d < N; d++) {
+      off += idx[d] * strides[d];
+    }
+    p = base + off;
+  }
+  GT_INLINE bool unit_stride() const { return s == 1; }
+  GT_INLINE decltype(auto) operator()(index_type i, int k) const
+  {
+    return p[i * s + k * ks];
+  }
+  GT_INLINE decltype(auto) unit(index_type i, int k) const
+  {
+    return p[i + k * ks];
+  }
+
+  P base;
+  strides_type<N + 1> strides;
+  index_type s;
+  index_type ks;
+  P p;
+};
+
+template <typename C, size_type N, typename Enable = void>
+struct row_stencil_coeffs_binder
+{
+  static constexpr bool value = false;
+};
+
+template <typename T, size_type K, size_type N>
+struct row_stencil_coeffs_binder<gt::sarray<T, K>, N>
+{
+  static constexpr bool value = true;
+
+  static auto bind(const gt::sarray<T, K>& c, int inner)
+  {
+    return row_stencil_const<T, K>{c};
+  }
+};
+
+template <typename C, size_type N>
+struct row_stencil_coeffs_binder<C, N,
+                                 std::enable_if_t<is_data_strided<C>::value>>
+{
+  static constexpr bool value = expr_dimension<C>() == N + 1;
+
+  static auto bind(const C& c, int inner)
+  {
+    using pointer = decltype(&c.data_access(0));
+    auto shape = c.shape();
+    auto strides = c.strides();
+    for (int d = 0; d < N + 1; d++) {
+      if (shape[d] == 1) {
+        strides[d] = 0;
+      }
+    }
+    pointer base = &c.data_access(0);
+    return row_stencil_coeffs<pointer, N>{base, strides, strides[inner],
+                                          strides[N], base};
+  }
+};
+
+// each neighbor is at a fixed offset from the row's start in the source
+template <typename RC, typename P, size_type N, size_type K>
+struct row_stencil
+{
+  GT_INLINE void seek(const gt::shape_type<N>& idx)
+  {
+    index_type off = 0;
+    for (int d = 0; d < N; d++) {
+      off += idx[d] * strides[d];
+    }
+    for (int k = 0; k < K; k++) {
+      p[k] = base + off + offsets[k];
+    }
+    c.seek(idx);
+  }
+  GT_INLINE bool unit_stride() const { return s == 1 && c.unit_stride(); }
+  GT_INLINE auto operator()(index_type i) const
+  {
+    return strided(i, std::make_index_sequence<K>{});
+  }
+  GT_INLINE auto unit(index_type i) const
+  {
+    return unit(i, std::make_index_sequence<K>{});
+  }
+
+  // expanded in place rather than through a lambda, which the compiler may
+  // not inline in large translation units; the sum starts from the first
+  // term, as adding to zero can't be dropped for floating point
+  template <std::size_t... Ks>
+  GT_INLINE auto strided(index_type i, std::index_sequence<0, Ks...>) const
+  {
+    auto sum = c(i, 0) * p[0][i * s];
+    using expand = int[];
+    (void)expand{0, (sum += c(i, Ks) * p[Ks][i * s], 0)...};
+    return sum;
+  }
+  template <std::size_t... Ks>
+  GT_INLINE auto unit(index_type i, std::index_sequence<0, Ks...>) const
+  {
+    auto sum = c.unit(i, 0) * p[0][i];
+    using expand = int[];
+    (void)expand{0, (sum += c.unit(i, Ks) * p[Ks][i], 0)...};
+    return sum;
+  }
+
+  RC c;
+  P base;
+  strides_type<N> strides;
+  index_type s;
+  gt::sarray<index_type, K> offsets;
+  P p[K];
+};
+
+template <typename E, typename C, typename... Points, size_type N>
+struct row_binder<gstencil_nd<E, C, Points...>, N>
+{
+  using coeffs_binder = row_stencil_coeffs_binder<std::decay_t<C>, N>;
+
+  static constexpr bool value = is_data_strided<std::decay_t<E>>::value &&
+                                expr_dimension<E>() == N &&
+                                coeffs_binder::value;
+
+  static bool check(const gstencil_nd<E, C, Points...>&) { return true; }
+
+  static auto bind(const gstencil_nd<E, C, Points...>& e, int inner)
+  {
+    const auto& a = e.source();
+    using pointer = decltype(&a.data_access(0));
+    auto shape = a.shape();
+    auto strides = a.strides();
+    for (int d = 0; d < N; d++) {
+      if (shape[d] == 1) {
+        strides[d] = 0;
+      }
+    }
+    auto c = coeffs_binder::bind(e.coeffs(), inner);
+    pointer base = &a.data_access(0);
+    return row_stencil<decltype(c), pointer, N, sizeof...(Points)>{
+      c, base, strides, strides[inner], e.offsets(strides), {}};
+  }
+};
+
+} // namespace detail
+
+// ======================================================================
+// stencil_iterate
+//
+// stencil_iterate<Offsets...>(coeffs, a, niter, axis = 0) applies the
+// stencil niter times to a in place, Jacobi style: each sweep replaces every
+// point that has all neighbors along the axis, i.e. a(..., p, ...) for
+// -lo <= p < n - hi, by the stencil of the previous sweep centered at p,
+// while the boundary points stay fixed. The result is exactly the same as
+// niter separate sweeps
+//
+//   tmp = stencil<Offsets...>(coeffs, a, axis);
+//   a.view(..., _s(-lo, n - hi), ...) = tmp;
+//
+// which is also what devices do. On the host, the sweeps are blocked in
+// time: the axis is split into tiles sized to stay in cache, and each tile is
+// loaded once with niter * (hi - lo) extra points of halo, all sweeps are
+// done on that copy, with the valid part shrinking by the stencil reach each
+// sweep, and only the tile itself is written back. Memory traffic is then
+// about the same as for a single sweep, at the cost of recomputing the halos,
+// so this pays off as long as the tiles are large compared to the halo.
+// Along other dimensions than the first, each tile also covers up to
+// stencil_tile points of the first dimension, so the sweeps vectorize.
+
+namespace detail
+{
+
+// bytes of the two tile buffers together, about half of a typical L2
+constexpr int stencil_iterate_cache_bytes = 256 * 1024;
+
+template <typename S>
+struct stencil_iterator
+{
+  template <int... Offsets, typename E, typename C>
+  static void run(const C& coeffs, E& a, int niter, int axis,
+                  gt::stream_view stream)
+  {
+    using namespace placeholders;
+    using offsets = stencil_offsets<Offsets...>;
+    constexpr size_type N = expr_dimension<E>();
+    const int n = a.shape(axis);
+
+    std::vector<gdesc> interior(N, gdesc(_all));
+    interior[axis] = _s(-offsets::lo, n - offsets::hi);
+    auto a_interior = view<N>(a, interior);
+    gtensor<expr_value_type<E>, N, S> tmp(a_interior.shape());
+    for (int it = 0; it < niter; it++) {
+      assign(tmp, stencil<Offsets...>(coeffs, a, axis), stream);
+      assign(a_interior, tmp, stream);
+    }
+  }
+};
+
+template <>
+struct stencil_iterator<space::host>
+{
+  template <int... Offsets, typename E, typename C>
+  static void run(const C& coeffs, E& a, int niter, int axis,
+                  gt::stream_view stream)
+  {
+    using T = expr_value_type<E>;
+    using offsets = stencil_offsets<Offsets...>;
+    constexpr int rl = -offsets::lo;
+    constexpr int rr = offsets::hi;
+
+    auto shape = a.shape();
+    const int n = shape[axis];
+    // the points that get updated
+    const int p_begin = rl;
+    const int p_end = n - rr;
+
+    const int n0 = axis == 0 ? 1 : shape[0];
+    const int w0 = std::min(n0, stencil_tile);
+    const int halo_l = niter * rl;
+    const int halo_r = niter * rr;
+    // the points of two w0 wide tiles that fit the cache, less the halos,
+    // but at least as long as the halo, so only direct neighbors overlap
+    const int capacity =
+      int(stencil_iterate_cache_bytes / (2 * w0 * sizeof(T)));
+    const int tile =
+      std::max(capacity - halo_l - halo_r, std::max(halo_l + halo_r, 1));
+
+    auto tasks = shape;
+    tasks[axis] = gt::div_ceil(p_end - p_begin, tile);
+    if (axis != 0) {
+      tasks[0] = gt::div_ceil(n0, w0);
+    }
+    auto task_strides = calc_strides(tasks);
+    const int ntasks = calc_size(tasks);
+
+    // Tiles are written back in place, but their neighbors read the first
+    // halo_r and last halo_l points of each tile, so those are saved first,
+    // as [task][p][i].
+    const int edge_len = (halo_l + halo_r) * w0;
+    std::vector<T> edges(size_type(ntasks) * edge_len);
+    auto edge = [&](int task, int t_begin, int t_end, int p) {
+      const int k =
+        p < t_begin + halo_r ? p - t_begin : halo_r + halo_l + p - t_end;
+      return task * edge_len + k * w0;
+    };
+
+    auto k_a = a.to_kernel();
+    const auto c = coeffs;
+    auto seq = std::integer_sequence<int, Offsets...>{};
+    auto kseq = std::make_index_sequence<sizeof...(Offsets)>{};
+
+    gt::launch<1, space::host>(
+      gt::shape(ntasks),
+      [&](int task) {
+        auto idx = unravel(task, task_strides);
+        const int t_begin = p_begin + idx[axis] * tile;
+        const int t_end = std::min(t_begin + tile, p_end);
+        const int i_begin = axis == 0 ? 0 : idx[0] * w0;
+        const int ni = axis == 0 ? 1 : std::min(w0, n0 - i_begin);
+        for (int p = t_begin; p < t_end; p++) {
+          if (p >= t_begin + halo_r && p < t_end - halo_l) {
+            continue;
+          }
+          idx[axis] = p;
+          for (int i = 0; i < ni; i++) {
+            idx[0] = axis == 0 ? p : i_begin + i;
+            edges[edge(task, t_begin, t_end, p) + i] =
+              index_expression(k_a, idx);
+          }
+        }
+      },
+      stream);
+
+    gt::launch<1, space::host>(
+      gt::shape(ntasks),
+      [&](int task) {
+        auto idx = unravel(task, task_strides);
+        const int t = idx[axis];
+        const int t_begin = p_begin + t * tile;
+        const int t_end = std::min(t_begin + tile, p_end);
+        const int i_begin = axis == 0 ? 0 : idx[0] * w0;
+        const int ni = axis == 0 ? 1 : std::min(w0, n0 - i_begin);
+        const int b_begin = std::max(t_begin - halo_l, 0);
+        const int b_end = std::min(t_end + halo_r, n);
+
+        // buffers are [p - b_begin][i - i_begin], points of the neighboring
+        // tiles come from their saved edges, boundary points from a
+        std::vector<T> buf0((b_end - b_begin) * ni);
+        for (int p = b_begin; p < b_end; p++) {
+          idx[axis] = p;
+          T* line = &buf0[(p - b_begin) * ni];
+          if (p >= p_begin && p < t_begin) {
+            const T* e = &edges[edge(task - task_strides[axis], t_begin - tile,
+                                     t_begin, p)];
+            std::copy(e, e + ni, line);
+          } else if (p >= t_end && p < p_end) {
+            const T* e = &edges[edge(task + task_strides[axis], t_end,
+                                     std::min(t_end + tile, p_end), p)];
+            std::copy(e, e + ni, line);
+          } else {
+            for (int i = 0; i < ni; i++) {
+              idx[0] = axis == 0 ? p : i_begin + i;
+              line[i] = index_expression(k_a, idx);
+            }
+          }
+        }
+        // the boundary points are never written, so both buffers need them
+        std::vector<T> buf1(buf0);
+        T* src = buf0.data();
+        T* dst = buf1.data();
+
+        for (int s = 1; s <= niter; s++) {
+          const int s_begin = std::max(t_begin - (niter - s) * rl, p_begin);
+          const int s_end = std::min(t_end + (niter - s) * rr, p_end);
+          if (ni == 1) {
+            // along the first dimension, one contiguous loop
+            for (int p = s_begin - b_begin; p < s_end - b_begin; p++) {
+              dst[p] = T(stencil_sum(
+                seq, kseq, c, [&](int sft) { return src[p + sft - rl]; }));
+            }
+          } else {
+            for (int p = s_begin; p < s_end; p++) {
+              const T* in = src + (p - b_begin - rl) * ni;
+              T* out_line = dst + (p - b_begin) * ni;
+              for (int i = 0; i < ni; i++) {
+                out_line[i] = T(stencil_sum(
+                  seq, kseq, c, [&](int sft) { return in[sft * ni + i]; }));
+              }
+            }
+          }
+          std::swap(src, dst);
+        }
+
+        for (int p = t_begin; p < t_end; p++) {
+          idx[axis] = p;
+          for (int i = 0; i < ni; i++) {
+            idx[0] = axis == 0 ? p : i_begin + i;
+            index_expression(k_a, idx) = src[(p - b_begin) * ni + i];
+          }
+        }
+      },
+      stream);
+  }
+};
+
+} // namespace detail
+
+template <int... Offsets, typename E>
+inline void stencil_iterate(
+  const gt::sarray<expr_value_type<E>, sizeof...(Offsets)>& coeffs, E&& a,
+  int niter, int axis = 0, gt::stream_view stream = gt::stream_view())
+{
+  using offsets = detail::stencil_offsets<Offsets...>;
+  static_assert(sizeof...(Offsets) > 0, "gt::stencil_iterate: no offsets");
+  static_assert(offsets::lo <= 0 && offsets::hi >= 0,
+                "gt::stencil_iterate: offsets must surround the point");
+  if (axis < 0 || axis >= expr_dimension<E>() ||
+      a.shape(axis) < offsets::width) {
+    throw std::runtime_error("gt::stencil_iterate: invalid axis " +
+                             std::to_string(axis) + " for shape " +
+                             to_string(a.shape()));
+  }
+  if (niter <= 0 || a.size() == 0) {
+    return;
+  }
+  detail::stencil_iterator<expr_space_type<E>>::template run<Offsets...>(
+    coeffs, a, niter, axis, stream);
+}
+
+} // namespace gt
+
+#endif // GTENSOR_STENCIL_H
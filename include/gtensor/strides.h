@@ -2,19 +2,26 @@
 #ifndef GTENSOR_STRIDES_H
 #define GTENSOR_STRIDES_H
 
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "layout.h"
+
 namespace gt
 {
 
 // ======================================================================
 // calc_strides
 //
-// calculates strides corresponding to col-major layout of given shape
+// calculates strides corresponding to col-major layout of given shape,
+// by default as index_type, as I if given
 
-template <typename S>
-GT_INLINE S calc_strides(const S& shape)
+template <typename I = index_type, typename S>
+GT_INLINE sarray<I, S::size()> calc_strides(const S& shape)
 {
-  S strides;
-  int stride = 1;
+  sarray<I, S::size()> strides;
+  I stride = 1;
   for (int i = 0; i < shape.size(); i++) {
     if (shape[i] == 1) {
       strides[i] = 0;
@@ -26,22 +33,174 @@ GT_INLINE S calc_strides(const S& shape)
   return strides;
 }
 
+// calc_strides(shape, layout) calculates the strides of the given layout
+// policy, see layout.h
+
+namespace detail
+{
+
+template <typename I, typename S, size_type... Order>
+GT_INLINE sarray<I, S::size()> calc_strides(const S& shape,
+                                            std::index_sequence<Order...>)
+{
+  sarray<I, S::size()> strides;
+  // trailing 0 for rank 0
+  const int order[] = {int(Order)..., 0};
+  I stride = 1;
+  for (size_type k = 0; k < sizeof...(Order); k++) {
+    const int d = order[k];
+    if (shape[d] == 1) {
+      strides[d] = 0;
+    } else {
+      strides[d] = stride;
+    }
+    stride *= shape[d];
+  }
+  return strides;
+}
+
+} // namespace detail
+
+template <typename I = index_type, typename S, typename L>
+GT_INLINE sarray<I, S::size()> calc_strides(const S& shape, L)
+{
+  return detail::calc_strides<I>(shape, layout_order_t<L, S::size()>{});
+}
+
 // ======================================================================
 // unravel
 //
-// given 1-d index and strides, calculate multi-d index
+// given 1-d index and strides, calculate multi-d index. The arithmetic is
+// done in the type of the 1-d index, so an int index gives the cheaper 32-bit
+// divisions.
 //
-template <typename S>
-GT_INLINE S unravel(size_type i, const S& strides)
+template <typename I, typename S>
+GT_INLINE gt::shape_type<S::size()> unravel(I i, const S& strides)
 {
-  S idx;
+  gt::shape_type<S::size()> idx;
   for (int d = strides.size() - 1; d >= 0; d--) {
-    idx[d] = strides[d] == 0 ? 0 : (i / strides[d]);
-    i -= idx[d] * strides[d];
+    const I stride = strides[d];
+    idx[d] = stride == 0 ? 0 : int(i / stride);
+    i -= I(idx[d]) * stride;
+  }
+  return idx;
+}
+
+namespace detail
+{
+
+// whether linear indices for the given size fit into an int
+inline bool index_fits_32(size_type size)
+{
+  return size <= size_type(std::numeric_limits<int>::max());
+}
+
+} // namespace detail
+
+// ======================================================================
+// fast_divmod
+//
+// division by a fixed divisor d > 0 as a multiply-high, add and shift with
+// precomputed constants (Granlund and Montgomery), exact for dividends in
+// [0, 2^31). A divisor of 0 stands for a size one dimension.
+
+class fast_divmod
+{
+public:
+  fast_divmod() = default;
+
+  fast_divmod(int d) : d_(d)
+  {
+    if (d_ > 0) {
+      while ((std::uint64_t(1) << shift_) < std::uint64_t(d_)) {
+        shift_++;
+      }
+      mul_ = std::uint32_t(((std::uint64_t(1) << 32) *
+                            ((std::uint64_t(1) << shift_) - d_)) /
+                             d_ +
+                           1);
+    }
+  }
+
+  GT_INLINE int divisor() const { return d_; }
+
+  GT_INLINE int div(int n) const
+  {
+    const std::uint32_t un = n;
+    const std::uint32_t hi = (std::uint64_t(un) * mul_) >> 32;
+    return (hi + un) >> shift_;
+  }
+
+private:
+  int d_ = 0;
+  std::uint32_t mul_ = 0;
+  std::uint32_t shift_ = 0;
+};
+
+// fast_divmod constants for the col-major strides of the given shape, whose
+// size must fit into an int
+template <typename S>
+inline sarray<fast_divmod, S::size()> calc_fast_strides(const S& shape)
+{
+  auto strides = calc_strides<int>(shape);
+  sarray<fast_divmod, S::size()> fast;
+  for (int d = 0; d < S::size(); d++) {
+    fast[d] = fast_divmod(strides[d]);
+  }
+  return fast;
+}
+
+// unravel without hardware divides, for 32-bit indices
+template <typename I, size_type N>
+GT_INLINE gt::shape_type<N> unravel(I i, const sarray<fast_divmod, N>& strides)
+{
+  static_assert(sizeof(I) <= sizeof(int),
+                "unravel: fast_divmod strides need 32-bit indices");
+  gt::shape_type<N> idx;
+  int j = i;
+  for (int d = N - 1; d >= 0; d--) {
+    const int stride = strides[d].divisor();
+    idx[d] = stride == 0 ? 0 : strides[d].div(j);
+    j -= idx[d] * stride;
   }
   return idx;
 }
 
+// ======================================================================
+// unravel_strides
+//
+// the col-major strides of a shape prepared for repeated unraveling: with
+// fast_divmod constants if linear indices fit into an int, as plain strides
+// for the rare larger sizes
+
+template <size_type N>
+class unravel_strides
+{
+public:
+  unravel_strides() = default;
+
+  explicit unravel_strides(const gt::shape_type<N>& shape)
+    : strides_(calc_strides(shape)),
+      fits_32_(detail::index_fits_32(calc_size(shape)))
+  {
+    if (fits_32_) {
+      fast_ = calc_fast_strides(shape);
+    }
+  }
+
+  GT_INLINE const gt::strides_type<N>& strides() const { return strides_; }
+
+  GT_INLINE gt::shape_type<N> unravel(size_type i) const
+  {
+    return fits_32_ ? gt::unravel(int(i), fast_) : gt::unravel(i, strides_);
+  }
+
+private:
+  sarray<fast_divmod, N> fast_;
+  gt::strides_type<N> strides_;
+  bool fits_32_ = true;
+};
+
 // ======================================================================
 // calc_index
 //
@@ -0,0 +1,387 @@
+#ifndef GTENSOR_WRAP_H
+#define GTENSOR_WRAP_H
+
+#include "gtensor.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace gt
+{
+
+// ======================================================================
+// boundary wrapping views
+//
+// wrap(e, pad, modes) is a read-only view of e extended by pad[d] ghost
+// points on both sides of each dimension d, so its shape is
+// e.shape(d) + 2 * pad[d]. Ghost points aren't stored, reading one maps the
+// index back into e according to the boundary mode of that dimension:
+//
+//   boundary::periodic  index - n or index + n
+//   boundary::reflect   mirrored at the boundary face, e.g. -1 -> 0,
+//                       -2 -> 1, n -> n - 1
+//   boundary::clamp     the nearest boundary point
+//   boundary::none      no wrapping, the pad must be 0
+//
+// This replaces explicit ghost cell fills: a stencil written in terms of
+// slices of a padded array, like _s(bnd + shift, -bnd + shift), can take
+// slices of wrap(a, bnd, ...) instead, and reads across the boundary
+// directly. The pad can't be larger than the shape of the dimension it
+// wraps.
+//
+// Each access to a wrapped dimension costs a couple of compares and selects.
+// assign_wrapped(lhs, rhs, halo) avoids that for the interior: on the host,
+// it evaluates the points of lhs that are at least halo[d] away from the
+// boundary with all wrap views in rhs unchecked, and only the remaining
+// boundary slabs with the wrapping. This requires that no wrap view in rhs
+// is read at an offset of more than halo[d] from the corresponding lhs
+// point, which for the slices above means halo = bnd. Wrap views are found
+// through gfunctions and views; inside other expressions they stay checked.
+// On devices, it is a plain assign.
+
+enum class boundary
+{
+  none,
+  periodic,
+  reflect,
+  clamp
+};
+
+namespace detail
+{
+
+GT_INLINE int wrap_index(int i, int n, boundary mode)
+{
+  // written as selects rather than branches, so it vectorizes
+  const bool lo = i < 0;
+  const bool hi = i >= n;
+  switch (mode) {
+    case boundary::periodic: return lo ? i + n : (hi ? i - n : i);
+    case boundary::reflect: return lo ? -1 - i : (hi ? 2 * n - 1 - i : i);
+    case boundary::clamp: return lo ? 0 : (hi ? n - 1 : i);
+    default: return i;
+  }
+}
+
+} // namespace detail
+
+// ======================================================================
+// gwrap
+
+template <typename EC, size_type N>
+class gwrap;
+
+template <typename EC, size_type N>
+struct gtensor_inner_types<gwrap<EC, N>>
+{
+  using space_type = expr_space_type<EC>;
+  constexpr static size_type dimension = N;
+
+  using inner_expression_type = std::remove_reference_t<EC>;
+  using value_type = typename inner_expression_type::value_type;
+  using reference = typename inner_expression_type::const_reference;
+  using const_reference = typename inner_expression_type::const_reference;
+};
+
+template <typename EC, size_type N>
+class gwrap : public expression<gwrap<EC, N>>
+{
+public:
+  using self_type = gwrap<EC, N>;
+  using base_type = expression<self_type>;
+  using inner_types = gtensor_inner_types<self_type>;
+  using space_type = typename inner_types::space_type;
+  using value_type = typename inner_types::value_type;
+  using reference = typename inner_types::reference;
+  using const_reference = typename inner_types::const_reference;
+
+  using const_kernel_type = gwrap<to_kernel_t<std::add_const_t<EC>>, N>;
+  using kernel_type = const_kernel_type;
+
+  constexpr static size_type dimension() { return N; };
+
+  using shape_type = gt::shape_type<N>;
+  using modes_type = gt::sarray<boundary, N>;
+
+  gwrap(EC&& e, const shape_type& pad, const modes_type& modes,
+        bool checked = true)
+    : e_(std::forward<EC>(e)),
+      inner_shape_(e_.shape()),
+      pad_(pad),
+      modes_(modes),
+      checked_(checked)
+  {
+    for (int d = 0; d < N; d++) {
+      if (pad_[d] < 0 || (pad_[d] > 0 && modes_[d] == boundary::none) ||
+          pad_[d] > inner_shape_[d]) {
+        throw std::runtime_error("gt::wrap: invalid pad " + to_string(pad_) +
+                                 " for shape " + to_string(inner_shape_));
+      }
+    }
+  }
+
+  GT_INLINE shape_type shape() const
+  {
+    shape_type shape;
+    for (int d = 0; d < N; d++) {
+      shape[d] = inner_shape_[d] + 2 * pad_[d];
+    }
+    return shape;
+  }
+  GT_INLINE int shape(int i) const { return inner_shape_[i] + 2 * pad_[i]; }
+  GT_INLINE size_type size() const { return calc_size(shape()); }
+
+  template <typename... Args>
+  GT_INLINE const_reference operator()(Args... args) const
+  {
+    static_assert(sizeof...(Args) == N, "gt::gwrap: wrong number of indices");
+    return access(std::make_index_sequence<N>(), shape_type(int(args)...));
+  }
+
+  const_kernel_type to_kernel() const
+  {
+    return const_kernel_type(e_.to_kernel(), pad_, modes_, checked_);
+  }
+
+  // the kernel, reading e without wrapping indices, which is only valid for
+  // indices that don't cross the boundary
+  const_kernel_type to_unchecked_kernel() const
+  {
+    return const_kernel_type(e_.to_kernel(), pad_, modes_, false);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) const&
+  {
+    return gt::view(*this, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  inline auto view(Args&&... args) &&
+  {
+    return gt::view(std::move(*this), std::forward<Args>(args)...);
+  }
+
+  inline std::string typestr() const&
+  {
+    std::stringstream s;
+    s << "wrap(" << e_.typestr() << ")" << pad_;
+    return s.str();
+  }
+
+private:
+  template <size_type... I>
+  GT_INLINE const_reference access(std::index_sequence<I...>,
+                                   shape_type idx) const
+  {
+    for (int d = 0; d < N; d++) {
+      idx[d] -= pad_[d];
+    }
+    if (checked_) {
+      for (int d = 0; d < N; d++) {
+        idx[d] = detail::wrap_index(idx[d], inner_shape_[d], modes_[d]);
+      }
+    }
+    return e_(idx[I]...);
+  }
+
+  EC e_;
+  shape_type inner_shape_;
+  shape_type pad_;
+  modes_type modes_;
+  bool checked_;
+};
+
+template <typename E>
+inline auto wrap(E&& e, const expr_shape_type<E>& pad,
+                 const sarray<boundary, expr_dimension<E>()>& modes)
+{
+  constexpr size_type N = expr_dimension<E>();
+  return gwrap<to_expression_t<E>, N>(std::forward<E>(e), pad, modes);
+}
+
+// the same mode for all dimensions with a nonzero pad
+template <typename E>
+inline auto wrap(E&& e, const expr_shape_type<E>& pad, boundary mode)
+{
+  constexpr size_type N = expr_dimension<E>();
+  sarray<boundary, N> modes;
+  for (int d = 0; d < N; d++) {
+    modes[d] = pad[d] > 0 ? mode : boundary::none;
+  }
+  return wrap(std::forward<E>(e), pad, modes);
+}
+
+// ======================================================================
+// assign_wrapped
+
+namespace detail
+{
+
+// kernel_transform::apply(p, e) is e.to_kernel(), except that the leaves of
+// gfunctions and views are turned into kernels by p(leaf). The kernel types
+// are the same as those of to_kernel(), only their state can differ, so the
+// nodes are matched with their constness, which for members that are
+// references isn't that of the node holding them. Other expressions are
+// leaves as a whole.
+struct kernel_transform
+{
+  template <typename P, typename E>
+  static auto apply(const P& p, E& e)
+  {
+    return node(p, e, &e);
+  }
+
+private:
+  template <typename P, typename E>
+  static auto node(const P& p, E& e, const void*)
+  {
+    return p(e);
+  }
+
+  template <typename P, typename E, typename F, typename E1>
+  static auto node(const P& p, E& e, const gfunction<F, E1, gt_empty_expr>*)
+  {
+    using kernel_type = decltype(e.to_kernel());
+    return kernel_type(function(F(e.f_), apply(p, e.e_)));
+  }
+
+  template <typename P, typename E, typename F, typename E1, typename E2>
+  static auto node(const P& p, E& e, const gfunction<F, E1, E2>*)
+  {
+    using kernel_type = decltype(e.to_kernel());
+    return kernel_type(function(F(e.f_), apply(p, e.e1_), apply(p, e.e2_)));
+  }
+
+  template <typename P, typename E, typename EC, size_type N>
+  static auto node(const P& p, E& e, const gview<EC, N>*)
+  {
+    using kernel_type = decltype(e.to_kernel());
+    return kernel_type(apply(p, e.e_), e.offset_, e.shape(), e.strides());
+  }
+
+  template <typename P, typename E, typename EC>
+  static auto node(const P& p, E& e, const gview_adaptor<EC>*)
+  {
+    auto k_e = apply(p, e.e_);
+    using kernel_type = decltype(k_e);
+    return gview_adaptor<kernel_type>(std::move(k_e));
+  }
+};
+
+// the kernel policy for the interior of assign_wrapped
+struct unchecked_wrap
+{
+  template <typename E>
+  auto operator()(E& e) const
+  {
+    return leaf(e, &e);
+  }
+
+private:
+  template <typename E>
+  static auto leaf(E& e, const void*)
+  {
+    return e.to_kernel();
+  }
+
+  template <typename E, typename EC, size_type N>
+  static auto leaf(E& e, const gwrap<EC, N>*)
+  {
+    return e.to_unchecked_kernel();
+  }
+};
+
+template <typename S>
+struct assign_wrapped_impl
+{
+  template <typename E1, typename E2, typename Shape>
+  static void run(E1& lhs, const E2& rhs, const Shape& halo,
+                  gt::stream_view stream)
+  {
+    assign(lhs, rhs, stream);
+  }
+};
+
+template <>
+struct assign_wrapped_impl<space::host>
+{
+  template <typename E1, typename E2, typename Shape>
+  static void run(E1& lhs, const E2& rhs, const Shape& halo,
+                  gt::stream_view stream)
+  {
+    using namespace placeholders;
+    constexpr size_type N = expr_dimension<E1>();
+    detail::valid_assign_broadcast_or_throw(lhs.shape(), rhs.shape());
+    auto shape = lhs.shape();
+    for (int d = 0; d < N; d++) {
+      if (halo[d] < 0 || 2 * halo[d] >= shape[d]) {
+        // no interior
+        assign(lhs, rhs, stream);
+        return;
+      }
+    }
+
+    // broadcast dimensions of rhs are taken whole
+    auto rhs_shape = rhs.shape();
+    auto assign_box = [&](std::vector<gdesc> box, bool checked) {
+      auto lhs_box = view<N>(lhs, box);
+      for (int d = 0; d < N; d++) {
+        if (rhs_shape[d] == 1) {
+          box[d] = _all;
+        }
+      }
+      auto rhs_box = view<N>(rhs, box);
+      if (checked) {
+        assign(lhs_box, rhs_box, stream);
+      } else {
+        auto k_rhs_box = kernel_transform::apply(unchecked_wrap{}, rhs_box);
+        assign(lhs_box, k_rhs_box, stream);
+      }
+    };
+
+    std::vector<gdesc> box(N, gdesc(_all));
+    for (int d = 0; d < N; d++) {
+      if (halo[d] > 0) {
+        box[d] = _s(halo[d], shape[d] - halo[d]);
+      }
+    }
+    assign_box(box, false);
+
+    // the boundary slabs of dimension d cover all of the dimensions after
+    // it, and only the interior of the ones before it, so they don't overlap
+    for (int d = 0; d < N; d++) {
+      if (halo[d] == 0) {
+        continue;
+      }
+      for (int e = d + 1; e < N; e++) {
+        box[e] = _all;
+      }
+      box[d] = _s(0, halo[d]);
+      assign_box(box, true);
+      box[d] = _s(shape[d] - halo[d], shape[d]);
+      assign_box(box, true);
+      box[d] = _s(halo[d], shape[d] - halo[d]);
+    }
+  }
+};
+
+} // namespace detail
+
+template <typename E1, typename E2>
+inline void assign_wrapped(E1&& lhs, const E2& rhs,
+                           const expr_shape_type<E1>& halo,
+                           gt::stream_view stream = gt::stream_view())
+{
+  static_assert(expr_dimension<E1>() == expr_dimension<E2>(),
+                "cannot assign expressions of different dimension");
+  using S = space_t<expr_space_type<E1>, expr_space_type<E2>>;
+  detail::assign_wrapped_impl<S>::run(lhs, rhs, halo, stream);
+}
+
+} // namespace gt
+
+#endif // GTENSOR_WRAP_H
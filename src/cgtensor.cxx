@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
 #include <stdint.h>
+#include <type_traits>
 
 #include <gtensor/capi.h>
 #include <gtensor/gtensor.h>
@@ -113,3 +118,273 @@ void gt_backend_prefetch_host(void* p, size_t nbytes)
 {
   gt::backend::clib::prefetch_device<uint8_t>(static_cast<uint8_t*>(p), nbytes);
 }
+
+// ======================================================================
+// fused operations on raw buffers
+
+namespace detail
+{
+
+inline gt::stream_view to_stream_view(void* stream)
+{
+  if (stream == nullptr) {
+    return gt::stream_view{};
+  }
+#if defined(GTENSOR_DEVICE_CUDA)
+  return gt::stream_view{static_cast<cudaStream_t>(stream)};
+#elif defined(GTENSOR_DEVICE_HIP)
+  return gt::stream_view{static_cast<hipStream_t>(stream)};
+#elif defined(GTENSOR_DEVICE_SYCL)
+  return gt::stream_view{*static_cast<sycl::queue*>(stream)};
+#else
+  return gt::stream_view{};
+#endif
+}
+
+// C types to the corresponding gtensor types, complex values are converted
+// component-wise and arrays are checked for alignment, like in cgtblas
+template <typename T>
+struct c2gt
+{
+  using type = T;
+  static type value(T a) { return a; }
+  static void store(T* p, type a) { *p = a; }
+};
+
+template <typename T, typename C>
+struct c2gt_complex
+{
+  using type = gt::complex<T>;
+  static type value(C a) { return type(a.re, a.im); }
+  static void store(C* p, type a)
+  {
+    p->re = a.real();
+    p->im = a.imag();
+  }
+};
+
+template <>
+struct c2gt<gt_complex_float> : c2gt_complex<float, gt_complex_float>
+{};
+
+template <>
+struct c2gt<gt_complex_double> : c2gt_complex<double, gt_complex_double>
+{};
+
+template <typename C>
+inline auto cast(C* p)
+{
+  using T = typename c2gt<std::remove_const_t<C>>::type;
+  assert(reinterpret_cast<uintptr_t>(p) % alignof(T) == 0);
+  return reinterpret_cast<
+    std::conditional_t<std::is_const<C>::value, const T*, T*>>(p);
+}
+
+template <typename T>
+GT_INLINE T conj_if_complex(T a)
+{
+  return a;
+}
+
+template <typename R>
+GT_INLINE gt::complex<R> conj_if_complex(gt::complex<R> a)
+{
+  return gt::conj(a);
+}
+
+template <typename R>
+GT_INLINE R abs2(R a)
+{
+  return a * a;
+}
+
+template <typename R>
+GT_INLINE R abs2(gt::complex<R> a)
+{
+  return gt::norm(a);
+}
+
+struct op_plus
+{
+  template <typename T>
+  GT_INLINE T operator()(T a, T b) const
+  {
+    return a + b;
+  }
+};
+
+struct op_max
+{
+  template <typename T>
+  GT_INLINE T operator()(T a, T b) const
+  {
+    return a < b ? b : a;
+  }
+};
+
+// one pass of a two stage reduction: thread t of n_out combines f(i) for
+// i = t, t + n_out, ..., which keeps the loads of neighboring threads
+// contiguous
+template <typename Acc, typename F, typename Op>
+inline void reduce_pass(int n, int n_out, F f, Op op, Acc* out,
+                        gt::stream_view stream)
+{
+  gt::launch<1>(
+    gt::shape(n_out),
+    GT_LAMBDA(int t) {
+      Acc acc = f(t);
+      for (gt::size_type i = gt::size_type(t) + n_out; i < gt::size_type(n);
+           i += n_out) {
+        acc = op(acc, f(i));
+      }
+      out[t] = acc;
+    },
+    stream);
+}
+
+// reduces f(i) over [0, n) with op without materializing f, the result of
+// the first pass is reduced again on the device, so that only a few partial
+// results need to be copied to the host
+template <typename Acc, typename F, typename Op>
+inline Acc launch_reduce(int n, Acc init, F f, Op op, gt::stream_view stream)
+{
+  constexpr int max_partials = 65536;
+  constexpr int max_host_partials = 256;
+  if (n <= 0) {
+    return init;
+  }
+
+  const int n1 = std::min(n, max_partials);
+  gt::gtensor_device<Acc, 1> partials(gt::shape(n1));
+  reduce_pass<Acc>(n, n1, f, op, gt::raw_pointer_cast(partials.data()),
+                   stream);
+
+  const int n2 = std::min(n1, max_host_partials);
+  gt::gtensor_device<Acc, 1> partials2(gt::shape(n2));
+  const Acc* p1 = gt::raw_pointer_cast(partials.data());
+  reduce_pass<Acc>(
+    n1, n2, GT_LAMBDA(int i) { return p1[i]; }, op,
+    gt::raw_pointer_cast(partials2.data()), stream);
+  stream.synchronize();
+
+  gt::gtensor<Acc, 1> h_partials(gt::shape(n2));
+  gt::copy(partials2, h_partials);
+  Acc acc = init;
+  for (int i = 0; i < n2; i++) {
+    acc = op(acc, h_partials(i));
+  }
+  return acc;
+}
+
+template <typename C>
+inline void sum(int n, const C* x, C* result, void* stream)
+{
+  using T = typename c2gt<C>::type;
+  auto px = cast(x);
+  auto s = launch_reduce(
+    n, T(0), GT_LAMBDA(int i) { return px[i]; }, op_plus{},
+    to_stream_view(stream));
+  c2gt<C>::store(result, s);
+}
+
+template <typename C, typename R>
+inline void maxabs(int n, const C* x, R* result, void* stream)
+{
+  auto px = cast(x);
+  *result = launch_reduce(
+    n, R(0), GT_LAMBDA(int i) { return R(gt::abs(px[i])); }, op_max{},
+    to_stream_view(stream));
+}
+
+// like BLAS ?nrm2, the squares are summed relative to max |x_i|, so that the
+// result does not overflow (or underflow) unless the norm itself does
+template <typename C, typename R>
+inline void nrm2(int n, const C* x, R* result, void* stream)
+{
+  R scale;
+  maxabs(n, x, &scale, stream);
+  if (!(scale > R(0) && scale <= std::numeric_limits<R>::max())) {
+    // zero, inf or nan
+    *result = scale;
+    return;
+  }
+
+  auto px = cast(x);
+  *result = scale * std::sqrt(launch_reduce(
+                      n, R(0), GT_LAMBDA(int i) { return abs2(px[i] / scale); },
+                      op_plus{}, to_stream_view(stream)));
+}
+
+template <typename C>
+inline void dot(int n, const C* x, const C* y, C* result, void* stream)
+{
+  using T = typename c2gt<C>::type;
+  auto px = cast(x);
+  auto py = cast(y);
+  auto s = launch_reduce(
+    n, T(0), GT_LAMBDA(int i) { return conj_if_complex(px[i]) * py[i]; },
+    op_plus{}, to_stream_view(stream));
+  c2gt<C>::store(result, s);
+}
+
+template <typename C>
+inline void axpby(int n, C a, const C* x, C b, C* y, void* stream)
+{
+  using T = typename c2gt<C>::type;
+  auto sx = gt::adapt_device(cast(x), gt::shape(n));
+  auto sy = gt::adapt_device(cast(y), gt::shape(n));
+  T ta = c2gt<C>::value(a);
+  T tb = c2gt<C>::value(b);
+  // like BLAS, y is not read when b is zero
+  if (tb == T(0)) {
+    gt::assign(sy, ta * sx, to_stream_view(stream));
+  } else {
+    gt::assign(sy, ta * sx + tb * sy, to_stream_view(stream));
+  }
+}
+
+template <typename C>
+inline void scal_copy(int n, C a, const C* x, C* y, void* stream)
+{
+  auto sx = gt::adapt_device(cast(x), gt::shape(n));
+  auto sy = gt::adapt_device(cast(y), gt::shape(n));
+  gt::assign(sy, c2gt<C>::value(a) * sx, to_stream_view(stream));
+}
+
+} // namespace detail
+
+#define CREATE_C_FUSED(P, CTYPE, RTYPE)                                        \
+  void gt_##P##sum(int n, const CTYPE* x, CTYPE* result, void* stream)         \
+  {                                                                            \
+    detail::sum(n, x, result, stream);                                         \
+  }                                                                            \
+  void gt_##P##nrm2(int n, const CTYPE* x, RTYPE* result, void* stream)        \
+  {                                                                            \
+    detail::nrm2(n, x, result, stream);                                        \
+  }                                                                            \
+  void gt_##P##maxabs(int n, const CTYPE* x, RTYPE* result, void* stream)      \
+  {                                                                            \
+    detail::maxabs(n, x, result, stream);                                      \
+  }                                                                            \
+  void gt_##P##dot(int n, const CTYPE* x, const CTYPE* y, CTYPE* result,       \
+                   void* stream)                                               \
+  {                                                                            \
+    detail::dot(n, x, y, result, stream);                                      \
+  }                                                                            \
+  void gt_##P##axpby(int n, CTYPE a, const CTYPE* x, CTYPE b, CTYPE* y,        \
+                     void* stream)                                             \
+  {                                                                            \
+    detail::axpby(n, a, x, b, y, stream);                                      \
+  }                                                                            \
+  void gt_##P##scal_copy(int n, CTYPE a, const CTYPE* x, CTYPE* y,             \
+                         void* stream)                                         \
+  {                                                                            \
+    detail::scal_copy(n, a, x, y, stream);                                     \
+  }
+
+CREATE_C_FUSED(s, float, float)
+CREATE_C_FUSED(d, double, double)
+CREATE_C_FUSED(c, gt_complex_float, float)
+CREATE_C_FUSED(z, gt_complex_double, double)
+
+#undef CREATE_C_FUSED
@@ -0,0 +1,160 @@
+/**
+ * This file, along with fft_api_interface.F90, exposes gt::fft::FFTPlanMany
+ * to Fortran. Plans are created once and kept on the C++ side behind an
+ * integer handle, and then executed any number of times on device arrays
+ * passed as assumed-rank Fortran arrays, without copies.
+ *
+ * Lengths are given in Fortran (column-major) order, i.e. for data
+ * dimensioned (n1, n2, batch), the lengths are (n1, n2). They are reversed
+ * before being handed to FFTPlanMany, which like the vendor libraries uses
+ * C order. For real transforms, the first dimension of the complex side is
+ * n1/2+1.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "gtensor/gtensor.h"
+
+#include "gt-fft/fft.h"
+
+#include "handle_registry.h"
+
+namespace
+{
+
+class fft_plan_base
+{
+public:
+  virtual ~fft_plan_base() = default;
+};
+
+template <gt::fft::Domain D, typename R>
+class fft_plan;
+
+template <typename R>
+class fft_plan<gt::fft::Domain::COMPLEX, R> : public fft_plan_base
+{
+public:
+  using in_type = gt::complex<R>;
+  using out_type = gt::complex<R>;
+
+  fft_plan(std::vector<int> lengths, int batch_size)
+    : plan_(lengths, batch_size),
+      in_size_(std::accumulate(lengths.begin(), lengths.end(), std::size_t(1),
+                               std::multiplies<std::size_t>()) *
+               batch_size),
+      out_size_(in_size_)
+  {}
+
+  gt::fft::FFTPlanMany<gt::fft::Domain::COMPLEX, R> plan_;
+  std::size_t in_size_;
+  std::size_t out_size_;
+};
+
+template <typename R>
+class fft_plan<gt::fft::Domain::REAL, R> : public fft_plan_base
+{
+public:
+  using in_type = R;
+  using out_type = gt::complex<R>;
+
+  fft_plan(std::vector<int> lengths, int batch_size)
+    : plan_(lengths, batch_size),
+      in_size_(std::accumulate(lengths.begin(), lengths.end(), std::size_t(1),
+                               std::multiplies<std::size_t>()) *
+               batch_size),
+      out_size_(in_size_ / lengths.back() * (lengths.back() / 2 + 1))
+  {}
+
+  gt::fft::FFTPlanMany<gt::fft::Domain::REAL, R> plan_;
+  std::size_t in_size_;
+  std::size_t out_size_;
+};
+
+gt::fortran::handle_registry<fft_plan_base>& plans()
+{
+  static gt::fortran::handle_registry<fft_plan_base> registry;
+  return registry;
+}
+
+template <gt::fft::Domain D, typename R>
+void create(int* handle, int rank, const int* lengths, int batch_size)
+{
+  if (rank < 1 || batch_size < 1) {
+    gt::fortran::fatal("gtfft_create", "invalid rank or batch size");
+  }
+  std::vector<int> c_lengths(lengths, lengths + rank);
+  std::reverse(c_lengths.begin(), c_lengths.end());
+  *handle = plans().add(
+    std::unique_ptr<fft_plan_base>(new fft_plan<D, R>(c_lengths, batch_size)));
+}
+
+template <gt::fft::Domain D, typename R>
+fft_plan<D, R>& get(int handle, const char* where)
+{
+  auto plan = dynamic_cast<fft_plan<D, R>*>(&plans().get(handle, where));
+  if (plan == nullptr) {
+    gt::fortran::fatal(where, "plan was created for a different transform");
+  }
+  return *plan;
+}
+
+template <gt::fft::Domain D, typename R>
+void forward(int handle, gt::farray<typename fft_plan<D, R>::in_type, 0>* in,
+             gt::farray<typename fft_plan<D, R>::out_type, 0>* out)
+{
+  const char* where = "gtfft_forward";
+  auto& p = get<D, R>(handle, where);
+  p.plan_(gt::fortran::checked_data(in, p.in_size_, where),
+          gt::fortran::checked_data(out, p.out_size_, where));
+}
+
+template <gt::fft::Domain D, typename R>
+void inverse(int handle, gt::farray<typename fft_plan<D, R>::out_type, 0>* in,
+             gt::farray<typename fft_plan<D, R>::in_type, 0>* out)
+{
+  const char* where = "gtfft_inverse";
+  auto& p = get<D, R>(handle, where);
+  p.plan_.inverse(gt::fortran::checked_data(in, p.out_size_, where),
+                  gt::fortran::checked_data(out, p.in_size_, where));
+}
+
+using gt::fft::Domain;
+
+} // namespace
+
+#define GTFFT_DEFINE(SUFFIX, ISUFFIX, D, R, TIN, TOUT)                        \
+  extern "C" void gtfft_create_##SUFFIX(int* handle, int rank,                \
+                                        const int* lengths, int batch_size)   \
+  {                                                                            \
+    create<D, R>(handle, rank, lengths, batch_size);                           \
+  }                                                                            \
+                                                                               \
+  extern "C" void gtfft_forward_##SUFFIX(int handle, gt::farray<TIN, 0>* in,  \
+                                         gt::farray<TOUT, 0>* out)            \
+  {                                                                            \
+    forward<D, R>(handle, in, out);                                            \
+  }                                                                            \
+                                                                               \
+  extern "C" void gtfft_inverse_##ISUFFIX(int handle, gt::farray<TOUT, 0>* in, \
+                                          gt::farray<TIN, 0>* out)             \
+  {                                                                            \
+    inverse<D, R>(handle, in, out);                                            \
+  }
+
+GTFFT_DEFINE(z2z, z2z, Domain::COMPLEX, double, gt::complex<double>,
+             gt::complex<double>)
+GTFFT_DEFINE(c2c, c2c, Domain::COMPLEX, float, gt::complex<float>,
+             gt::complex<float>)
+GTFFT_DEFINE(d2z, z2d, Domain::REAL, double, double, gt::complex<double>)
+GTFFT_DEFINE(r2c, c2r, Domain::REAL, float, float, gt::complex<float>)
+
+#undef GTFFT_DEFINE
+
+extern "C" void gtfft_destroy(int handle)
+{
+  plans().remove(handle, "gtfft_destroy");
+}
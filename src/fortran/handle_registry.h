@@ -0,0 +1,96 @@
+#ifndef GTENSOR_FORTRAN_HANDLE_REGISTRY_H
+#define GTENSOR_FORTRAN_HANDLE_REGISTRY_H
+
+/**
+ * Objects that are created from Fortran (FFT plans, factorized solvers) live
+ * on the C++ side and are referred to by integer handles, so repeated calls
+ * reuse them without reallocating or refactoring anything. Handles start at
+ * 1, so that 0 can be used as "not created" in Fortran code.
+ *
+ * Like the rest of the Fortran interface, misuse (an unknown handle, an
+ * array of the wrong size) prints an error to stderr and aborts, rather
+ * than returning error codes.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <gtensor/fortran.h>
+
+namespace gt
+{
+
+namespace fortran
+{
+
+[[noreturn]] inline void fatal(const char* where, const char* msg)
+{
+  std::fprintf(stderr, "gtensor %s: %s\n", where, msg);
+  std::abort();
+}
+
+template <typename Base>
+class handle_registry
+{
+public:
+  int add(std::unique_ptr<Base> obj)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int handle = next_++;
+    objects_.emplace(handle, std::move(obj));
+    return handle;
+  }
+
+  Base& get(int handle, const char* where)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = objects_.find(handle);
+    if (it == objects_.end()) {
+      fatal(where, "invalid handle");
+    }
+    return *it->second;
+  }
+
+  void remove(int handle, const char* where)
+  {
+    std::unique_ptr<Base> obj;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = objects_.find(handle);
+      if (it == objects_.end()) {
+        fatal(where, "invalid handle");
+      }
+      obj = std::move(it->second);
+      objects_.erase(it);
+    }
+    // destroy outside the lock, destructors may synchronize the device
+  }
+
+private:
+  std::mutex mutex_;
+  std::unordered_map<int, std::unique_ptr<Base>> objects_;
+  int next_ = 1;
+};
+
+// checks that an array passed from Fortran is contiguous and has the
+// expected number of elements, returns its base address
+template <typename T, std::size_t N>
+T* checked_data(gt::farray<T, N>* nd, std::size_t size, const char* where)
+{
+  if (!gt::is_contiguous(nd)) {
+    fatal(where, "array must be contiguous");
+  }
+  if (gt::size(nd) != size) {
+    fatal(where, "array has the wrong number of elements");
+  }
+  return static_cast<T*>(nd->desc.base_addr);
+}
+
+} // namespace fortran
+
+} // namespace gt
+
+#endif // GTENSOR_FORTRAN_HANDLE_REGISTRY_H
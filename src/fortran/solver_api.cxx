@@ -0,0 +1,180 @@
+/**
+ * This file, along with solver_api_interface.F90, exposes the batched linear
+ * solvers of gt-solver (solver_dense, solver_banded and their staging_solver
+ * variants) to Fortran.
+ *
+ * The matrices are factorized once when the solver is created, and the
+ * solver is kept on the C++ side behind an integer handle, so that any
+ * number of solves reuse the factorization. Right hand sides are contiguous
+ * device arrays dimensioned (n, nrhs, nbatches), passed as assumed-shape
+ * Fortran arrays and solved without copies (staging solvers excepted, which
+ * by design solve from internal buffers).
+ *
+ * The solvers use the cgtblas handle (see gtblas_get_handle), so the stream
+ * they run on is the one set with gtblas_set_stream, and the handle must
+ * not be destroyed while solvers are alive.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "gtensor/gtensor.h"
+
+#include "gt-blas/blas.h"
+#include "gt-blas/cblas.h"
+#include "gt-solver/solver.h"
+
+#include "handle_registry.h"
+
+namespace
+{
+
+// must match the GTSOLVER_* parameters in solver_api_interface.F90
+enum solver_kind
+{
+  GTSOLVER_DENSE = 0,
+  GTSOLVER_BANDED = 1,
+  GTSOLVER_STAGING_DENSE = 2,
+  GTSOLVER_STAGING_BANDED = 3
+};
+
+class solver_handle_base
+{
+public:
+  virtual ~solver_handle_base() = default;
+};
+
+template <typename T>
+class solver_handle : public solver_handle_base
+{
+public:
+  solver_handle(int n, int nrhs, int nbatches)
+    : n_(n), nrhs_(nrhs), nbatches_(nbatches)
+  {}
+
+  virtual void solve(T* rhs, T* result) = 0;
+
+  int n_;
+  int nrhs_;
+  int nbatches_;
+};
+
+template <typename Solver>
+class solver_handle_impl : public solver_handle<typename Solver::value_type>
+{
+public:
+  using value_type = typename Solver::value_type;
+  using base_type = solver_handle<value_type>;
+
+  solver_handle_impl(gt::blas::handle_t& h, int n, int nbatches, int nrhs,
+                     value_type* const* matrix_batches)
+    : base_type(n, nrhs, nbatches),
+      solver_(h, n, nbatches, nrhs, matrix_batches)
+  {}
+
+  void solve(value_type* rhs, value_type* result) override
+  {
+    solver_.solve(rhs, result);
+  }
+
+private:
+  Solver solver_;
+};
+
+gt::fortran::handle_registry<solver_handle_base>& solvers()
+{
+  static gt::fortran::handle_registry<solver_handle_base> registry;
+  return registry;
+}
+
+template <typename T>
+void create(int* handle, gt::farray<T, 3>* matrices, int nrhs, int kind)
+{
+  const char* where = "gtsolver_create";
+  auto& desc = matrices->desc;
+  if (desc.rank != 3 || desc.dim[0].extent != desc.dim[1].extent) {
+    gt::fortran::fatal(where, "matrices must be dimensioned (n, n, nbatches)");
+  }
+  int n = desc.dim[0].extent;
+  int nbatches = desc.dim[2].extent;
+  if (nrhs < 1) {
+    gt::fortran::fatal(where, "nrhs must be positive");
+  }
+  T* data = gt::fortran::checked_data(
+    matrices, std::size_t(n) * n * nbatches, where);
+
+  // the solvers take one (device) pointer per batch, and copy the matrices
+  // before factorizing them
+  std::vector<T*> matrix_batches(nbatches);
+  for (int i = 0; i < nbatches; i++) {
+    matrix_batches[i] = data + std::size_t(i) * n * n;
+  }
+
+  auto& h = *static_cast<gt::blas::handle_t*>(gtblas_get_handle());
+  std::unique_ptr<solver_handle_base> solver;
+  switch (kind) {
+    case GTSOLVER_DENSE:
+      solver.reset(new solver_handle_impl<gt::solver::solver_dense<T>>(
+        h, n, nbatches, nrhs, matrix_batches.data()));
+      break;
+    case GTSOLVER_BANDED:
+      solver.reset(new solver_handle_impl<gt::solver::solver_banded<T>>(
+        h, n, nbatches, nrhs, matrix_batches.data()));
+      break;
+    case GTSOLVER_STAGING_DENSE:
+      solver.reset(new solver_handle_impl<
+                   gt::solver::staging_solver<gt::solver::solver_dense<T>>>(
+        h, n, nbatches, nrhs, matrix_batches.data()));
+      break;
+    case GTSOLVER_STAGING_BANDED:
+      solver.reset(new solver_handle_impl<
+                   gt::solver::staging_solver<gt::solver::solver_banded<T>>>(
+        h, n, nbatches, nrhs, matrix_batches.data()));
+      break;
+    default: gt::fortran::fatal(where, "unknown solver kind");
+  }
+  *handle = solvers().add(std::move(solver));
+}
+
+template <typename T>
+void solve(int handle, gt::farray<T, 3>* rhs, gt::farray<T, 3>* result)
+{
+  const char* where = "gtsolver_solve";
+  auto s = dynamic_cast<solver_handle<T>*>(&solvers().get(handle, where));
+  if (s == nullptr) {
+    gt::fortran::fatal(where, "solver was created for a different type");
+  }
+  const std::size_t size = std::size_t(s->n_) * s->nrhs_ * s->nbatches_;
+  T* rhs_data = gt::fortran::checked_data(rhs, size, where);
+  // absent optional result: solve in place
+  T* result_data =
+    result ? gt::fortran::checked_data(result, size, where) : rhs_data;
+  s->solve(rhs_data, result_data);
+}
+
+} // namespace
+
+#define GTSOLVER_DEFINE(SUFFIX, T)                                             \
+  extern "C" void gtsolver_create_##SUFFIX(                                    \
+    int* handle, gt::farray<T, 3>* matrices, int nrhs, int kind)               \
+  {                                                                            \
+    create<T>(handle, matrices, nrhs, kind);                                   \
+  }                                                                            \
+                                                                               \
+  extern "C" void gtsolver_solve_##SUFFIX(int handle, gt::farray<T, 3>* rhs,   \
+                                          gt::farray<T, 3>* result)            \
+  {                                                                            \
+    solve<T>(handle, rhs, result);                                             \
+  }
+
+GTSOLVER_DEFINE(s, float)
+GTSOLVER_DEFINE(d, double)
+GTSOLVER_DEFINE(c, gt::complex<float>)
+GTSOLVER_DEFINE(z, gt::complex<double>)
+
+#undef GTSOLVER_DEFINE
+
+extern "C" void gtsolver_destroy(int handle)
+{
+  solvers().remove(handle, "gtsolver_destroy");
+}
@@ -81,6 +81,136 @@ TEST(assign, broadcast_6d)
   }
 }
 
+TEST(assign, masked_assign)
+{
+  gt::gtensor<double, 2> a{{1., -2.}, {-3., 4.}};
+  gt::gtensor<double, 2> b{{10., 20.}, {30., 40.}};
+
+  gt::masked_assign(a, a < 0., b);
+  EXPECT_EQ(a, (gt::gtensor<double, 2>{{1., 20.}, {30., 4.}}));
+
+  // scalar rhs into a view, mask broadcast along the second dimension
+  gt::gtensor<bool, 1> mask{false, true};
+  gt::masked_assign(a.view(gt::all, gt::all),
+                    mask.view(gt::all, gt::newaxis), 0.);
+  EXPECT_EQ(a, (gt::gtensor<double, 2>{{1., 0.}, {30., 0.}}));
+}
+
+TEST(assign, view_noncontiguous_6d)
+{
+  gt::gtensor<int, 6> a(gt::shape(5, 3, 4, 2, 3, 2));
+  int* adata = a.data();
+  for (int i = 0; i < a.size(); i++) {
+    adata[i] = i;
+  }
+
+  // reversed, strided and broadcast dimensions on both sides
+  gt::gtensor<int, 6> b(gt::shape(3, 3, 2, 2, 6, 2), 0);
+  auto b_view = b.view(gt::all, gt::all, gt::all, gt::all, gt::slice(1, 4),
+                       gt::all);
+  auto a_view = a.view(gt::slice(4, gt::none, -2), gt::all, gt::slice(0, 4, 2),
+                       gt::all, gt::all, gt::slice(1, 2));
+  b_view = a_view;
+
+  for (int n = 0; n < 2; n++) {
+    for (int m = 0; m < 6; m++) {
+      for (int l = 0; l < 2; l++) {
+        for (int k = 0; k < 2; k++) {
+          for (int j = 0; j < 3; j++) {
+            for (int i = 0; i < 3; i++) {
+              int expected =
+                m >= 1 && m < 4 ? a(4 - 2 * i, j, 2 * k, l, m - 1, 1) : 0;
+              EXPECT_EQ(b(i, j, k, l, m, n), expected);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(assign, gtensor_8d)
+{
+  gt::gtensor<int, 8> a(gt::shape(2, 3, 1, 2, 3, 2, 1, 3));
+  int* adata = a.data();
+  for (int i = 0; i < a.size(); i++) {
+    adata[i] = i;
+  }
+
+  gt::gtensor<int, 8> b(a.shape());
+  EXPECT_NE(a, b);
+  b = a;
+  EXPECT_EQ(a, b);
+
+  // expressions go through the index odometer
+  gt::gtensor<int, 8> c(a.shape());
+  c = 2 * a + 1;
+  for (int i = 0; i < a.size(); i++) {
+    EXPECT_EQ(c.data()[i], 2 * i + 1);
+  }
+
+  // broadcast
+  gt::gtensor<int, 8> d(gt::shape(2, 1, 1, 1, 1, 1, 1, 1));
+  d(0, 0, 0, 0, 0, 0, 0, 0) = 5;
+  d(1, 0, 0, 0, 0, 0, 0, 0) = 7;
+  gt::assign(b, d);
+  for (int i = 0; i < b.size(); i++) {
+    EXPECT_EQ(b.data()[i], i % 2 == 0 ? 5 : 7);
+  }
+}
+
+TEST(assign, expression_rows_5d)
+{
+  gt::gtensor<double, 5> a(gt::shape(6, 4, 3, 2, 3));
+  for (int i = 0; i < a.size(); i++) {
+    a.data()[i] = i;
+  }
+  gt::gtensor<double, 5> c(gt::shape(4, 3, 3, 2, 3));
+  for (int i = 0; i < c.size(); i++) {
+    c.data()[i] = -i;
+  }
+
+  // broadcast along the rows, reversed and strided operands, scalars
+  auto a0 = a.view(gt::slice(0, 1));
+  auto a_rev = a.view(gt::slice(gt::none, gt::none, -1));
+  auto c2 = c.view(gt::newaxis, gt::all, 2);
+  auto rhs = -(2. * a0 + a_rev) + 0.5 * c2 + 1.;
+
+  gt::gtensor<double, 5> b(a.shape());
+  b = rhs;
+  for (int m = 0; m < 3; m++) {
+    for (int l = 0; l < 2; l++) {
+      for (int k = 0; k < 3; k++) {
+        for (int j = 0; j < 4; j++) {
+          for (int i = 0; i < 6; i++) {
+            double expected = -(2. * a(0, j, k, l, m) + a(5 - i, j, k, l, m)) +
+                              0.5 * c(j, 2, k, l, m) + 1.;
+            EXPECT_EQ(b(i, j, k, l, m), expected);
+          }
+        }
+      }
+    }
+  }
+
+  // into a strided view, and into a row-major container
+  gt::gtensor<double, 5> d(gt::shape(12, 4, 3, 2, 3), 0.);
+  d.view(gt::slice(gt::none, gt::none, 2)) = rhs;
+  EXPECT_EQ(d.view(gt::slice(gt::none, gt::none, 2)), b);
+  EXPECT_EQ(d.view(gt::slice(1, gt::none, 2)), gt::zeros<double>(b.shape()));
+  gt::gtensor<double, 5, gt::space::host, gt::layout::row_major> e(b.shape());
+  e = rhs;
+  EXPECT_EQ(e, b);
+}
+
+TEST(assign, expression_size_one_first_dim)
+{
+  gt::gtensor<double, 1> a{1., 2., 3.};
+  gt::gtensor<double, 3> b(gt::shape(1, 3, 2));
+  gt::assign(b, 2. * a.view(gt::newaxis, gt::all, gt::newaxis) + 1.);
+  EXPECT_EQ(b, (gt::gtensor<double, 3>{{{3.}, {5.}, {7.}},
+                                       {{3.}, {5.}, {7.}}}));
+}
+
 #ifdef GTENSOR_HAVE_DEVICE
 
 TEST(assign, device_gtensor_6d)
@@ -403,4 +533,14 @@ TEST(assign, device_broadcast_6d)
   }
 }
 
+TEST(assign, device_masked_assign)
+{
+  gt::gtensor_device<double, 1> a{1., -2., 3., -4.};
+  gt::gtensor<double, 1> h_a(a.shape());
+
+  gt::masked_assign(a, a < 0., -a);
+  gt::copy(a, h_a);
+  EXPECT_EQ(h_a, (gt::gtensor<double, 1>{1., 2., 3., 4.}));
+}
+
 #endif // GTENSOR_HAVE_DEVICE
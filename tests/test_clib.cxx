@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <limits>
+
 #include <gtensor/gtensor.h>
 
 #include <gtensor/capi.h>
@@ -177,3 +180,181 @@ TEST(clib, mix_managed_host)
 }
 
 #endif // GTENSOR_HAVE_DEVICE
+
+// large enough that both reduction passes have work to do
+#define N_FUSED 100003
+
+TEST(clib, fused_reductions)
+{
+  const int n = N_FUSED;
+  double* x = (double*)gt_backend_managed_allocate(n * sizeof(double));
+  double* y = (double*)gt_backend_managed_allocate(n * sizeof(double));
+  for (int i = 0; i < n; i++) {
+    x[i] = (i % 7) - 3;
+    y[i] = 2;
+  }
+  x[n / 2] = -10;
+
+  double sum, nrm2, maxabs, dot;
+  gt_dsum(n, x, &sum, NULL);
+  gt_dnrm2(n, x, &nrm2, NULL);
+  gt_dmaxabs(n, x, &maxabs, NULL);
+  gt_ddot(n, x, y, &dot, NULL);
+
+  double ref_sum = 0, ref_sum2 = 0;
+  for (int i = 0; i < n; i++) {
+    ref_sum += x[i];
+    ref_sum2 += x[i] * x[i];
+  }
+  EXPECT_EQ(sum, ref_sum);
+  EXPECT_NEAR(nrm2, std::sqrt(ref_sum2), 1e-10);
+  EXPECT_EQ(maxabs, 10);
+  EXPECT_EQ(dot, 2 * ref_sum);
+
+  float fsum = -1, fmax = -1;
+  gt_ssum(0, (float*)x, &fsum, NULL);
+  gt_smaxabs(0, (float*)x, &fmax, NULL);
+  EXPECT_EQ(fsum, 0.f);
+  EXPECT_EQ(fmax, 0.f);
+
+  gt_backend_managed_deallocate((void*)x);
+  gt_backend_managed_deallocate((void*)y);
+}
+
+TEST(clib, fused_reductions_complex)
+{
+  const int n = N_FUSED;
+  auto x = (gt_complex_float*)gt_backend_managed_allocate(
+    n * sizeof(gt_complex_float));
+  auto y = (gt_complex_float*)gt_backend_managed_allocate(
+    n * sizeof(gt_complex_float));
+  for (int i = 0; i < n; i++) {
+    x[i] = {0, 1};
+    y[i] = {1, 1};
+  }
+  x[7] = {3, -4};
+
+  gt_complex_float sum, dot;
+  float nrm2, maxabs;
+  gt_csum(n, x, &sum, NULL);
+  gt_cnrm2(n, x, &nrm2, NULL);
+  gt_cmaxabs(n, x, &maxabs, NULL);
+  gt_cdot(n, x, y, &dot, NULL);
+
+  EXPECT_EQ(sum.re, 3);
+  EXPECT_EQ(sum.im, n - 1 - 4);
+  EXPECT_NEAR(nrm2, std::sqrt(n - 1 + 25.f), 1e-3);
+  EXPECT_EQ(maxabs, 5);
+  // conj(i) * (1 + i) = 1 - i, conj(3 - 4i) * (1 + i) = -1 + 7i
+  EXPECT_EQ(dot.re, (n - 1) - 1);
+  EXPECT_EQ(dot.im, -(n - 1) + 7);
+
+  gt_backend_managed_deallocate((void*)x);
+  gt_backend_managed_deallocate((void*)y);
+}
+
+TEST(clib, fused_nrm2_scaled)
+{
+  // the squares of these overflow, their norm does not
+  const int n = 4;
+  auto x = (double*)gt_backend_managed_allocate(n * sizeof(double));
+  auto xf = (float*)gt_backend_managed_allocate(n * sizeof(float));
+  auto xc = (gt_complex_double*)gt_backend_managed_allocate(
+    n * sizeof(gt_complex_double));
+  for (int i = 0; i < n; i++) {
+    x[i] = i % 2 ? -1e200 : 1e200;
+    xf[i] = 3e30f;
+    xc[i] = {3e300, -4e300};
+  }
+
+  double nrm2, znrm2;
+  float snrm2;
+  gt_dnrm2(n, x, &nrm2, NULL);
+  gt_snrm2(n, xf, &snrm2, NULL);
+  gt_znrm2(n, xc, &znrm2, NULL);
+  EXPECT_NEAR(nrm2 / 2e200, 1., 1e-15);
+  EXPECT_NEAR(snrm2 / 6e30f, 1.f, 1e-6f);
+  EXPECT_NEAR(znrm2 / 1e301, 1., 1e-15);
+
+  // tiny values don't underflow to zero
+  x[0] = 3e-200;
+  x[1] = 4e-200;
+  gt_dnrm2(2, x, &nrm2, NULL);
+  EXPECT_NEAR(nrm2 / 5e-200, 1., 1e-15);
+
+  x[0] = 0;
+  x[1] = 0;
+  gt_dnrm2(2, x, &nrm2, NULL);
+  EXPECT_EQ(nrm2, 0.);
+
+  x[1] = std::numeric_limits<double>::infinity();
+  gt_dnrm2(2, x, &nrm2, NULL);
+  EXPECT_EQ(nrm2, std::numeric_limits<double>::infinity());
+
+  gt_backend_managed_deallocate((void*)x);
+  gt_backend_managed_deallocate((void*)xf);
+  gt_backend_managed_deallocate((void*)xc);
+}
+
+TEST(clib, fused_axpby_scal_copy)
+{
+  const int n = N_FUSED;
+  double* x = (double*)gt_backend_managed_allocate(n * sizeof(double));
+  double* y = (double*)gt_backend_managed_allocate(n * sizeof(double));
+  for (int i = 0; i < n; i++) {
+    x[i] = i;
+    y[i] = 1;
+  }
+
+  gt_daxpby(n, 2., x, 3., y, NULL);
+  gt_synchronize();
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(y[i], 2. * i + 3.);
+  }
+
+  // y is not read for b == 0
+  for (int i = 0; i < n; i++) {
+    y[i] = std::nan("");
+  }
+  gt_daxpby(n, -1., x, 0., y, NULL);
+  gt_synchronize();
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(y[i], -i);
+  }
+
+  gt_dscal_copy(n, 0.5, x, x, NULL);
+  gt_synchronize();
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(x[i], 0.5 * i);
+  }
+
+  gt_complex_double a = {0, 1};
+  gt_complex_double b = {1, 0};
+  auto zx = (gt_complex_double*)gt_backend_managed_allocate(
+    n * sizeof(gt_complex_double));
+  auto zy = (gt_complex_double*)gt_backend_managed_allocate(
+    n * sizeof(gt_complex_double));
+  for (int i = 0; i < n; i++) {
+    zx[i] = {double(i), 1};
+    zy[i] = {1, 1};
+  }
+  gt_zaxpby(n, a, zx, b, zy, NULL);
+  gt_synchronize();
+  for (int i = 0; i < n; i++) {
+    // i * (i + 1i) + (1 + 1i) = (i + 1)i
+    EXPECT_EQ(zy[i].re, 0.);
+    EXPECT_EQ(zy[i].im, i + 1.);
+  }
+
+  gt_zscal_copy(n, a, zx, zy, NULL);
+  gt_synchronize();
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(zy[i].re, -1.);
+    EXPECT_EQ(zy[i].im, double(i));
+  }
+
+  gt_backend_managed_deallocate((void*)x);
+  gt_backend_managed_deallocate((void*)y);
+  gt_backend_managed_deallocate((void*)zx);
+  gt_backend_managed_deallocate((void*)zy);
+}
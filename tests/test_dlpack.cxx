@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/dlpack.h>
+#include <gtensor/gtensor.h>
+
+#include "test_debug.h"
+
+using namespace gt::placeholders;
+
+TEST(dlpack, export_container)
+{
+  gt::gtensor<double, 2> a(gt::shape(3, 4), 1.);
+  DLManagedTensor* m = gt::to_dlpack(a);
+  const DLTensor& t = m->dl_tensor;
+
+  EXPECT_EQ(t.data, a.data());
+  EXPECT_EQ(t.device.device_type, kDLCPU);
+  EXPECT_EQ(t.ndim, 2);
+  EXPECT_EQ(t.dtype.code, kDLFloat);
+  EXPECT_EQ(t.dtype.bits, 64);
+  EXPECT_EQ(t.dtype.lanes, 1);
+  EXPECT_EQ(t.shape[0], 3);
+  EXPECT_EQ(t.shape[1], 4);
+  EXPECT_EQ(t.strides[0], 1);
+  EXPECT_EQ(t.strides[1], 3);
+  EXPECT_EQ(t.byte_offset, 0);
+
+  m->deleter(m);
+  // borrowed, so the container is still alive
+  EXPECT_EQ(a(2, 3), 1.);
+}
+
+TEST(dlpack, export_owning)
+{
+  gt::gtensor<float, 3> a(gt::shape(2, 1, 5), 2.f);
+  const float* data = a.data();
+  DLManagedTensor* m = gt::to_dlpack(std::move(a));
+
+  // moved, not copied
+  EXPECT_EQ(m->dl_tensor.data, data);
+  // size one dimension gets its compact stride
+  EXPECT_EQ(m->dl_tensor.strides[1], 2);
+  EXPECT_EQ(m->dl_tensor.strides[2], 2);
+
+  // and gets stride 0 back on import
+  auto s = gt::from_dlpack<float, 3>(m->dl_tensor);
+  EXPECT_EQ(s.strides(), gt::shape(1, 0, 2));
+  EXPECT_EQ(s, gt::full<float>({2, 1, 5}, 2.f));
+  m->deleter(m);
+}
+
+TEST(dlpack, export_span_of_view)
+{
+  gt::gtensor<int, 2> a(gt::shape(6, 4));
+  for (int j = 0; j < 4; j++) {
+    for (int i = 0; i < 6; i++) {
+      a(i, j) = 10 * j + i;
+    }
+  }
+  auto s = gt::view_strided(a, _s(1, _, 2), _all);
+  DLManagedTensor* m = gt::to_dlpack(s);
+  EXPECT_EQ(m->dl_tensor.dtype.code, kDLInt);
+  EXPECT_EQ(m->dl_tensor.dtype.bits, 32);
+  EXPECT_EQ(m->dl_tensor.shape[0], 3);
+  EXPECT_EQ(m->dl_tensor.strides[0], 2);
+  EXPECT_EQ(m->dl_tensor.strides[1], 6);
+
+  // round trip
+  auto s2 = gt::from_dlpack<int, 2>(m->dl_tensor);
+  EXPECT_EQ(s2, a.view(_s(1, _, 2), _all));
+  s2(0, 0) = -1;
+  EXPECT_EQ(a(1, 0), -1);
+  m->deleter(m);
+}
+
+TEST(dlpack, import_row_major)
+{
+  // compact row-major tensor as produced by e.g. numpy, strides NULL
+  double data[2][3] = {{0., 1., 2.}, {3., 4., 5.}};
+  std::int64_t shape[2] = {2, 3};
+  DLTensor t;
+  t.data = data;
+  t.device = {kDLCPU, 0};
+  t.ndim = 2;
+  t.dtype = {kDLFloat, 64, 1};
+  t.shape = shape;
+  t.strides = nullptr;
+  t.byte_offset = 0;
+
+  auto s = gt::from_dlpack<double, 2>(t);
+  EXPECT_EQ(s.shape(), gt::shape(2, 3));
+  EXPECT_EQ(s.strides(), gt::shape(3, 1));
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 3; j++) {
+      EXPECT_EQ(s(i, j), data[i][j]);
+    }
+  }
+
+  // explicit strides, starting at an offset: data[:, 1:]
+  std::int64_t strides[2] = {3, 1};
+  t.strides = strides;
+  t.byte_offset = sizeof(double);
+  shape[1] = 2;
+  auto s2 = gt::from_dlpack<const double, 2>(t);
+  EXPECT_EQ(s2(0, 0), 1.);
+  EXPECT_EQ(s2(1, 1), 5.);
+}
+
+TEST(dlpack, import_broadcast)
+{
+  // a row of a row-major tensor, broadcast along the size one dimension
+  double data[3] = {1., 2., 3.};
+  std::int64_t shape[2] = {1, 3};
+  std::int64_t strides[2] = {3, 1};
+  DLTensor t;
+  t.data = data;
+  t.device = {kDLCPU, 0};
+  t.ndim = 2;
+  t.dtype = {kDLFloat, 64, 1};
+  t.shape = shape;
+  t.strides = strides;
+  t.byte_offset = 0;
+
+  auto s = gt::from_dlpack<double, 2>(t);
+  EXPECT_EQ(s.strides(), gt::shape(0, 1));
+
+  gt::gtensor<double, 2> b(gt::shape(4, 3));
+  b.view(_all, _all) = s;
+  for (int j = 0; j < 3; j++) {
+    for (int i = 0; i < 4; i++) {
+      EXPECT_EQ(b(i, j), data[j]);
+    }
+  }
+}
+
+TEST(dlpack, import_errors)
+{
+  float data[4] = {};
+  std::int64_t shape[1] = {4};
+  DLTensor t{data, {kDLCPU, 0}, 1, {kDLFloat, 32, 1}, shape, nullptr, 0};
+
+  EXPECT_NO_THROW((gt::from_dlpack<float, 1>(t)));
+  EXPECT_THROW((gt::from_dlpack<double, 1>(t)), std::runtime_error);
+  EXPECT_THROW((gt::from_dlpack<int, 1>(t)), std::runtime_error);
+  EXPECT_THROW((gt::from_dlpack<float, 2>(t)), std::runtime_error);
+  t.device.device_type = kDLVulkan;
+  EXPECT_THROW((gt::from_dlpack<float, 1>(t)), std::runtime_error);
+}
+
+TEST(dlpack, complex_and_bool)
+{
+  gt::gtensor<gt::complex<double>, 1> c(gt::shape(3));
+  auto mc = gt::to_dlpack(c);
+  EXPECT_EQ(mc->dl_tensor.dtype.code, kDLComplex);
+  EXPECT_EQ(mc->dl_tensor.dtype.bits, 128);
+  mc->deleter(mc);
+
+  gt::gtensor<gt::complex<float>, 1> cf(gt::shape(3));
+  auto mcf = gt::to_dlpack(cf);
+  EXPECT_EQ(mcf->dl_tensor.dtype.bits, 64);
+  mcf->deleter(mcf);
+
+  gt::gtensor<bool, 1> b(gt::shape(3));
+  auto mb = gt::to_dlpack(b);
+  EXPECT_EQ(mb->dl_tensor.dtype.code, kDLBool);
+  EXPECT_EQ(mb->dl_tensor.dtype.bits, 8);
+  mb->deleter(mb);
+}
+
+TEST(dlpack, dlpack_tensor_calls_deleter)
+{
+  gt::gtensor<double, 1> a(gt::shape(4), 3.);
+  DLManagedTensor* m = gt::to_dlpack(std::move(a));
+
+  static int n_deleted;
+  n_deleted = 0;
+  struct ctx
+  {
+    DLManagedTensor* inner;
+  };
+  // wrap the deleter to count calls
+  DLManagedTensor outer = *m;
+  outer.manager_ctx = new ctx{m};
+  outer.deleter = [](DLManagedTensor* self) {
+    auto c = static_cast<ctx*>(self->manager_ctx);
+    c->inner->deleter(c->inner);
+    delete c;
+    n_deleted++;
+  };
+
+  {
+    gt::dlpack_tensor<double, 1> t(&outer);
+    EXPECT_EQ(t.span(), gt::full<double>({4}, 3.));
+    auto t2 = std::move(t);
+    EXPECT_EQ(t2.span()(3), 3.);
+  }
+  EXPECT_EQ(n_deleted, 1);
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(dlpack, device)
+{
+  gt::gtensor_device<float, 2> d(gt::shape(4, 3), 1.f);
+  DLManagedTensor* m = gt::to_dlpack(d);
+  EXPECT_NE(m->dl_tensor.device.device_type, kDLCPU);
+  EXPECT_THROW((gt::from_dlpack<float, 2>(m->dl_tensor)), std::runtime_error);
+
+  auto s = gt::from_dlpack<float, 2, gt::space::device>(m->dl_tensor);
+  gt::gtensor<float, 2> h(s.shape());
+  gt::copy(s, h);
+  EXPECT_EQ(h, gt::full<float>({4, 3}, 1.f));
+  m->deleter(m);
+}
+
+#endif
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <limits>
+#include <vector>
+
 #include "gtensor/complex.h"
 #include "gtensor/gtensor.h"
 #include "gtensor/reductions.h"
@@ -426,6 +429,95 @@ TEST(expression, host_index_expression)
   test_index_expression<gt::space::host>();
 }
 
+TEST(expression, index_types)
+{
+  // the total size and the last stride don't fit into an int
+  auto shape = gt::shape(65536, 3, 16384);
+  EXPECT_FALSE(gt::detail::index_fits_32(gt::calc_size(shape)));
+  EXPECT_TRUE(gt::detail::index_fits_32(gt::calc_size(gt::shape(65536, 3))));
+
+  auto strides = gt::calc_strides<std::int64_t>(shape);
+  EXPECT_EQ(strides, (gt::sarray<std::int64_t, 3>{1, 65536, 196608}));
+  std::int64_t last = std::int64_t(65536) * 3 * 16384 - 1;
+  EXPECT_EQ(gt::calc_index(strides, 65535, 2, 16383), gt::size_type(last));
+  EXPECT_EQ(gt::unravel(last, strides), gt::shape(65535, 2, 16383));
+
+  // 32-bit and 64-bit unravel agree where both apply
+  auto small = gt::shape(5, 1, 7);
+  auto strides32 = gt::calc_strides<int>(small);
+  auto strides64 = gt::calc_strides<gt::size_type>(small);
+  for (int i = 0; i < 35; i++) {
+    EXPECT_EQ(gt::unravel(i, strides32),
+              gt::unravel(gt::size_type(i), strides64));
+  }
+
+#ifdef GTENSOR_INDEX64
+  // views can have offsets beyond 2^31
+  static_assert(std::is_same<gt::index_type, std::int64_t>::value, "");
+  // (never dereferenced)
+  const std::uintptr_t base = std::uintptr_t(1) << 40;
+  gt::gtensor_span<double, 3> s(reinterpret_cast<double*>(base), shape,
+                                gt::calc_strides(shape));
+  auto v = s.view(gt::all, 1, 16383);
+  EXPECT_EQ((reinterpret_cast<std::uintptr_t>(&v(0)) - base) / sizeof(double),
+            last - 65535 - 65536);
+#endif
+}
+
+TEST(expression, fast_divmod)
+{
+  std::vector<int> divisors{1, 2, 3, 7, 64, 100, 127, 1000, 65535, 65536};
+  divisors.push_back(std::numeric_limits<int>::max());
+  divisors.push_back(1 << 30);
+  divisors.push_back((1 << 30) + 1);
+  std::vector<int> dividends{0, 1, 2, 63, 64, 65, 999, 65536};
+  dividends.push_back(std::numeric_limits<int>::max());
+  dividends.push_back(std::numeric_limits<int>::max() - 1);
+  for (int k = 1; k < 1000; k++) {
+    dividends.push_back(k * 2147483);
+  }
+  for (int d : divisors) {
+    gt::fast_divmod fd(d);
+    EXPECT_EQ(fd.divisor(), d);
+    for (int n : dividends) {
+      EXPECT_EQ(fd.div(n), n / d) << n << " / " << d;
+    }
+  }
+
+  // unravel with fast_divmod strides matches the plain one
+  auto shape = gt::shape(3, 1, 5, 7, 2, 4);
+  auto fast = gt::calc_fast_strides(shape);
+  auto strides = gt::calc_strides(shape);
+  for (int i = 0; i < gt::calc_size(shape); i++) {
+    EXPECT_EQ(gt::unravel(i, fast), gt::unravel(i, strides));
+  }
+}
+
+TEST(expression, where)
+{
+  gt::gtensor<double, 1> a{-2., -1., 0., 1., 2.};
+  gt::gtensor<double, 1> b{10., 20., 30., 40., 50.};
+
+  gt::gtensor<double, 1> c = gt::where(a > 0., a, b);
+  EXPECT_EQ(c, (gt::gtensor<double, 1>{10., 20., 30., 1., 2.}));
+
+  // scalars and fused arithmetic, limiter style
+  gt::gtensor<double, 1> d = 2. * gt::where(gt::abs(a) <= 1., a, 0.) + 1.;
+  EXPECT_EQ(d, (gt::gtensor<double, 1>{1., -1., 1., 3., 1.}));
+
+  // bool masks, broadcast to 2d
+  gt::gtensor<bool, 1> mask{true, false};
+  gt::gtensor<int, 2> e = gt::where(mask.view(gt::all, gt::newaxis),
+                                    gt::gtensor<int, 2>{{1, 2}, {3, 4}}, -1);
+  EXPECT_EQ(e, (gt::gtensor<int, 2>{{1, -1}, {3, -1}}));
+
+  // value type is the common type
+  auto f = gt::where(a < 0., 1, 0.5);
+  static_assert(std::is_same<decltype(f)::value_type, double>::value,
+                "where value type");
+  EXPECT_EQ(gt::eval(f), (gt::gtensor<double, 1>{1., 1., 0.5, 0.5, 0.5}));
+}
+
 #ifdef GTENSOR_HAVE_DEVICE
 
 TEST(expression, device_eval)
@@ -457,4 +549,14 @@ TEST(expression, device_index_expression)
   test_index_expression<gt::space::device>();
 }
 
+TEST(expression, device_where)
+{
+  gt::gtensor_device<double, 1> a{-2., -1., 0., 1., 2.};
+  gt::gtensor<double, 1> h_c(a.shape());
+
+  gt::gtensor_device<double, 1> c = gt::where(a >= 0., 2. * a, -a);
+  gt::copy(c, h_c);
+  EXPECT_EQ(h_c, (gt::gtensor<double, 1>{2., 1., 0., 2., 4.}));
+}
+
 #endif
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/gather.h>
+#include <gtensor/gtensor.h>
+#include <gtensor/reductions.h>
+
+#include "test_helpers.h"
+
+using namespace gt::placeholders;
+
+TEST(gather, gather_1d)
+{
+  gt::gtensor<double, 1> a{10., 11., 12., 13., 14.};
+  gt::gtensor<int, 1> idx{4, 0, 0, 2};
+
+  gt::gtensor<double, 1> b = gt::gather(a, idx);
+  EXPECT_EQ(b, (gt::gtensor<double, 1>{14., 10., 10., 12.}));
+}
+
+TEST(gather, gather_multi_d)
+{
+  // indices are linear, in column-major order, into a 3 x 2 source
+  gt::gtensor<double, 2> a{{0., 1., 2.}, {10., 11., 12.}};
+  gt::gtensor<int, 2> idx{{5, 0}, {3, 1}};
+
+  gt::gtensor<double, 2> b = gt::gather(a, idx);
+  EXPECT_EQ(b, (gt::gtensor<double, 2>{{12., 0.}, {10., 1.}}));
+
+  // source views
+  gt::gtensor<int, 1> idx1{1, 0};
+  gt::gtensor<double, 1> c = gt::gather(a.view(1, _all), idx1);
+  EXPECT_EQ(c, (gt::gtensor<double, 1>{11., 1.}));
+}
+
+TEST(gather, compose)
+{
+  gt::gtensor<double, 1> a{1., 2., 3., 4.};
+  gt::gtensor<int, 1> idx{3, 2, 1, 0};
+  gt::gtensor<double, 1> b{10., 20., 30., 40.};
+
+  gt::gtensor<double, 1> c = 2. * gt::gather(a, idx) + b;
+  EXPECT_EQ(c, (gt::gtensor<double, 1>{18., 26., 34., 42.}));
+
+  // index expressions and gathers of expressions
+  gt::gtensor<double, 1> d = gt::gather(a + b, idx + 0);
+  EXPECT_EQ(d, (gt::gtensor<double, 1>{44., 33., 22., 11.}));
+
+  gt::gtensor<double, 1> e = gt::gather(a, idx).view(_s(1, 3));
+  EXPECT_EQ(e, (gt::gtensor<double, 1>{3., 2.}));
+}
+
+TEST(gather, gather_long)
+{
+  // long enough to exercise the host prefetch
+  const int n = 1000;
+  gt::gtensor<double, 1> a(gt::shape(n));
+  gt::gtensor<int, 1> idx(gt::shape(n));
+  for (int i = 0; i < n; i++) {
+    a(i) = i;
+    idx(i) = (i * 7) % n;
+  }
+  gt::gtensor<double, 1> b = gt::gather(a, idx);
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(b(i), (i * 7) % n);
+  }
+}
+
+TEST(gather, scatter)
+{
+  gt::gtensor<double, 1> out(gt::shape(5), 0.);
+  gt::gtensor<int, 1> idx{4, 1, 2};
+  gt::gtensor<double, 1> v{1., 2., 3.};
+
+  gt::scatter(out, idx, v);
+  EXPECT_EQ(out, (gt::gtensor<double, 1>{0., 2., 3., 0., 1.}));
+
+  gt::scatter(out, idx, -1.);
+  EXPECT_EQ(out, (gt::gtensor<double, 1>{0., -1., -1., 0., -1.}));
+
+  gt::gtensor<double, 1> v_bad{1., 2.};
+  EXPECT_THROW(gt::scatter(out, idx, v_bad), std::runtime_error);
+}
+
+TEST(gather, scatter_multi_d)
+{
+  gt::gtensor<double, 2> out(gt::shape(2, 2), 0.);
+  gt::gtensor<int, 1> idx{3, 0};
+  gt::gtensor<double, 1> v{1., 2.};
+
+  gt::scatter(out.view(_all, _all), idx, 2. * v);
+  EXPECT_EQ(out, (gt::gtensor<double, 2>{{4., 0.}, {0., 2.}}));
+}
+
+TEST(gather, scatter_add)
+{
+  gt::gtensor<int, 1> idx{1, 3, 1, 0, 1};
+  gt::gtensor<double, 1> v{1., 2., 3., 4., 5.};
+  gt::gtensor<double, 1> expected{4., 9., 0., 2.};
+
+  gt::gtensor<double, 1> out(gt::shape(4), 0.);
+  gt::scatter_add(out, idx, v);
+  EXPECT_EQ(out, expected);
+
+  gt::gtensor<double, 1> out_sorted(gt::shape(4), 0.);
+  gt::scatter_add(out_sorted, idx, v, gt::scatter_strategy::sorted);
+  EXPECT_EQ(out_sorted, expected);
+
+  // accumulates into existing values, takes expressions and scalars
+  gt::scatter_add(out_sorted, idx, v - 1., gt::scatter_strategy::sorted);
+  EXPECT_EQ(out_sorted, (gt::gtensor<double, 1>{7., 15., 0., 3.}));
+  gt::scatter_add(out, idx, 1.);
+  EXPECT_EQ(out, (gt::gtensor<double, 1>{5., 12., 0., 3.}));
+}
+
+TEST(gather, scatter_add_complex)
+{
+  using T = gt::complex<double>;
+  gt::gtensor<int, 1> idx{0, 1, 0};
+  gt::gtensor<T, 1> v{T(1., 2.), T(3., 4.), T(5., 6.)};
+  gt::gtensor<T, 1> expected{T(6., 8.), T(3., 4.)};
+
+  gt::gtensor<T, 1> out(gt::shape(2), T(0.));
+  gt::scatter_add(out, idx, v);
+  EXPECT_EQ(out, expected);
+
+  gt::gtensor<T, 1> out_sorted(gt::shape(2), T(0.));
+  gt::scatter_add(out_sorted, idx, v, gt::scatter_strategy::sorted);
+  EXPECT_EQ(out_sorted, expected);
+}
+
+TEST(gather, histogram)
+{
+  // gather and scatter_add round trip: per-bin sums, then broadcast back
+  const int n = 1000, nbins = 7;
+  gt::gtensor<int, 1> bin(gt::shape(n));
+  gt::gtensor<double, 1> x(gt::shape(n));
+  for (int i = 0; i < n; i++) {
+    bin(i) = (i * 13) % nbins;
+    x(i) = 1.;
+  }
+  gt::gtensor<double, 1> sums(gt::shape(nbins), 0.);
+  gt::scatter_add(sums, bin, x, gt::scatter_strategy::sorted);
+  EXPECT_EQ(gt::sum(sums), double(n));
+
+  gt::gtensor<double, 1> y = x / gt::gather(sums, bin);
+  EXPECT_NEAR(gt::sum(y), double(nbins), 1e-12);
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(gather, device)
+{
+  gt::gtensor<int, 1> h_idx{1, 3, 1, 0, 1};
+  gt::gtensor<double, 1> h_v{1., 2., 3., 4., 5.};
+  gt::gtensor_device<int, 1> idx(h_idx.shape());
+  gt::gtensor_device<double, 1> v(h_v.shape());
+  gt::copy(h_idx, idx);
+  gt::copy(h_v, v);
+
+  gt::gtensor_device<double, 1> g = 2. * gt::gather(v, idx);
+  gt::gtensor<double, 1> h_g(g.shape());
+  gt::copy(g, h_g);
+  EXPECT_EQ(h_g, (gt::gtensor<double, 1>{4., 8., 4., 2., 4.}));
+
+  gt::gtensor_device<double, 1> out(gt::shape(4), 0.);
+  gt::scatter_add(out, idx, v);
+  gt::gtensor<double, 1> h_out(out.shape());
+  gt::copy(out, h_out);
+  EXPECT_EQ(h_out, (gt::gtensor<double, 1>{4., 9., 0., 2.}));
+}
+
+#endif
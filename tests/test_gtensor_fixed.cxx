@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <type_traits>
+
+#include <gtensor/gtensor.h>
+#include <gtensor/gtensor_fixed.h>
+
+#include "test_helpers.h"
+
+using namespace gt::placeholders;
+
+TEST(gtensor_fixed, fixed_shape)
+{
+  using shape = gt::fixed_shape<3, 1, 4>;
+  static_assert(shape::dimension() == 3, "dimension");
+  static_assert(shape::size() == 12, "size");
+  static_assert(shape::stride(0) == 1 && shape::stride(1) == 0 &&
+                  shape::stride(2) == 3,
+                "strides");
+  static_assert(shape::index(2, 0, 3) == 11, "index");
+
+  EXPECT_EQ(shape::shape(), gt::shape(3, 1, 4));
+  EXPECT_EQ(shape::strides(), gt::calc_strides(gt::shape(3, 1, 4)));
+}
+
+TEST(gtensor_fixed, ctor_access)
+{
+  gt::gtensor_fixed<double, 3, 2> a;
+  static_assert(sizeof(a) == 6 * sizeof(double), "inline storage");
+  static_assert(std::is_trivially_copyable<decltype(a)>::value,
+                "trivially copyable");
+  EXPECT_EQ(a.shape(), gt::shape(3, 2));
+  EXPECT_EQ(a.size(), 6);
+  EXPECT_EQ(a, (gt::gtensor<double, 2>(gt::shape(3, 2), 0.)));
+
+  gt::gtensor_fixed<double, 3, 2> b{{1., 2., 3.}, {4., 5., 6.}};
+  EXPECT_EQ(b(2, 0), 3.);
+  EXPECT_EQ(b(0, 1), 4.);
+  b(1, 1) = 10.;
+  EXPECT_EQ(b.data()[4], 10.);
+
+  auto c = b;
+  EXPECT_EQ(c, b);
+
+  EXPECT_THROW((gt::gtensor_fixed<double, 2, 2>{{1., 2., 3.}, {4., 5., 6.}}),
+               std::runtime_error);
+}
+
+TEST(gtensor_fixed, dynamic_interop)
+{
+  gt::gtensor_fixed<double, 3, 2> a{{1., 2., 3.}, {4., 5., 6.}};
+  gt::gtensor<double, 2> b{{10., 20., 30.}, {40., 50., 60.}};
+
+  // fixed into dynamic, dynamic into fixed
+  gt::gtensor<double, 2> c = a + b;
+  EXPECT_EQ(c, (gt::gtensor<double, 2>{{11., 22., 33.}, {44., 55., 66.}}));
+  gt::gtensor_fixed<double, 3, 2> d = c - a;
+  EXPECT_EQ(d, b);
+
+  // broadcast into a fixed extent tensor
+  gt::gtensor<double, 2> row{{1.}, {2.}};
+  d = row;
+  EXPECT_EQ(d, (gt::gtensor<double, 2>{{1., 1., 1.}, {2., 2., 2.}}));
+
+  // shapes that don't match throw, fixed extents don't resize
+  gt::gtensor<double, 2> e(gt::shape(2, 2));
+  EXPECT_THROW(d = e, std::runtime_error);
+
+  d.fill(3.);
+  EXPECT_EQ(d, (gt::gtensor<double, 2>(gt::shape(3, 2), 3.)));
+}
+
+TEST(gtensor_fixed, view_kernel)
+{
+  gt::gtensor_fixed<int, 4, 3> a;
+  auto k_a = a.to_kernel();
+  gt::launch_host<2>(
+    a.shape(), GT_LAMBDA(int i, int j) { k_a(i, j) = i + 10 * j; });
+  EXPECT_EQ(a(3, 2), 23);
+
+  auto v = a.view(_s(1, 3), 1);
+  EXPECT_EQ(v, (gt::gtensor<int, 1>{11, 12}));
+  v = gt::gtensor<int, 1>{-1, -2};
+  EXPECT_EQ(a(1, 1), -1);
+  EXPECT_EQ(a(2, 1), -2);
+
+  const auto& ca = a;
+  auto k_ca = ca.to_kernel();
+  static_assert(std::is_same<decltype(k_ca(0, 0)), const int&>::value,
+                "const kernel");
+  EXPECT_EQ(k_ca(3, 2), 23);
+}
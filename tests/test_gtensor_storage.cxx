@@ -372,3 +372,119 @@ TEST(gtensor_storage, managed_raii)
   test_raii<gt::backend::managed_storage<double>>(100, 100);
   test_raii<gt::backend::managed_storage<gt::complex<float>>>(100, 100);
 }
+
+namespace
+{
+int n_freed = 0;
+
+void counting_free(double* p)
+{
+  delete[] p;
+  n_freed++;
+}
+} // namespace
+
+TEST(gtensor_storage, external_move)
+{
+  n_freed = 0;
+  {
+    gt::backend::external_storage<double, gt::space::host> e1(
+      new double[8], 8, counting_free);
+    EXPECT_EQ(e1.size(), 8);
+    auto* p = e1.data();
+
+    auto e2 = std::move(e1);
+    EXPECT_EQ(e1.size(), 0);
+    EXPECT_EQ(e1.data(), nullptr);
+    EXPECT_EQ(e2.data(), p);
+
+    e2.resize(4);
+    EXPECT_EQ(e2.size(), 4);
+    EXPECT_THROW(e2.resize(9), std::runtime_error);
+
+    gt::backend::external_storage<double, gt::space::host> e3(
+      new double[2], 2, counting_free);
+    e3 = std::move(e2);
+    EXPECT_EQ(n_freed, 1);
+    EXPECT_EQ(e3.data(), p);
+  }
+  EXPECT_EQ(n_freed, 2);
+}
+
+TEST(gtensor_storage, external_release)
+{
+  n_freed = 0;
+  double* p = new double[4];
+  {
+    gt::backend::external_storage<double, gt::space::host> e(p, 4,
+                                                             counting_free);
+    EXPECT_EQ(e.release(), p);
+  }
+  EXPECT_EQ(n_freed, 0);
+  delete[] p;
+}
+
+TEST(gtensor_storage, adopt)
+{
+  n_freed = 0;
+  {
+    double* p = new double[6];
+    auto a = gt::adopt(p, gt::shape(2, 3), counting_free);
+    static_assert(
+      std::is_same<gt::expr_space_type<decltype(a)>, gt::space::host>::value,
+      "adopted host buffer");
+    EXPECT_EQ(a.data(), p);
+    EXPECT_EQ(a.shape(), gt::shape(2, 3));
+
+    a = gt::full<double>({2, 3}, 1.);
+    EXPECT_EQ(p[5], 1.);
+    EXPECT_EQ(a.data(), p);
+
+    // moves without copying the data, and works in expressions
+    auto b = std::move(a);
+    EXPECT_EQ(b.data(), p);
+    gt::gtensor<double, 2> c = 2. * b + 1.;
+    EXPECT_EQ(c, gt::full<double>({2, 3}, 3.));
+    EXPECT_EQ(b.view(1, gt::all), gt::full<double>({3}, 1.));
+
+    // assigning an expression of a different, larger shape can't grow
+    EXPECT_THROW(b = gt::zeros<double>({3, 3}), std::runtime_error);
+    EXPECT_EQ(b.shape(), gt::shape(2, 3));
+    EXPECT_EQ(n_freed, 0);
+  }
+  EXPECT_EQ(n_freed, 1);
+}
+
+TEST(gtensor_storage, adopt_lambda_deleter)
+{
+  std::vector<float> pool(10, 0.f);
+  bool returned = false;
+  {
+    auto a = gt::adopt(pool.data(), gt::shape(10),
+                       [&](float* p) { returned = (p == pool.data()); });
+    a(3) = 2.f;
+  }
+  EXPECT_TRUE(returned);
+  EXPECT_EQ(pool[3], 2.f);
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(gtensor_storage, adopt_device)
+{
+  bool freed = false;
+  {
+    auto d = gt::empty_device<double>({5});
+    auto storage = std::move(d.storage());
+    double* p = gt::raw_pointer_cast(storage.data());
+
+    auto a = gt::adopt_device(p, gt::shape(5), [&](double*) { freed = true; });
+    a = gt::full_device<double>({5}, 4.);
+    gt::gtensor<double, 1> h(gt::shape(5));
+    gt::copy(a, h);
+    EXPECT_EQ(h, gt::full<double>({5}, 4.));
+  }
+  EXPECT_TRUE(freed);
+}
+
+#endif
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <gtensor/gtensor.h>
+#include <gtensor/gtensor_tiled.h>
+
+#include "test_helpers.h"
+
+using namespace gt::placeholders;
+
+namespace
+{
+
+gt::gtensor<double, 3> make_grid(const gt::shape_type<3>& shape)
+{
+  gt::gtensor<double, 3> a(shape);
+  for (int k = 0; k < shape[2]; k++) {
+    for (int j = 0; j < shape[1]; j++) {
+      for (int i = 0; i < shape[0]; i++) {
+        a(i, j, k) = 10000 * i + 100 * j + k;
+      }
+    }
+  }
+  return a;
+}
+
+} // namespace
+
+TEST(gtensor_tiled, tiled_index)
+{
+  // 5 x 3 tiles of 4 x 2, the last ones clipped
+  gt::detail::tiled_index<gt::layout::tiled<4, 2>, 2> index(gt::shape(18, 5));
+  EXPECT_EQ(index.ntiles(), gt::shape(5, 3));
+  EXPECT_EQ(index.storage_size(), 5 * 3 * 8);
+  EXPECT_EQ(index(0, 0), 0);
+  EXPECT_EQ(index(3, 0), 3);
+  EXPECT_EQ(index(0, 1), 4);
+  EXPECT_EQ(index(4, 0), 8);
+  EXPECT_EQ(index(0, 2), 5 * 8);
+  EXPECT_EQ(index(17, 4), 5 * 8 * 2 + 4 * 8 + 1);
+
+  // 4 x 4 cubes, two of them along j, 2 bits of i and j interleaved
+  gt::detail::tiled_index<gt::layout::morton, 2> z(gt::shape(4, 5));
+  EXPECT_EQ(z.storage_size(), 32);
+  EXPECT_EQ(z(1, 0), 1);
+  EXPECT_EQ(z(0, 1), 2);
+  EXPECT_EQ(z(3, 3), 15);
+  EXPECT_EQ(z(2, 1), 6);
+  EXPECT_EQ(z(0, 4), 16);
+  EXPECT_EQ(z(3, 4), 21);
+
+  // size one dimensions aren't interleaved
+  gt::detail::tiled_index<gt::layout::morton, 3> z3(gt::shape(8, 8, 1));
+  EXPECT_EQ(z3.storage_size(), 64);
+  EXPECT_EQ(z3(1, 1, 0), 3);
+  EXPECT_EQ(z3(2, 0, 0), 4);
+  EXPECT_EQ(z3(7, 7, 0), 63);
+}
+
+template <typename L>
+class gtensor_tiled_layouts : public ::testing::Test
+{};
+
+using tiled_layouts =
+  ::testing::Types<gt::layout::tiled<4, 2, 2>, gt::layout::tiled<8, 8, 1>,
+                   gt::layout::morton>;
+TYPED_TEST_SUITE(gtensor_tiled_layouts, tiled_layouts);
+
+TYPED_TEST(gtensor_tiled_layouts, convert)
+{
+  // not multiples of the tiles
+  auto a = make_grid(gt::shape(13, 7, 5));
+  gt::gtensor_tiled<double, 3, TypeParam> t(a);
+  EXPECT_EQ(t.shape(), a.shape());
+  EXPECT_EQ(t(12, 6, 4), a(12, 6, 4));
+  EXPECT_EQ(t, a);
+
+  gt::gtensor<double, 3> b(a.shape());
+  b = t;
+  EXPECT_EQ(b, a);
+
+  gt::gtensor<double, 3> c = t;
+  EXPECT_EQ(c, a);
+
+  // the kernel type, const and not
+  const auto& c_t = t;
+  gt::gtensor<double, 3> d = c_t.to_kernel();
+  EXPECT_EQ(d, a);
+  auto k_t = t.to_kernel();
+  k_t = 2. * a;
+  EXPECT_EQ(t, 2. * a);
+}
+
+TYPED_TEST(gtensor_tiled_layouts, expressions_and_views)
+{
+  auto a = make_grid(gt::shape(9, 6, 3));
+  gt::gtensor_tiled<double, 3, TypeParam> t(a);
+  gt::gtensor_tiled<double, 3, TypeParam> u(a.shape(), 1.);
+
+  gt::gtensor<double, 3> b = 2. * t + u;
+  EXPECT_EQ(b, 2. * a + 1.);
+
+  u = t - a + 3.;
+  EXPECT_EQ(u, gt::full<double>(a.shape(), 3.));
+
+  EXPECT_EQ(t.view(_s(1, 4), 2, _all), a.view(_s(1, 4), 2, _all));
+  t.view(_all, _s(_, _, 2), 1) = 0.;
+  a.view(_all, _s(_, _, 2), 1) = 0.;
+  EXPECT_EQ(t, a);
+
+  // broadcasting, both ways
+  auto k_t = t.to_kernel();
+  k_t = a.view(_all, _s(0, 1), _all);
+  EXPECT_EQ(t.view(_all, 5, _all), a.view(_all, 0, _all));
+  gt::gtensor_tiled<double, 3, TypeParam> v(gt::shape(9, 1, 3), 0.);
+  v = a.view(_all, _s(4, 5), _all);
+  gt::gtensor<double, 3> w(a.shape());
+  w.view(_all, _all, _all) = v;
+  EXPECT_EQ(w.view(_all, 2, _all), a.view(_all, 4, _all));
+  EXPECT_THROW(k_t = gt::zeros<double>(gt::shape(9, 5, 3)),
+               std::runtime_error);
+
+  // the container resizes, like gtensor
+  t = gt::zeros<double>(gt::shape(9, 5, 3));
+  EXPECT_EQ(t.shape(), gt::shape(9, 5, 3));
+  EXPECT_EQ(t, gt::zeros<double>(gt::shape(9, 5, 3)));
+}
+
+TEST(gtensor_tiled, launch_tile_order)
+{
+  using layout = gt::layout::tiled<2, 2>;
+  std::vector<int> visited;
+  gt::launch_host<2, layout>(gt::shape(3, 3), [&](int i, int j) {
+    visited.push_back(10 * i + j);
+  });
+  EXPECT_EQ(visited, (std::vector<int>{0, 10, 1, 11, 20, 21, 2, 12, 22}));
+
+  // in storage order
+  auto a = make_grid(gt::shape(11, 6, 4));
+  gt::gtensor_tiled<double, 3, gt::layout::tiled<4, 4, 2>> t(a.shape());
+  auto k_t = t.to_kernel();
+  auto k_a = a.to_kernel();
+  gt::launch_host<3, gt::layout::tiled<4, 4, 2>>(
+    a.shape(), [&](int i, int j, int k) { k_t(i, j, k) = k_a(i, j, k); });
+  EXPECT_EQ(t, a);
+}
+
+TEST(gtensor_tiled, launch_tiles)
+{
+  // reads up to two points past the tiles, in every dimension, on a grid that
+  // isn't a multiple of the tiles
+  using layout = gt::layout::tiled<4, 4, 2>;
+  auto shape = gt::shape(11, 9, 7);
+  auto a = make_grid(shape);
+  auto stencil = [](const auto& a, int i, int j, int k) {
+    return a(i - 2, j, k) + 2 * a(i + 2, j, k) + 3 * a(i, j - 2, k) +
+           4 * a(i, j + 1, k) + 5 * a(i, j, k - 1) + 6 * a(i, j, k + 2) +
+           7 * a(i + 1, j - 1, k + 1) - a(i, j, k);
+  };
+  gt::gtensor<double, 3> ref(shape, -1.);
+  for (int k = 2; k < shape[2] - 2; k++) {
+    for (int j = 2; j < shape[1] - 2; j++) {
+      for (int i = 2; i < shape[0] - 2; i++) {
+        ref(i, j, k) = stencil(a, i, j, k);
+      }
+    }
+  }
+
+  gt::gtensor_tiled<double, 3, layout> t_a(a), t_b(shape, -1.);
+  gt::launch_tiles<2>(t_b, t_a, gt::shape(2, 2, 2), gt::shape(9, 7, 5),
+                      [&](const auto& o, const auto& a, int i, int j, int k) {
+                        o(i, j, k) = stencil(a, i, j, k);
+                      });
+  EXPECT_EQ(t_b, ref);
+
+  gt::gtensor_tiled<double, 3, layout> t_c(gt::shape(11, 9, 6));
+  auto noop = [](const auto&, const auto&, int, int, int) {};
+  EXPECT_THROW(gt::launch_tiles<2>(t_c, t_a, gt::shape(2, 2, 2),
+                                   gt::shape(9, 7, 5), noop),
+               std::runtime_error);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/gtensor.h>
+#include <gtensor/hash.h>
+
+#include "test_debug.h"
+
+using namespace gt::placeholders;
+
+TEST(hash, deterministic)
+{
+  gt::gtensor<double, 2> a(gt::shape(3, 4));
+  gt::gtensor<double, 2> b(gt::shape(3, 4));
+  for (int j = 0; j < 4; j++) {
+    for (int i = 0; i < 3; i++) {
+      a(i, j) = 10 * j + i;
+      b(i, j) = 10 * j + i;
+    }
+  }
+  EXPECT_EQ(gt::hash(a), gt::hash(b));
+
+  b(2, 3) = 0.5;
+  EXPECT_NE(gt::hash(a), gt::hash(b));
+}
+
+TEST(hash, view_matches_container)
+{
+  gt::gtensor<float, 3> a(gt::shape(50, 60, 7));
+  auto flat = gt::flatten(a);
+  for (int i = 0; i < flat.shape(0); i++) {
+    flat(i) = i % 1000;
+  }
+  auto v = a.view(_s(1, _, 2), _s(3, -3), _s(_, _, -1));
+  gt::gtensor<float, 3> c = v;
+
+  EXPECT_EQ(gt::hash(v), gt::hash(c));
+  EXPECT_EQ(gt::hash(a + 1.f), gt::hash(gt::eval(a + 1.f)));
+  EXPECT_NE(gt::hash(a), gt::hash(a + 1.f));
+}
+
+TEST(hash, shape_and_type)
+{
+  gt::gtensor<int, 1> a(gt::shape(12), 3);
+  gt::gtensor<int, 2> b(gt::shape(3, 4), 3);
+  gt::gtensor<int, 2> c(gt::shape(4, 3), 3);
+  gt::gtensor<double, 1> d(gt::shape(12), 3.);
+
+  EXPECT_NE(gt::hash(a), gt::hash(b));
+  EXPECT_NE(gt::hash(b), gt::hash(c));
+  EXPECT_NE(gt::hash(a), gt::hash(d));
+  EXPECT_NE(gt::hash(gt::gtensor<int, 1>(gt::shape(0))),
+            gt::hash(gt::gtensor<int, 1>(gt::shape(1), 0)));
+}
+
+TEST(hash, element_order)
+{
+  // swapping two elements in different blocks / lanes changes the hash
+  gt::gtensor<double, 1> a(gt::shape(10000));
+  for (int i = 0; i < a.shape(0); i++) {
+    a(i) = i;
+  }
+  auto h = gt::hash(a);
+  std::swap(a(1), a(9000));
+  EXPECT_NE(gt::hash(a), h);
+  std::swap(a(1), a(9000));
+  EXPECT_EQ(gt::hash(a), h);
+  std::swap(a(4), a(5));
+  EXPECT_NE(gt::hash(a), h);
+}
+
+TEST(hash, complex)
+{
+  gt::gtensor<gt::complex<double>, 1> a(gt::shape(5),
+                                        gt::complex<double>(1., 2.));
+  gt::gtensor<gt::complex<double>, 1> b(gt::shape(5),
+                                        gt::complex<double>(1., 3.));
+  EXPECT_NE(gt::hash(a), gt::hash(b));
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(hash, device_matches_host)
+{
+  gt::gtensor<double, 2> h_a(gt::shape(300, 40));
+  auto flat = gt::flatten(h_a);
+  for (int i = 0; i < flat.shape(0); i++) {
+    flat(i) = 0.5 * i;
+  }
+  gt::gtensor_device<double, 2> d_a(h_a.shape());
+  gt::copy(h_a, d_a);
+
+  EXPECT_EQ(gt::hash(d_a), gt::hash(h_a));
+  EXPECT_EQ(gt::hash(d_a.view(_s(1, -1), _all)),
+            gt::hash(h_a.view(_s(1, -1), _all)));
+}
+
+#endif
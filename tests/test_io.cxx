@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/gtensor.h>
+
+#include <gt-io/io.h>
+#include <gt-io/parallel.h>
+
+#include "test_debug.h"
+#include "test_io_helpers.h"
+
+using namespace gt::placeholders;
+
+using gt::test::iota;
+using gt::test::tmp_path;
+
+TEST(io, write_read_container)
+{
+  auto a = iota<double>(gt::shape(3, 4));
+  tmp_path f;
+
+  EXPECT_EQ(gt::io::write(f.fd(), a), a.size() * sizeof(double));
+  EXPECT_EQ(f.contents<double>(), gt::flatten(a));
+
+  gt::gtensor<double, 2> b(a.shape(), -1.);
+  f.rewind();
+  EXPECT_EQ(gt::io::read(f.fd(), b), b.size() * sizeof(double));
+  EXPECT_EQ(a, b);
+}
+
+TEST(io, write_view_4d)
+{
+  auto f = iota<float>(gt::shape(5, 8, 3, 7));
+  auto v = f.view(_all, _s(2, -2), _all, 5);
+  tmp_path file;
+
+  gt::io::write(file.fd(), v);
+  EXPECT_EQ(file.contents<float>(), gt::flatten(gt::eval(v)));
+}
+
+TEST(io, write_view_long_runs)
+{
+  // inner runs larger than the direct I/O threshold, written without copy
+  auto f = iota<double>(gt::shape(1100, 6, 3));
+  auto v = f.view(_all, _s(1, -1), _s(1, 3));
+  tmp_path file;
+
+  gt::io::write(file.fd(), v);
+  EXPECT_EQ(file.contents<double>(), gt::flatten(gt::eval(v)));
+}
+
+TEST(io, write_view_strided_inner)
+{
+  // no contiguous runs at all: inner stride 2 and negative outer step
+  auto f = iota<int>(gt::shape(10, 6));
+  auto v = f.view(_s(1, _, 2), _s(_, _, -1));
+  tmp_path file;
+
+  gt::io::write(file.fd(), v);
+  EXPECT_EQ(file.contents<int>(), gt::flatten(gt::eval(v)));
+}
+
+TEST(io, write_nested_view)
+{
+  auto f = iota<double>(gt::shape(4, 5, 6));
+  auto v = f.view(_s(1, 3), _all, _all).view(_all, 2, _s(1, -1));
+  tmp_path file;
+
+  gt::io::write(file.fd(), v);
+  EXPECT_EQ(file.contents<double>(), gt::flatten(gt::eval(v)));
+}
+
+TEST(io, write_expression)
+{
+  auto a = iota<double>(gt::shape(3, 4));
+  tmp_path file;
+
+  gt::io::write(file.fd(), 2. * a);
+  EXPECT_EQ(file.contents<double>(), gt::flatten(gt::eval(2. * a)));
+}
+
+TEST(io, read_into_view)
+{
+  auto src = iota<double>(gt::shape(5, 4, 3));
+  gt::gtensor<double, 4> dst(gt::shape(5, 8, 3, 7), -1.);
+  auto v = dst.view(_all, _s(2, -2), _all, 5);
+  tmp_path file;
+
+  gt::io::write(file.fd(), src);
+  file.rewind();
+  gt::io::read(file.fd(), v);
+
+  EXPECT_EQ(v, src);
+  EXPECT_EQ(dst(0, 0, 0, 0), -1.);
+  EXPECT_EQ(dst(0, 2, 0, 4), -1.);
+  EXPECT_EQ(dst(0, 6, 0, 5), -1.);
+}
+
+TEST(io, read_into_strided_span)
+{
+  auto src = iota<double>(gt::shape(5, 3));
+  gt::gtensor<double, 2> dst(gt::shape(10, 3), 0.);
+  auto s = gt::view_strided(dst, _s(_, _, 2), _all);
+  tmp_path file;
+
+  gt::io::write(file.fd(), src);
+  file.rewind();
+  gt::io::read(file.fd(), s);
+
+  EXPECT_EQ(dst.view(_s(_, _, 2), _all), src);
+  EXPECT_EQ(dst.view(_s(1, _, 2), _all), gt::zeros<double>({5, 3}));
+}
+
+TEST(io, read_short_file)
+{
+  gt::gtensor<double, 1> a(gt::shape(4), 1.);
+  gt::gtensor<double, 1> b(gt::shape(8));
+  tmp_path file;
+
+  gt::io::write(file.fd(), a);
+  file.rewind();
+  EXPECT_THROW(gt::io::read(file.fd(), b), std::runtime_error);
+}
+
+TEST(io, write_read_parallel)
+{
+  auto a = iota<double>(gt::shape(6, 5, 7));
+  tmp_path file;
+
+  EXPECT_EQ(gt::io::write_parallel(file.fd(), a, 0, 3),
+            a.size() * sizeof(double));
+  EXPECT_EQ(file.contents<double>(), gt::flatten(a));
+
+  gt::gtensor<double, 3> b(a.shape(), -1.);
+  gt::io::read_parallel(file.fd(), b, 0, 4);
+  EXPECT_EQ(a, b);
+}
+
+TEST(io, write_parallel_view_at_offset)
+{
+  auto f = iota<float>(gt::shape(5, 8, 3, 7));
+  auto v = f.view(_s(1, _, 2), _s(2, -2), _all, _s(1, 6));
+  tmp_path file;
+
+  gt::io::write_parallel(file.fd(), v, 4 * sizeof(float), 4);
+  auto h = file.contents<float>();
+  EXPECT_EQ(h.view(_s(4, _)), gt::flatten(gt::eval(v)));
+
+  // matches the serial path
+  tmp_path serial;
+  gt::gtensor<float, 1> pad(gt::shape(4), 0.f);
+  gt::io::write(serial.fd(), pad);
+  gt::io::write(serial.fd(), v);
+  EXPECT_EQ(serial.contents<float>(), h);
+
+  gt::gtensor<float, 4> g(f.shape(), -1.f);
+  auto w = g.view(_s(1, _, 2), _s(2, -2), _all, _s(1, 6));
+  gt::io::read_parallel(file.fd(), w, 4 * sizeof(float), 3);
+  EXPECT_EQ(w, v);
+  EXPECT_EQ(g(0, 0, 0, 0), -1.f);
+}
+
+TEST(io, write_parallel_more_threads_than_slabs)
+{
+  auto a = iota<int>(gt::shape(100, 2));
+  tmp_path file;
+
+  gt::io::write_parallel(file.fd(), a + 1, 0, 8);
+  EXPECT_EQ(file.contents<int>(), gt::flatten(gt::eval(a + 1)));
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/gtensor.h>
+
+#include <gt-io/chunked.h>
+
+#include "test_debug.h"
+#include "test_io_helpers.h"
+
+using namespace gt::placeholders;
+
+using gt::test::iota;
+using gt::test::tmp_path;
+
+TEST(io_chunked, write_read_all)
+{
+  auto a = iota<double>(gt::shape(7, 5, 4));
+  tmp_path path;
+
+  gt::io::write_chunked(path.str(), a, gt::shape(3, 2, 4), 3);
+
+  gt::io::chunked_reader<double, 3> reader(path.str());
+  EXPECT_EQ(reader.shape(), a.shape());
+  EXPECT_EQ(reader.chunk_shape(), gt::shape(3, 2, 4));
+  EXPECT_EQ(reader.n_chunks(), 3 * 3 * 1);
+  EXPECT_EQ(reader.read(), a);
+}
+
+TEST(io_chunked, compresses)
+{
+  gt::gtensor<float, 2> a(gt::shape(256, 64), 1.f);
+  tmp_path path;
+
+  gt::io::write_chunked(path.str(), a, gt::shape(64, 16));
+  EXPECT_LT(path.size(), a.size() * sizeof(float) / 10);
+
+  gt::io::chunked_reader<float, 2> reader(path.str());
+  EXPECT_EQ(reader.read(), a);
+}
+
+TEST(io_chunked, incompressible)
+{
+  // chunks that don't shrink are stored raw
+  gt::gtensor<std::uint32_t, 1> a(gt::shape(1000));
+  std::uint32_t x = 12345;
+  for (int i = 0; i < a.shape(0); i++) {
+    x = x * 1664525u + 1013904223u;
+    a(i) = x;
+  }
+  tmp_path path;
+
+  gt::io::write_chunked(path.str(), a, gt::shape(100));
+  gt::io::chunked_reader<std::uint32_t, 1> reader(path.str());
+  EXPECT_EQ(reader.read(), a);
+}
+
+TEST(io_chunked, read_hyperslab_6d)
+{
+  gt::gtensor<double, 6> a6(gt::shape(4, 3, 5, 2, 3, 4));
+  gt::flatten(a6) = gt::arange<double>(0, a6.size());
+  tmp_path path;
+
+  gt::io::write_chunked(path.str(), a6, gt::shape(2, 2, 2, 1, 2, 3), 2);
+
+  gt::io::chunked_reader<double, 6> reader(path.str());
+  gt::gtensor<double, 6> slab(gt::shape(2, 2, 3, 1, 2, 2));
+  reader.read(gt::shape(1, 1, 1, 1, 0, 1), slab);
+  EXPECT_EQ(slab, a6.view(_s(1, 3), _s(1, 3), _s(1, 4), _s(1, 2), _s(0, 2),
+                          _s(1, 3)));
+}
+
+TEST(io_chunked, read_into_view)
+{
+  gt::gtensor<int, 2> a(gt::shape(9, 10));
+  for (int j = 0; j < a.shape(1); j++) {
+    for (int i = 0; i < a.shape(0); i++) {
+      a(i, j) = 100 * j + i;
+    }
+  }
+  tmp_path path;
+  gt::io::write_chunked(path.str(), a.view(_s(1, _), _all), gt::shape(4, 4));
+
+  gt::io::chunked_reader<int, 2> reader(path.str());
+  EXPECT_EQ(reader.shape(), gt::shape(8, 10));
+  gt::gtensor<int, 2> dst(gt::shape(6, 4), -1);
+  reader.read(gt::shape(3, 5), dst.view(_s(_, _, 2), _all));
+  EXPECT_EQ(dst.view(_s(_, _, 2), _all), a.view(_s(4, 7), _s(5, 9)));
+  EXPECT_EQ(dst.view(_s(1, _, 2), _all), gt::full<int>({3, 4}, -1));
+}
+
+TEST(io_chunked, write_expression)
+{
+  gt::gtensor<double, 2> a(gt::shape(5, 6), 2.);
+  tmp_path path;
+
+  gt::io::write_chunked(path.str(), a + a, gt::shape(5, 2));
+  gt::io::chunked_reader<double, 2> reader(path.str());
+  EXPECT_EQ(reader.read(), gt::full<double>({5, 6}, 4.));
+}
+
+TEST(io_chunked, errors)
+{
+  gt::gtensor<double, 2> a(gt::shape(5, 6), 2.);
+  tmp_path path;
+  gt::io::write_chunked(path.str(), a, gt::shape(5, 2));
+
+  EXPECT_THROW((gt::io::chunked_reader<float, 2>(path.str())),
+               std::runtime_error);
+  EXPECT_THROW((gt::io::chunked_reader<double, 3>(path.str())),
+               std::runtime_error);
+
+  gt::io::chunked_reader<double, 2> reader(path.str());
+  gt::gtensor<double, 2> slab(gt::shape(2, 2));
+  EXPECT_THROW(reader.read(gt::shape(4, 0), slab), std::runtime_error);
+}
@@ -0,0 +1,85 @@
+#ifndef TEST_IO_HELPERS_H
+#define TEST_IO_HELPERS_H
+
+#include <cstdio>
+#include <string>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gtensor/gtensor.h>
+
+#include <gtest/gtest.h>
+
+namespace gt
+{
+
+namespace test
+{
+
+// temporary file, opened read / write and removed when going out of scope
+class tmp_path
+{
+public:
+  tmp_path()
+  {
+    char name[] = "/tmp/gtensor_test_XXXXXX";
+    fd_ = mkstemp(name);
+    EXPECT_GE(fd_, 0);
+    path_ = name;
+  }
+  ~tmp_path()
+  {
+    close(fd_);
+    std::remove(path_.c_str());
+  }
+
+  tmp_path(const tmp_path&) = delete;
+  tmp_path& operator=(const tmp_path&) = delete;
+
+  const std::string& str() const { return path_; }
+  int fd() const { return fd_; }
+
+  void rewind() const { lseek(fd_, 0, SEEK_SET); }
+
+  off_t size() const { return lseek(fd_, 0, SEEK_END); }
+
+  // read back raw file contents as elements of type T
+  template <typename T>
+  gt::gtensor<T, 1> contents() const
+  {
+    return contents<T>(gt::shape(size() / sizeof(T)));
+  }
+
+  template <typename T, gt::size_type N>
+  gt::gtensor<T, N> contents(const gt::shape_type<N>& shape,
+                             off_t offset = 0) const
+  {
+    gt::gtensor<T, N> h(shape);
+    EXPECT_EQ(pread(fd_, h.data(), h.size() * sizeof(T), offset),
+              h.size() * sizeof(T));
+    return h;
+  }
+
+private:
+  std::string path_;
+  int fd_;
+};
+
+// tensor holding scale * its linear index
+template <typename T, gt::size_type N>
+gt::gtensor<T, N> iota(const gt::shape_type<N>& shape, T scale = 1)
+{
+  gt::gtensor<T, N> a(shape);
+  auto flat = gt::flatten(a);
+  for (int i = 0; i < flat.shape(0); i++) {
+    flat(i) = scale * T(i);
+  }
+  return a;
+}
+
+} // namespace test
+
+} // namespace gt
+
+#endif // TEST_IO_HELPERS_H
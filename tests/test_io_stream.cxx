@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/gtensor.h>
+
+#include <gt-io/stream.h>
+
+#include "test_debug.h"
+#include "test_io_helpers.h"
+
+using namespace gt::placeholders;
+
+using gt::test::iota;
+using gt::test::tmp_path;
+
+TEST(io_stream, mapped_file)
+{
+  auto a = iota<double>(gt::shape(4, 3, 10));
+  tmp_path path;
+  gt::io::write(path.fd(), a);
+
+  gt::io::mapped_file<double, 3> m(path.str(), a.shape());
+  EXPECT_EQ(m.span(), a);
+  EXPECT_EQ(m.slab(2, 7), a.view(_all, _all, _s(2, 7)));
+  m.will_need(0, 10);
+  m.dont_need(0, 5);
+  EXPECT_EQ(m.slab(0, 5), a.view(_all, _all, _s(0, 5)));
+
+  EXPECT_THROW(
+    (gt::io::mapped_file<double, 3>(path.str(), gt::shape(4, 3, 11))),
+    std::runtime_error);
+}
+
+TEST(io_stream, stream_eval)
+{
+  auto shape = gt::shape(5, 4, 23);
+  auto a = iota<double>(shape);
+  auto b = iota<double>(shape, 0.5);
+  tmp_path path_a, path_b, path_out;
+  gt::io::write(path_a.fd(), a);
+  gt::io::write(path_b.fd(), b);
+
+  gt::io::mapped_file<double, 3> ma(path_a.str(), shape);
+  gt::io::mapped_file<double, 3> mb(path_b.str(), shape);
+  gt::io::stream_eval<double>(
+    path_out.fd(), shape, 4,
+    [](const auto& a, const auto& b, int begin, int end) {
+      return 2. * a + b;
+    },
+    0, ma, mb);
+
+  EXPECT_EQ((path_out.contents<double>(shape)), gt::eval(2. * a + b));
+}
+
+TEST(io_stream, stream_eval_views_and_offset)
+{
+  // inputs of different rank, and a result of different shape than the
+  // inputs, written after a header
+  auto a = iota<float>(gt::shape(6, 4, 9));
+  auto w = iota<float>(gt::shape(9));
+  tmp_path path_a, path_w, path_out;
+  gt::io::write(path_a.fd(), a);
+  gt::io::write(path_w.fd(), w);
+
+  gt::io::mapped_file<float, 3> ma(path_a.str(), a.shape());
+  gt::io::mapped_file<float, 1> mw(path_w.str(), w.shape());
+  auto shape_out = gt::shape(4, 2, 9);
+  gt::io::stream_eval<float>(
+    path_out.fd(), shape_out, 2,
+    [](const auto& a, const auto& w, int begin, int end) {
+      return a.view(_s(1, 5), _s(_, _, 2), _all) *
+             w.view(_newaxis, _newaxis, _all);
+    },
+    16, ma, mw);
+
+  auto expected = gt::eval(a.view(_s(1, 5), _s(_, _, 2), _all) *
+                           w.view(_newaxis, _newaxis, _all));
+  EXPECT_EQ((path_out.contents<float>(shape_out, 16)), expected);
+}
+
+TEST(io_stream, stream_eval_generator)
+{
+  // no inputs, the chunk bounds are enough to generate the result
+  auto shape = gt::shape(3, 10);
+  tmp_path path_out;
+  gt::io::stream_eval<int>(
+    path_out.fd(), shape, 3,
+    [](int begin, int end) { return gt::full<int>({3, end - begin}, begin); },
+    0);
+
+  gt::gtensor<int, 2> expected(shape);
+  for (int j = 0; j < 10; j++) {
+    for (int i = 0; i < 3; i++) {
+      expected(i, j) = j / 3 * 3;
+    }
+  }
+  EXPECT_EQ((path_out.contents<int>(shape)), expected);
+}
+
+TEST(io_stream, stream_eval_mismatch)
+{
+  auto a = iota<double>(gt::shape(2, 5));
+  tmp_path path_a, path_out;
+  gt::io::write(path_a.fd(), a);
+  gt::io::mapped_file<double, 2> ma(path_a.str(), a.shape());
+
+  EXPECT_THROW(gt::io::stream_eval<double>(
+                 path_out.fd(), gt::shape(2, 6), 2,
+                 [](const auto& a, int, int) { return a; }, 0, ma),
+               std::runtime_error);
+}
@@ -72,6 +72,27 @@ TEST(gtensor, launch_view_reverse_1d)
   EXPECT_EQ(b, (gt::gtensor<double, 1>{13., 12., 11.}));
 }
 
+TEST(gtensor, launch_7d)
+{
+  gt::gtensor<int, 7> a(gt::shape(2, 3, 2, 1, 3, 2, 2));
+  int* adata = a.data();
+  for (int i = 0; i < a.size(); i++) {
+    adata[i] = i;
+  }
+  gt::gtensor<int, 7> b(a.shape());
+
+  auto k_a = a.to_kernel();
+  auto k_b = b.to_kernel();
+  gt::launch_host<7>(
+    a.shape(), GT_LAMBDA(int i, int j, int k, int l, int m, int n, int o) {
+      k_b(i, j, k, l, m, n, o) = k_a(i, j, k, l, m, n, o) + 1;
+    });
+
+  for (int i = 0; i < a.size(); i++) {
+    EXPECT_EQ(b.data()[i], i + 1);
+  }
+}
+
 #ifdef GTENSOR_HAVE_DEVICE
 
 void device_double_add_1d(gt::gtensor_device<double, 1>& a,
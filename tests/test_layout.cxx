@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <gtensor/gtensor.h>
+
+#include "test_helpers.h"
+
+using namespace gt::placeholders;
+
+using row_major = gt::layout::row_major;
+
+TEST(layout, strides)
+{
+  auto shape = gt::shape(2, 3, 4);
+  EXPECT_EQ(gt::calc_strides(shape, gt::layout::column_major{}),
+            gt::shape(1, 2, 6));
+  EXPECT_EQ(gt::calc_strides(shape, row_major{}), gt::shape(12, 4, 1));
+  EXPECT_EQ(gt::calc_strides(shape, gt::layout::ordered<1, 0, 2>{}),
+            gt::shape(3, 1, 6));
+
+  gt::gtensor<double, 3, gt::space::host, row_major> a(shape);
+  EXPECT_EQ(a.strides(), gt::shape(12, 4, 1));
+  EXPECT_FALSE(a.is_f_contiguous());
+
+  // size one dimensions don't matter
+  gt::gtensor<double, 2, gt::space::host, row_major> b(gt::shape(5, 1));
+  EXPECT_TRUE(b.is_f_contiguous());
+}
+
+TEST(layout, row_major_container)
+{
+  gt::gtensor<int, 2, gt::space::host, row_major> a{{1, 2, 3}, {4, 5, 6}};
+  EXPECT_EQ(a.shape(), gt::shape(3, 2));
+  EXPECT_EQ(a(2, 0), 3);
+  EXPECT_EQ(a(0, 1), 4);
+
+  // stored C order, i.e., the (row, col) = (j, i) elements one row at a time
+  std::vector<int> expected = {1, 4, 2, 5, 3, 6};
+  for (int n = 0; n < 6; n++) {
+    EXPECT_EQ(a.data()[n], expected[n]);
+  }
+
+  EXPECT_EQ(a, (gt::gtensor<int, 2>{{1, 2, 3}, {4, 5, 6}}));
+}
+
+TEST(layout, assign_across_layouts)
+{
+  const int nx = 5, ny = 4, nz = 3;
+  gt::gtensor<double, 3> a(gt::shape(nx, ny, nz));
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        a(i, j, k) = 100 * i + 10 * j + k;
+      }
+    }
+  }
+
+  gt::gtensor<double, 3, gt::space::host, row_major> b(a.shape());
+  b = a;
+  EXPECT_EQ(b, a);
+  EXPECT_EQ(b.data()[1], a(0, 0, 1));
+
+  gt::gtensor<double, 3, gt::space::host, gt::layout::ordered<2, 0, 1>> c =
+    2. * b + a;
+  EXPECT_EQ(c, 3. * a);
+  EXPECT_EQ(c.data()[1], 3. * a(0, 0, 1));
+  EXPECT_EQ(c.data()[nz], 3. * a(1, 0, 0));
+
+  // views, broadcasting
+  gt::gtensor<double, 3, gt::space::host, row_major> d(a.shape(), 0.);
+  d.view(_s(1, 3), _all, _all) = a.view(_s(0, 2), _all, _all);
+  EXPECT_EQ(d.view(_s(1, 3), _all, _all), a.view(_s(0, 2), _all, _all));
+  EXPECT_EQ(d.view(0, _all, _all), gt::zeros<double>(gt::shape(ny, nz)));
+  d.view(_all, _all, _all) = a.view(_all, 1, _newaxis, _all);
+  for (int j = 0; j < ny; j++) {
+    EXPECT_EQ(d.view(_all, j, _all), a.view(_all, 1, _all));
+  }
+
+  gt::gtensor<double, 5, gt::space::host, row_major> e(
+    gt::shape(2, 3, 1, 2, 2));
+  gt::gtensor<double, 5> f(e.shape());
+  for (int n = 0; n < f.size(); n++) {
+    f.data()[n] = n;
+  }
+  e = f;
+  EXPECT_EQ(e, f);
+  e = f.view(_all, _all, _all, _all, _s(_, _, -1));
+  EXPECT_EQ(e, f.view(_all, _all, _all, _all, _s(_, _, -1)));
+}
+
+TEST(layout, copy)
+{
+  gt::gtensor<int, 2, gt::space::host, row_major> a{{1, 2, 3}, {4, 5, 6}};
+  gt::gtensor<int, 2, gt::space::host, row_major> b(a.shape());
+  gt::copy(a, b);
+  EXPECT_EQ(b, a);
+
+  gt::gtensor<int, 2> c(a.shape());
+  gt::copy(a, c);
+  EXPECT_EQ(c, a);
+  gt::gtensor<int, 2, gt::space::host, row_major> d(a.shape());
+  gt::copy(2 * c, d);
+  EXPECT_EQ(d, 2 * a);
+}
+
+TEST(layout, span_and_adapt)
+{
+  gt::gtensor<int, 2, gt::space::host, row_major> a{{1, 2, 3}, {4, 5, 6}};
+  gt::gtensor_span<int, 2> s = a;
+  EXPECT_EQ(s.strides(), a.strides());
+  EXPECT_EQ(s, a);
+  s(1, 1) = 7;
+  EXPECT_EQ(a(1, 1), 7);
+
+  int c_array[2][3] = {{1, 2, 3}, {4, 5, 6}};
+  auto c = gt::adapt<2>(&c_array[0][0], gt::shape(2, 3), row_major{});
+  EXPECT_EQ(c(0, 2), 3);
+  EXPECT_EQ(c(1, 0), 4);
+  EXPECT_EQ(c.strides(), gt::shape(3, 1));
+}
+
+TEST(layout, launch_host)
+{
+  const int nx = 3, ny = 4, nz = 2;
+  std::vector<int> visited;
+  gt::launch_host<3, row_major>(
+    gt::shape(nx, ny, nz),
+    [&](int i, int j, int k) { visited.push_back(100 * i + 10 * j + k); });
+
+  std::vector<int> expected;
+  for (int i = 0; i < nx; i++) {
+    for (int j = 0; j < ny; j++) {
+      for (int k = 0; k < nz; k++) {
+        expected.push_back(100 * i + 10 * j + k);
+      }
+    }
+  }
+  EXPECT_EQ(visited, expected);
+
+  gt::gtensor<double, 3, gt::space::host, gt::layout::ordered<1, 2, 0>> a(
+    gt::shape(nx, ny, nz));
+  auto k_a = a.to_kernel();
+  gt::launch<3, gt::space::host, gt::layout::ordered<1, 2, 0>>(
+    a.shape(), [=](int i, int j, int k) mutable { k_a(i, j, k) = i + j + k; });
+  for (int n = 0; n < a.size(); n++) {
+    EXPECT_EQ(a.data()[n], n % ny + (n / ny) % nz + n / (ny * nz));
+  }
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(layout, device_row_major)
+{
+  gt::gtensor<double, 2, gt::space::host, row_major> h_a{{1., 2., 3.},
+                                                         {4., 5., 6.}};
+  gt::gtensor<double, 2, gt::space::device, row_major> a(h_a.shape());
+  gt::copy(h_a, a);
+
+  gt::gtensor<double, 2, gt::space::device, row_major> b(a.shape());
+  auto k_a = a.to_kernel();
+  auto k_b = b.to_kernel();
+  gt::launch<2, gt::space::device, row_major>(
+    a.shape(), GT_LAMBDA(int i, int j) { k_b(i, j) = 2. * k_a(i, j); });
+
+  gt::gtensor<double, 2, gt::space::host, row_major> h_b(b.shape());
+  gt::copy(b, h_b);
+  EXPECT_EQ(h_b, 2. * h_a);
+}
+
+#endif
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/gtensor.h>
+#include <gtensor/segmented.h>
+
+#include "test_helpers.h"
+
+using namespace gt::placeholders;
+
+namespace
+{
+
+gt::gtensor<double, 3> make_grid(const gt::shape_type<3>& shape)
+{
+  gt::gtensor<double, 3> a(shape);
+  for (int k = 0; k < shape[2]; k++) {
+    for (int j = 0; j < shape[1]; j++) {
+      for (int i = 0; i < shape[0]; i++) {
+        a(i, j, k) = 10000 * i + 100 * j + k;
+      }
+    }
+  }
+  return a;
+}
+
+} // namespace
+
+TEST(segmented, roll_1d)
+{
+  gt::gtensor<double, 1> a{1., 2., 3., 4., 5.};
+
+  EXPECT_EQ(gt::eval(gt::roll(a, 2, 0)),
+            (gt::gtensor<double, 1>{4., 5., 1., 2., 3.}));
+  EXPECT_EQ(gt::eval(gt::roll(a, -1, 0)),
+            (gt::gtensor<double, 1>{2., 3., 4., 5., 1.}));
+  EXPECT_EQ(gt::eval(gt::roll(a, 7, 0)), gt::eval(gt::roll(a, 2, 0)));
+  EXPECT_EQ(gt::eval(gt::roll(a, 0, 0)), a);
+  EXPECT_THROW(gt::roll(a, 1, 1), std::runtime_error);
+}
+
+TEST(segmented, roll_3d)
+{
+  auto a = make_grid(gt::shape(7, 5, 4));
+  auto shifts = gt::shape(2, -1, 3);
+  auto r = gt::roll(a, shifts);
+  EXPECT_EQ(r.shape(), a.shape());
+
+  // in segments, and element by element
+  gt::gtensor<double, 3> b = r;
+  gt::gtensor<double, 3> c = 1. * r;
+  for (int k = 0; k < 4; k++) {
+    for (int j = 0; j < 5; j++) {
+      for (int i = 0; i < 7; i++) {
+        const double expected = a((i + 5) % 7, (j + 1) % 5, (k + 1) % 4);
+        EXPECT_EQ(r(i, j, k), expected);
+        EXPECT_EQ(b(i, j, k), expected);
+        EXPECT_EQ(c(i, j, k), expected);
+      }
+    }
+  }
+
+  // rolls of rolls fold into one roll, and of expressions
+  auto rr = gt::roll(gt::roll(a, 2, 0), -1, 1);
+  static_assert(std::is_same<decltype(rr), decltype(r)>::value,
+                "roll of roll should fold");
+  EXPECT_EQ(rr.shifts(), gt::shape(2, 4, 0));
+  gt::gtensor<double, 3> d = rr;
+  EXPECT_EQ(d, gt::roll(a, gt::shape(2, -1, 0)));
+  gt::gtensor<double, 3> d2 = gt::roll(r, gt::shape(-2, 1, 1));
+  EXPECT_EQ(d2, a);
+  gt::gtensor<double, 3> e = gt::roll(2. * a, shifts);
+  EXPECT_EQ(e, 2. * b);
+  auto r2 = gt::roll(2. * a, 1, 0);
+  gt::gtensor<double, 3> e2 = gt::roll(r2, 1, 0);
+  EXPECT_EQ(e2, 2. * gt::roll(a, 2, 0));
+  gt::gtensor<double, 3> e3 = gt::roll(gt::roll(2. * a, 1, 0), 1, 0);
+  EXPECT_EQ(e3, e2);
+}
+
+TEST(segmented, roll_into_view)
+{
+  auto a = make_grid(gt::shape(6, 4, 1));
+  gt::gtensor<double, 3> b(gt::shape(8, 4, 3), -1.);
+
+  // broadcast along the last dimension
+  b.view(_s(1, -1), _all, _all) = gt::roll(a, 1, 1);
+  for (int k = 0; k < 3; k++) {
+    EXPECT_EQ(b.view(_s(1, -1), _all, k),
+              gt::roll(a, 1, 1).view(_all, _all, 0));
+  }
+  EXPECT_EQ(b.view(0, _all, _all), gt::full<double>(gt::shape(4, 3), -1.));
+  EXPECT_EQ(b.view(7, _all, _all), gt::full<double>(gt::shape(4, 3), -1.));
+}
+
+TEST(segmented, concatenate)
+{
+  gt::gtensor<int, 2> a{{1, 2, 3}, {4, 5, 6}};
+  gt::gtensor<int, 2> b{{7, 8, 9}};
+
+  auto c = gt::concatenate(a, b, 1);
+  EXPECT_EQ(c.shape(), gt::shape(3, 3));
+  EXPECT_EQ(gt::eval(c),
+            (gt::gtensor<int, 2>{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}}));
+  EXPECT_EQ(gt::eval(1 * c), gt::eval(c));
+
+  gt::gtensor<int, 2> d = gt::concatenate(a, 2 * a);
+  EXPECT_EQ(d, (gt::gtensor<int, 2>{{1, 2, 3, 2, 4, 6}, {4, 5, 6, 8, 10, 12}}));
+
+  // more than two
+  gt::gtensor<int, 2> e = gt::concatenate(gt::concatenate(b, a, 1), b, 1);
+  EXPECT_EQ(e, (gt::gtensor<int, 2>{
+                 {7, 8, 9}, {1, 2, 3}, {4, 5, 6}, {7, 8, 9}}));
+  gt::gtensor<int, 2> f(e.shape());
+  f = 1 * gt::concatenate(gt::concatenate(b, a, 1), b, 1);
+  EXPECT_EQ(f, e);
+
+  EXPECT_THROW(gt::concatenate(a, b, 0), std::runtime_error);
+  EXPECT_THROW(gt::concatenate(a, b, 2), std::runtime_error);
+}
+
+TEST(segmented, concatenate_mixed)
+{
+  auto a = make_grid(gt::shape(5, 3, 4));
+  gt::gtensor<float, 3> b(gt::shape(5, 2, 4), 1.f);
+
+  auto c = gt::concatenate(a.view(_all, _s(1, _), _all), b, 1);
+  static_assert(std::is_same<decltype(c)::value_type, double>::value, "");
+  gt::gtensor<double, 3> d = c;
+  EXPECT_EQ(d.shape(), gt::shape(5, 4, 4));
+  EXPECT_EQ(d.view(_all, _s(0, 2), _all), a.view(_all, _s(1, _), _all));
+  EXPECT_EQ(d.view(_all, _s(2, _), _all), gt::full<double>(b.shape(), 1.));
+}
+
+TEST(segmented, pad)
+{
+  gt::gtensor<double, 2> a{{1., 2.}, {3., 4.}};
+
+  auto p = gt::pad(a, gt::shape(1, 0), gt::shape(2, 1));
+  EXPECT_EQ(p.shape(), gt::shape(5, 3));
+  gt::gtensor<double, 2> expected{
+    {0., 1., 2., 0., 0.}, {0., 3., 4., 0., 0.}, {0., 0., 0., 0., 0.}};
+  EXPECT_EQ(gt::eval(p), expected);
+  gt::gtensor<double, 2> b = p;
+  EXPECT_EQ(b, expected);
+
+  gt::gtensor<double, 2> c = gt::pad(a, gt::shape(1, 1), -1.);
+  EXPECT_EQ(c, (gt::gtensor<double, 2>{{-1., -1., -1., -1.},
+                                       {-1., 1., 2., -1.},
+                                       {-1., 3., 4., -1.},
+                                       {-1., -1., -1., -1.}}));
+  EXPECT_EQ(gt::eval(1. * gt::pad(a, gt::shape(1, 1), -1.)), c);
+
+  EXPECT_THROW(gt::pad(a, gt::shape(-1, 0)), std::runtime_error);
+}
+
+TEST(segmented, pad_3d)
+{
+  auto a = make_grid(gt::shape(6, 5, 3));
+  auto before = gt::shape(2, 0, 1);
+  auto after = gt::shape(3, 1, 0);
+  gt::gtensor<double, 3> b(gt::shape(11, 6, 4), -1.);
+  b = gt::pad(a, before, after, 7.);
+  gt::gtensor<double, 3> c = 1. * gt::pad(a, before, after, 7.);
+  EXPECT_EQ(b, c);
+  EXPECT_EQ(b.view(_s(2, 8), _s(0, 5), _s(1, 4)), a);
+  EXPECT_EQ(b.view(_s(0, 2), _all, _all),
+            gt::full<double>(gt::shape(2, 6, 4), 7.));
+  EXPECT_EQ(b.view(_s(2, 8), 5, _all), gt::full<double>(gt::shape(6, 4), 7.));
+  EXPECT_EQ(b.view(_s(2, 8), _s(0, 5), 0),
+            gt::full<double>(gt::shape(6, 5), 7.));
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(segmented, device_roll_concatenate_pad)
+{
+  auto h_a = make_grid(gt::shape(6, 5, 3));
+  gt::gtensor_device<double, 3> a(h_a.shape());
+  gt::copy(h_a, a);
+
+  gt::gtensor_device<double, 3> b = gt::roll(a, gt::shape(1, 2, -1));
+  gt::gtensor<double, 3> h_b(b.shape());
+  gt::copy(b, h_b);
+  EXPECT_EQ(h_b, gt::roll(h_a, gt::shape(1, 2, -1)));
+
+  gt::gtensor_device<double, 3> c = gt::concatenate(a, 2. * a, 2);
+  gt::gtensor<double, 3> h_c(c.shape());
+  gt::copy(c, h_c);
+  EXPECT_EQ(h_c, gt::concatenate(h_a, 2. * h_a, 2));
+
+  gt::gtensor_device<double, 3> d = gt::pad(a, gt::shape(1, 0, 2));
+  gt::gtensor<double, 3> h_d(d.shape());
+  gt::copy(d, h_d);
+  EXPECT_EQ(h_d, gt::pad(h_a, gt::shape(1, 0, 2)));
+}
+
+#endif
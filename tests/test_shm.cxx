@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/gtensor.h>
+#include <gtensor/shm.h>
+
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+
+// unique per process, so concurrent test runs don't collide
+std::string test_name(const char* what)
+{
+  return "/gtensor_test_" + std::string(what) + "_" +
+         std::to_string(::getpid());
+}
+
+} // namespace
+
+TEST(shm, create_attach)
+{
+  auto name = test_name("create_attach");
+  {
+    auto a = gt::shm_create<double>(name, gt::shape(3, 4));
+    EXPECT_EQ(a.shape(), gt::shape(3, 4));
+    gt::flatten(a) = gt::arange<double>(0, 12);
+    EXPECT_EQ(gt::shm_use_count(name), 1);
+
+    auto b = gt::shm_attach<double, 2>(name);
+    EXPECT_EQ(gt::shm_use_count(name), 2);
+    EXPECT_EQ(b.shape(), gt::shape(3, 4));
+    EXPECT_EQ(b, a);
+
+    // same memory, not a copy
+    b(1, 2) = -1.;
+    EXPECT_EQ(a(1, 2), -1.);
+
+    {
+      auto c = std::move(b);
+      EXPECT_EQ(gt::shm_use_count(name), 2);
+    }
+    EXPECT_EQ(gt::shm_use_count(name), 1);
+  }
+  // the last detach removed the segment
+  EXPECT_THROW((gt::shm_attach<double, 2>(name)), std::runtime_error);
+  EXPECT_FALSE(gt::shm_unlink(name));
+}
+
+TEST(shm, mismatch)
+{
+  auto name = test_name("mismatch");
+  auto a = gt::shm_create<float>(name, gt::shape(5));
+  EXPECT_THROW(gt::shm_create<float>(name, gt::shape(5)), std::runtime_error);
+  EXPECT_THROW((gt::shm_attach<double, 1>(name)), std::runtime_error);
+  EXPECT_THROW((gt::shm_attach<float, 2>(name)), std::runtime_error);
+  // failed attaches don't leak references
+  EXPECT_EQ(gt::shm_use_count(name), 1);
+}
+
+TEST(shm, multi_process)
+{
+  auto name = test_name("multi_process");
+  auto table = gt::shm_create<int>(name, gt::shape(100, 3));
+  gt::flatten(table) = gt::arange<int>(0, 300);
+
+  const int n_children = 3;
+  pid_t pids[n_children];
+  for (int c = 0; c < n_children; c++) {
+    pids[c] = ::fork();
+    ASSERT_GE(pids[c], 0);
+    if (pids[c] == 0) {
+      // child: read the shared table, and write one entry
+      int status = 0;
+      try {
+        auto t = gt::shm_attach<int, 2>(name);
+        if (t.shape() != gt::shape(100, 3) || t(7, 2) != 207) {
+          status = 1;
+        }
+        t(c, 0) = -c - 1;
+      } catch (...) {
+        status = 2;
+      }
+      ::_exit(status);
+    }
+  }
+  for (int c = 0; c < n_children; c++) {
+    int status;
+    ASSERT_EQ(::waitpid(pids[c], &status, 0), pids[c]);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+  }
+
+  for (int c = 0; c < n_children; c++) {
+    EXPECT_EQ(table(c, 0), -c - 1);
+  }
+  EXPECT_EQ(gt::shm_use_count(name), 1);
+}
+
+TEST(shm, read_only)
+{
+  auto name = test_name("read_only");
+  auto a = gt::shm_create<double>(name, gt::shape(1000));
+  a.fill(3.);
+  auto b = gt::shm_attach<double, 1>(name, true);
+  EXPECT_EQ(b(999), 3.);
+  EXPECT_DEATH({ b(0) = 1.; }, "");
+}
@@ -0,0 +1,307 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtensor/gtensor.h>
+#include <gtensor/stencil.h>
+
+#include "test_helpers.h"
+
+using namespace gt::placeholders;
+
+TEST(stencil, matches_view_sum_1d)
+{
+  const int n = 23;
+  gt::gtensor<double, 1> a(gt::shape(n));
+  for (int i = 0; i < n; i++) {
+    a(i) = i * i;
+  }
+
+  auto s = gt::stencil<-1, 1>({-0.5, 0.5}, a);
+  EXPECT_EQ(s.shape(), gt::shape(n - 2));
+
+  gt::gtensor<double, 1> expected =
+    0.5 * (a.view(_s(2, _)) - a.view(_s(_, -2)));
+
+  // pointwise, as part of an expression, and through the tiled assign
+  for (int i = 0; i < n - 2; i++) {
+    EXPECT_EQ(s(i), expected(i));
+  }
+  gt::gtensor<double, 1> b = 2. * s;
+  EXPECT_EQ(b, 2. * expected);
+  gt::gtensor<double, 1> c = s;
+  EXPECT_EQ(c, expected);
+}
+
+TEST(stencil, offsets_unordered)
+{
+  gt::gtensor<double, 1> a{1., 2., 4., 8., 16., 32., 64.};
+
+  // second derivative, offsets in any order and repeated
+  gt::gtensor<double, 1> b =
+    gt::stencil<0, 1, -1, 0>({-1., 1., 1., -1.}, a);
+  EXPECT_EQ(b, (gt::gtensor<double, 1>{1., 2., 4., 8., 16.}));
+}
+
+TEST(stencil, axis_2d)
+{
+  const int nx = 13, ny = 11;
+  gt::gtensor<double, 2> a(gt::shape(nx, ny));
+  for (int j = 0; j < ny; j++) {
+    for (int i = 0; i < nx; i++) {
+      a(i, j) = i * i + 3 * j * j * j;
+    }
+  }
+
+  gt::gtensor<double, 2> dx = gt::stencil<-2, -1, 1, 2>(
+    {1. / 12., -2. / 3., 2. / 3., -1. / 12.}, a, 0);
+  gt::gtensor<double, 2> dx_expected =
+    1. / 12. * a.view(_s(0, -4), _all) - 2. / 3. * a.view(_s(1, -3), _all) +
+    2. / 3. * a.view(_s(3, -1), _all) - 1. / 12. * a.view(_s(4, _), _all);
+  EXPECT_EQ(dx.shape(), gt::shape(nx - 4, ny));
+  GT_EXPECT_NEAR_ARRAY(dx, dx_expected);
+
+  gt::gtensor<double, 2> dy = gt::stencil<-1, 0, 1>({1., -2., 1.}, a, 1);
+  gt::gtensor<double, 2> dy_expected = a.view(_all, _s(0, -2)) -
+                                       2. * a.view(_all, _s(1, -1)) +
+                                       a.view(_all, _s(2, _));
+  EXPECT_EQ(dy.shape(), gt::shape(nx, ny - 2));
+  GT_EXPECT_NEAR_ARRAY(dy, dy_expected);
+
+  // into a view, and of a view
+  gt::gtensor<double, 2> c(gt::shape(nx, ny - 2), 0.);
+  c.view(_all, _all) =
+    gt::stencil<-1, 0, 1>({1., -2., 1.}, a.view(_all, _all), 1);
+  GT_EXPECT_NEAR_ARRAY(c, dy_expected);
+}
+
+TEST(stencil, invalid_axis)
+{
+  gt::gtensor<double, 2> a(gt::shape(4, 2));
+  EXPECT_THROW((gt::stencil<-1, 1>({1., 1.}, a, 2)), std::runtime_error);
+  EXPECT_THROW((gt::stencil<-1, 1>({1., 1.}, a, 1)), std::runtime_error);
+}
+
+TEST(stencil, points_2d)
+{
+  using gt::stencil_point;
+
+  const int nx = 9, ny = 7;
+  gt::gtensor<double, 2> a(gt::shape(nx, ny));
+  for (int j = 0; j < ny; j++) {
+    for (int i = 0; i < nx; i++) {
+      a(i, j) = i * i * i + 2 * i * j + j * j;
+    }
+  }
+
+  auto s = gt::stencil<stencil_point<0, -1>, stencil_point<-1, 0>,
+                       stencil_point<0, 0>, stencil_point<1, 0>,
+                       stencil_point<0, 1>>({1., 1., -4., 1., 1.}, a, {0, 1});
+  EXPECT_EQ(s.shape(), gt::shape(nx - 2, ny - 2));
+
+  gt::gtensor<double, 2> expected =
+    a.view(_s(1, -1), _s(0, -2)) + a.view(_s(0, -2), _s(1, -1)) -
+    4. * a.view(_s(1, -1), _s(1, -1)) + a.view(_s(2, _), _s(1, -1)) +
+    a.view(_s(1, -1), _s(2, _));
+  for (int j = 0; j < ny - 2; j++) {
+    for (int i = 0; i < nx - 2; i++) {
+      EXPECT_EQ(s(i, j), expected(i, j));
+    }
+  }
+  gt::gtensor<double, 2> b = s;
+  GT_EXPECT_NEAR_ARRAY(b, expected);
+
+  // axes in the other order swap the offsets
+  gt::gtensor<double, 2> c =
+    gt::stencil<stencil_point<-1, 0>, stencil_point<0, -1>,
+                stencil_point<0, 0>, stencil_point<0, 1>,
+                stencil_point<1, 0>>({1., 1., -4., 1., 1.}, a, {1, 0});
+  GT_EXPECT_NEAR_ARRAY(c, expected);
+}
+
+TEST(stencil, points_coeffs_3d)
+{
+  using gt::stencil_point;
+
+  const int nx = 5, ny = 8, nz = 6;
+  gt::gtensor<double, 3> a(gt::shape(nx, ny, nz));
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        a(i, j, k) = i + 3 * j * j - k * k * k;
+      }
+    }
+  }
+
+  // coefficients vary along x and z, and are the same for all y
+  gt::gtensor<double, 4> c(gt::shape(nx, 1, nz - 1, 3));
+  for (int p = 0; p < 3; p++) {
+    for (int k = 0; k < nz - 1; k++) {
+      for (int i = 0; i < nx; i++) {
+        c(i, 0, k, p) = 1. + i - 2. * k + 5. * p;
+      }
+    }
+  }
+
+  auto coeff = [&](int p) { return c.view(_all, _all, _all, p); };
+  gt::gtensor<double, 3> out(gt::shape(nx, ny - 2, nz - 1), 1.);
+  gt::gtensor<double, 3> expected =
+    out + coeff(0) * a.view(_all, _s(0, -2), _s(1, _)) +
+    coeff(1) * a.view(_all, _s(1, -1), _s(0, -1)) +
+    coeff(2) * a.view(_all, _s(2, _), _s(1, _));
+
+  out = out + gt::stencil<stencil_point<-1, 0>, stencil_point<0, -1>,
+                          stencil_point<1, 0>>(c, a, {1, 2});
+  GT_EXPECT_NEAR_ARRAY(out, expected);
+
+  // of a view, into a view
+  gt::gtensor<double, 3> out2(out.shape(), 1.);
+  out2.view(_all, _all, _all) =
+    out2 + gt::stencil<stencil_point<-1, 0>, stencil_point<0, -1>,
+                       stencil_point<1, 0>>(c, a.view(_all, _all, _all),
+                                            {1, 2});
+  GT_EXPECT_NEAR_ARRAY(out2, expected);
+}
+
+TEST(stencil, points_invalid)
+{
+  using gt::stencil_point;
+  using sp = stencil_point<-1, 1>;
+
+  gt::gtensor<double, 3> a(gt::shape(4, 3, 2));
+  EXPECT_THROW((gt::stencil<sp, stencil_point<1, 0>>({1., 1.}, a, {0, 3})),
+               std::runtime_error);
+  EXPECT_THROW((gt::stencil<sp, stencil_point<1, 0>>({1., 1.}, a, {1, 1})),
+               std::runtime_error);
+  EXPECT_THROW((gt::stencil<sp, stencil_point<1, -1>>({1., 1.}, a, {0, 2})),
+               std::runtime_error);
+
+  gt::gtensor<double, 4> c(gt::shape(2, 1, 2, 3));
+  EXPECT_THROW((gt::stencil<sp, stencil_point<1, 0>>(c, a, {0, 1})),
+               std::runtime_error);
+}
+
+namespace
+{
+
+// niter separate sweeps, the reference for stencil_iterate
+template <int... Offsets, typename E>
+void sweeps(const gt::sarray<double, sizeof...(Offsets)>& coeffs, E& a,
+            int niter, int axis)
+{
+  const int lo = -std::min({Offsets...});
+  const int hi = std::max({Offsets...});
+  std::vector<gt::gdesc> interior(a.dimension(), gt::gdesc(_all));
+  interior[axis] = _s(lo, a.shape(axis) - hi);
+  for (int it = 0; it < niter; it++) {
+    gt::gtensor<double, E::dimension()> tmp =
+      gt::stencil<Offsets...>(coeffs, a, axis);
+    gt::view<E::dimension()>(a, interior) = tmp;
+  }
+}
+
+} // namespace
+
+TEST(stencil, iterate_1d)
+{
+  // long enough for several tiles
+  const int n = 100000;
+  gt::gtensor<double, 1> a(gt::shape(n));
+  for (int i = 0; i < n; i++) {
+    a(i) = std::sin(0.01 * i) + (i % 7);
+  }
+  gt::gtensor<double, 1> expected(a);
+
+  gt::stencil_iterate<-1, 0, 1>({0.25, 0.5, 0.25}, a, 5);
+  sweeps<-1, 0, 1>({0.25, 0.5, 0.25}, expected, 5, 0);
+  EXPECT_EQ(a, expected);
+
+  // asymmetric, wider
+  gt::stencil_iterate<-2, 0, 1>({0.125, 0.5, 0.375}, a, 7);
+  sweeps<-2, 0, 1>({0.125, 0.5, 0.375}, expected, 7, 0);
+  EXPECT_EQ(a, expected);
+}
+
+TEST(stencil, iterate_axis_3d)
+{
+  // several tiles along the axis and across the first dimension
+  const int nx = 600, ny = 100, nz = 3;
+  gt::gtensor<double, 3> a(gt::shape(nx, ny, nz));
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        a(i, j, k) = (i * 7 + j * j + k) % 13 + 0.1 * i;
+      }
+    }
+  }
+
+  for (int axis = 0; axis < 3; axis++) {
+    gt::gtensor<double, 3> b(a);
+    gt::gtensor<double, 3> expected(a);
+    gt::stencil_iterate<-1, 0, 1>({0.25, 0.5, 0.25}, b, 3, axis);
+    sweeps<-1, 0, 1>({0.25, 0.5, 0.25}, expected, 3, axis);
+    EXPECT_EQ(b, expected) << "axis " << axis;
+  }
+
+  // of a view, more sweeps than points
+  gt::gtensor<double, 3> b(a);
+  gt::gtensor<double, 3> expected(a);
+  gt::stencil_iterate<-1, 1>({0.5, 0.5}, b.view(_all, _s(10, 20), 1), 12, 1);
+  auto e_view = expected.view(_all, _s(10, 20), 1);
+  sweeps<-1, 1>({0.5, 0.5}, e_view, 12, 1);
+  EXPECT_EQ(b, expected);
+
+  // the last tile along the axis is shorter than the halo
+  gt::gtensor<double, 2> c = a.view(_all, _s(0, 43), 0);
+  gt::gtensor<double, 2> c_expected(c);
+  gt::stencil_iterate<-1, 0, 1>({0.25, 0.5, 0.25}, c, 10, 1);
+  sweeps<-1, 0, 1>({0.25, 0.5, 0.25}, c_expected, 10, 1);
+  EXPECT_EQ(c, c_expected);
+
+  EXPECT_THROW((gt::stencil_iterate<-1, 1>({1., 1.}, b, 1, 3)),
+               std::runtime_error);
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(stencil, device_axis_2d)
+{
+  gt::gtensor<double, 2> h_a(gt::shape(6, 5));
+  for (int j = 0; j < 5; j++) {
+    for (int i = 0; i < 6; i++) {
+      h_a(i, j) = i * i + j * j * j;
+    }
+  }
+  gt::gtensor_device<double, 2> a(h_a.shape());
+  gt::copy(h_a, a);
+
+  gt::gtensor_device<double, 2> d = gt::stencil<-1, 0, 1>({1., -2., 1.}, a, 1);
+  gt::gtensor<double, 2> h_d(d.shape());
+  gt::copy(d, h_d);
+
+  gt::gtensor<double, 2> expected = h_a.view(_all, _s(0, -2)) -
+                                    2. * h_a.view(_all, _s(1, -1)) +
+                                    h_a.view(_all, _s(2, _));
+  GT_EXPECT_NEAR_ARRAY(h_d, expected);
+}
+
+TEST(stencil, device_iterate)
+{
+  const int n = 50;
+  gt::gtensor<double, 1> h_a(gt::shape(n));
+  for (int i = 0; i < n; i++) {
+    h_a(i) = i % 5;
+  }
+  gt::gtensor_device<double, 1> a(h_a.shape());
+  gt::copy(h_a, a);
+
+  gt::stencil_iterate<-1, 0, 1>({0.25, 0.5, 0.25}, a, 4);
+  gt::stencil_iterate<-1, 0, 1>({0.25, 0.5, 0.25}, h_a, 4);
+  gt::gtensor<double, 1> h_b(a.shape());
+  gt::copy(a, h_b);
+  GT_EXPECT_NEAR_ARRAY(h_b, h_a);
+}
+
+#endif
@@ -478,6 +478,111 @@ TEST(gview, transpose_view)
   EXPECT_EQ(avtranspose, (gt::gtensor<double, 2>{{21., 22.}}));
 }
 
+TEST(gview, transpose_default_axes)
+{
+  gt::gtensor<double, 3> a(gt::shape(2, 3, 4));
+  for (int n = 0; n < a.size(); n++) {
+    a.data()[n] = n;
+  }
+
+  auto b = gt::transpose(a);
+  EXPECT_EQ(b.shape(), gt::shape(4, 3, 2));
+  EXPECT_EQ(b(3, 1, 0), a(0, 1, 3));
+  EXPECT_EQ(gt::transpose(b), a);
+}
+
+TEST(gview, transpose_expression)
+{
+  gt::gtensor<double, 2> a{{11., 21., 31.}, {12., 22., 32.}};
+
+  auto c = gt::transpose(2. * a + 1., gt::shape(1, 0));
+  gt::gtensor<double, 2> at{{11., 12.}, {21., 22.}, {31., 32.}};
+  EXPECT_EQ(c, 2. * at + 1.);
+}
+
+TEST(gview, transpose_bad_axes)
+{
+  gt::gtensor<double, 3> a(gt::shape(2, 3, 4));
+  EXPECT_THROW(gt::transpose(a, gt::shape(0, 0, 1)), std::runtime_error);
+  EXPECT_THROW(gt::permute_dims(a, gt::shape(0, 1, 3)), std::runtime_error);
+}
+
+TEST(gview, permute_dims)
+{
+  // sizes that aren't multiples of the transpose blocks
+  gt::gtensor<double, 3> a(gt::shape(37, 45, 6));
+  for (int n = 0; n < a.size(); n++) {
+    a.data()[n] = n;
+  }
+
+  gt::gtensor<double, 3> b = gt::permute_dims(a, gt::shape(2, 0, 1));
+  EXPECT_EQ(b.shape(), gt::shape(6, 37, 45));
+  for (int k = 0; k < 45; k++) {
+    for (int j = 0; j < 37; j++) {
+      for (int i = 0; i < 6; i++) {
+        EXPECT_EQ(b(i, j, k), a(j, k, i));
+      }
+    }
+  }
+
+  gt::gtensor<double, 3> c = gt::permute_dims(b, gt::shape(1, 2, 0));
+  EXPECT_EQ(c, a);
+}
+
+TEST(gview, transpose_assign)
+{
+  const int nx = 100, ny = 37;
+  gt::gtensor<double, 2> a(gt::shape(nx, ny));
+  for (int n = 0; n < a.size(); n++) {
+    a.data()[n] = n;
+  }
+
+  gt::gtensor<double, 2> b(gt::shape(ny, nx));
+  b = gt::transpose(a);
+  for (int j = 0; j < nx; j++) {
+    for (int i = 0; i < ny; i++) {
+      EXPECT_EQ(b(i, j), a(j, i));
+    }
+  }
+
+  // into a view, from a strided view
+  gt::gtensor<double, 2> c(gt::shape(ny + 2, nx / 2), 0.);
+  c.view(_s(1, -1), _all) = gt::transpose(a.view(_s(_, _, 2), _all));
+  EXPECT_EQ(c.view(_s(1, -1), _all), b.view(_all, _s(_, _, 2)));
+  EXPECT_EQ(c.view(0, _all), gt::zeros<double>(gt::shape(nx / 2)));
+
+  // rhs rows a page apart take the blocked copy
+  gt::gtensor<double, 2> d(gt::shape(512, 45));
+  for (int n = 0; n < d.size(); n++) {
+    d.data()[n] = n;
+  }
+  gt::gtensor<double, 2> e(gt::shape(45, 512));
+  e = gt::transpose(d);
+  for (int j = 0; j < 512; j++) {
+    for (int i = 0; i < 45; i++) {
+      EXPECT_EQ(e(i, j), d(j, i));
+    }
+  }
+
+  // planes over 1 MiB too, with partial blocks, also into a strided lhs
+  const int mx = 301, my = 317;
+  gt::gtensor<double, 2> f(gt::shape(mx, my));
+  for (int n = 0; n < f.size(); n++) {
+    f.data()[n] = n;
+  }
+  gt::gtensor<double, 2> g(gt::shape(my, mx));
+  g = gt::transpose(f);
+  gt::gtensor<double, 2> h(gt::shape(2 * my, mx), 0.);
+  h.view(_s(_, _, 2), _all) = gt::transpose(f);
+  for (int j = 0; j < mx; j++) {
+    for (int i = 0; i < my; i++) {
+      EXPECT_EQ(g(i, j), f(j, i));
+      EXPECT_EQ(h(2 * i, j), f(j, i));
+      EXPECT_EQ(h(2 * i + 1, j), 0.);
+    }
+  }
+}
+
 TEST(gview, reshape_view)
 {
   gt::gtensor<double, 2> a{{11., 21., 31.}, {12., 22., 32.}};
@@ -502,6 +607,152 @@ TEST(gview, reshape_reshape)
   EXPECT_EQ(aview2, (gt::gtensor<double, 2>{{11., 21., 31., 12., 22., 32.}}));
 }
 
+TEST(gview, reshape_strided_view)
+{
+  gt::gtensor<double, 3> a(gt::shape(4, 5, 6));
+  for (int n = 0; n < a.size(); n++) {
+    a.data()[n] = n;
+  }
+  auto v = a.view(_s(1, -1), _all, _all);
+  EXPECT_EQ(v.strides(), gt::shape(1, 4, 20));
+
+  // merging the last two dimensions keeps the strides
+  auto r = gt::reshape(v, gt::shape(2, 30));
+  EXPECT_EQ(r.strides(), gt::shape(1, 4));
+  gt::gtensor<double, 2> b = r;
+  for (int j = 0; j < 30; j++) {
+    for (int i = 0; i < 2; i++) {
+      EXPECT_EQ(b(i, j), a(i + 1, j % 5, j / 5));
+    }
+  }
+  EXPECT_EQ(std::addressof(r(1, 29)), std::addressof(a(2, 4, 5)));
+
+  // so does splitting, and adding size one dimensions
+  auto r2 = gt::reshape(v, gt::shape(2, 5, 1, 2, 3));
+  EXPECT_EQ(r2.strides(), gt::shape(1, 4, 0, 20, 40));
+  EXPECT_EQ(r2(1, 3, 0, 1, 2), a(2, 3, 5));
+  auto r3 = gt::reshape(r, gt::shape(2, -1, 6));
+  EXPECT_EQ(r3.strides(), gt::shape(1, 4, 20));
+  EXPECT_EQ(r3, v);
+
+  // writing through it
+  gt::reshape(v, gt::shape(2, 30)) = -1.;
+  EXPECT_EQ(v, gt::full<double>(v.shape(), -1.));
+  EXPECT_EQ(a(0, 2, 3), 0. + 4 * 2 + 20 * 3);
+
+  // a strided view, and one in reverse
+  auto w = a.view(_all, _all, _s(_, _, 2));
+  auto rw = gt::reshape(w, gt::shape(20, 3));
+  EXPECT_EQ(rw.strides(), gt::shape(1, 40));
+  EXPECT_EQ(rw(13, 2), a(1, 3, 4));
+  auto rev = a.view(_s(_, _, -1), _all, 2);
+  auto rrev = gt::reshape(rev, gt::shape(2, 2, 5));
+  EXPECT_EQ(rrev.strides(), gt::shape(-1, -2, 4));
+  EXPECT_EQ(rrev(1, 0, 3), a(2, 3, 2));
+
+  // sizes that don't match fail rather than read past the dimensions
+  gt::strides_type<2> s2;
+  EXPECT_FALSE(gt::detail::calc_reshape_strides(
+    v.shape(), v.strides(), gt::shape(2, 31), s2));
+  EXPECT_FALSE(gt::detail::calc_reshape_strides(
+    v.shape(), v.strides(), gt::shape(61, 1), s2));
+  gt::strides_type<3> s3;
+  EXPECT_FALSE(gt::detail::calc_reshape_strides(
+    gt::shape(2, 3), gt::strides_type<2>(1, 2), gt::shape(2, 3, 2), s3));
+}
+
+TEST(gview, reshape_unravel_fallback)
+{
+  gt::gtensor<double, 3> a(gt::shape(4, 5, 6));
+  for (int n = 0; n < a.size(); n++) {
+    a.data()[n] = n;
+  }
+
+  // the first two dimensions of the view aren't contiguous
+  auto v = a.view(_s(1, -1), _all, _all);
+  auto r = gt::reshape(v, gt::shape(10, 6));
+  EXPECT_EQ(r.strides(), gt::calc_strides(r.shape()));
+  gt::gtensor<double, 2> b = r;
+  for (int j = 0; j < 6; j++) {
+    for (int i = 0; i < 10; i++) {
+      EXPECT_EQ(b(i, j), a(i % 2 + 1, i / 2, j));
+    }
+  }
+
+  gt::reshape(v, gt::shape(60)) = gt::arange<double>(0, 60);
+  for (int k = 0; k < 6; k++) {
+    for (int j = 0; j < 5; j++) {
+      EXPECT_EQ(a(1, j, k), 2 * (j + 5 * k));
+      EXPECT_EQ(a(2, j, k), 2 * (j + 5 * k) + 1);
+    }
+  }
+}
+
+TEST(gview, reshape_view_odometer)
+{
+  gt::gtensor<double, 3> a(gt::shape(4, 6, 6));
+  for (int n = 0; n < a.size(); n++) {
+    a.data()[n] = n;
+  }
+  auto v = a.view(_s(1, -1), _all, _all);
+
+  // rank 4 goes through the odometer, which takes the strided paths for a
+  // reshape that kept its strides, and the indexed one otherwise
+  auto r = gt::reshape(v, gt::shape(2, 3, 2, 6));
+  auto u = gt::reshape(v, gt::shape(4, 3, 2, 3));
+  using maybe = gt::detail::maybe_data_strided<decltype(r)>;
+  EXPECT_TRUE(maybe::value);
+  EXPECT_TRUE(maybe::check(r));
+  EXPECT_FALSE(maybe::check(u));
+
+  gt::gtensor<double, 4> b = r;
+  gt::gtensor<double, 4> b2 = 2. * r + 1.;
+  gt::gtensor<double, 4> c = u;
+  gt::gtensor<double, 4> c2 = 2. * u + 1.;
+  auto flat_v = gt::eval(gt::reshape(v, gt::shape(72)));
+  EXPECT_EQ(gt::flatten(b), flat_v);
+  EXPECT_EQ(gt::flatten(b2), 2. * flat_v + 1.);
+  EXPECT_EQ(gt::flatten(c), flat_v);
+  EXPECT_EQ(gt::flatten(c2), 2. * flat_v + 1.);
+  EXPECT_EQ(b(1, 2, 1, 5), a(2, 5, 5));
+
+  // and as lhs
+  gt::gtensor<double, 3> z(a.shape(), 0.);
+  gt::reshape(z.view(_s(1, -1), _all, _all), gt::shape(2, 3, 2, 6)) = b;
+  EXPECT_EQ(z.view(_s(1, -1), _all, _all), v);
+  z = gt::zeros<double>(a.shape());
+  gt::reshape(z.view(_s(1, -1), _all, _all), gt::shape(4, 3, 2, 3)) = 2. * c;
+  EXPECT_EQ(z.view(_s(1, -1), _all, _all), 2. * v);
+  EXPECT_EQ(z.view(0, _all, _all), gt::zeros<double>(gt::shape(6, 6)));
+  EXPECT_EQ(z.view(3, _all, _all), gt::zeros<double>(gt::shape(6, 6)));
+}
+
+TEST(gview, reshape_row_major)
+{
+  using row_major = gt::layout::row_major;
+  gt::gtensor<int, 2, gt::space::host, row_major> a{
+    {1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}};
+  gt::gtensor<int, 2> expected = a;
+
+  // still in index order
+  auto flat = gt::flatten(a);
+  EXPECT_EQ(flat, gt::flatten(expected));
+  EXPECT_EQ(gt::reshape(std::move(a), gt::shape(2, 6)),
+            gt::reshape(expected, gt::shape(2, 6)));
+
+  // splitting a dimension keeps the strides
+  gt::gtensor<int, 2, gt::space::host, row_major> b = expected;
+  auto r = gt::reshape(b, gt::shape(2, 2, 3));
+  EXPECT_EQ(r.strides(), gt::shape(3, 6, 1));
+  EXPECT_EQ(r, gt::reshape(expected, gt::shape(2, 2, 3)));
+
+  // spans can't fall back
+  gt::gtensor_span<int, 2> s = b;
+  EXPECT_EQ(gt::reshape(s, gt::shape(2, 2, 3)).strides(),
+            gt::shape(3, 6, 1));
+  EXPECT_THROW(gt::reshape(s, gt::shape(12)), std::runtime_error);
+}
+
 TEST(gview, flatten_gtensor_2d)
 {
   gt::gtensor<double, 2> a{{11., 21., 31.}, {12., 22., 32.}};
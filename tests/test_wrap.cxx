@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <gtensor/gtensor.h>
+#include <gtensor/wrap.h>
+
+#include "test_helpers.h"
+
+using namespace gt::placeholders;
+
+TEST(wrap, modes_1d)
+{
+  gt::gtensor<double, 1> a{1., 2., 3., 4.};
+
+  auto p = gt::wrap(a, gt::shape(2), gt::boundary::periodic);
+  EXPECT_EQ(p.shape(), gt::shape(8));
+  EXPECT_EQ(gt::eval(p),
+            (gt::gtensor<double, 1>{3., 4., 1., 2., 3., 4., 1., 2.}));
+
+  auto r = gt::wrap(a, gt::shape(2), gt::boundary::reflect);
+  EXPECT_EQ(gt::eval(r),
+            (gt::gtensor<double, 1>{2., 1., 1., 2., 3., 4., 4., 3.}));
+
+  auto c = gt::wrap(a, gt::shape(2), gt::boundary::clamp);
+  EXPECT_EQ(gt::eval(c),
+            (gt::gtensor<double, 1>{1., 1., 1., 2., 3., 4., 4., 4.}));
+}
+
+TEST(wrap, invalid_pad)
+{
+  gt::gtensor<double, 1> a{1., 2.};
+  EXPECT_THROW(gt::wrap(a, gt::shape(3), gt::boundary::periodic),
+               std::runtime_error);
+  EXPECT_THROW(
+    gt::wrap(a, gt::shape(1), gt::sarray<gt::boundary, 1>(gt::boundary::none)),
+    std::runtime_error);
+}
+
+TEST(wrap, selected_dims_2d)
+{
+  // periodic in the first dimension only
+  gt::gtensor<int, 2> a{{1, 2, 3}, {4, 5, 6}};
+  auto w = gt::wrap(a, gt::shape(1, 0), gt::boundary::periodic);
+  EXPECT_EQ(w.shape(), gt::shape(5, 2));
+  EXPECT_EQ(gt::eval(w),
+            (gt::gtensor<int, 2>{{3, 1, 2, 3, 1}, {6, 4, 5, 6, 4}}));
+
+  // different modes per dimension
+  auto w2 =
+    gt::wrap(a, gt::shape(1, 1), {gt::boundary::clamp, gt::boundary::reflect});
+  EXPECT_EQ(gt::eval(w2), (gt::gtensor<int, 2>{{1, 1, 2, 3, 3},
+                                               {1, 1, 2, 3, 3},
+                                               {4, 4, 5, 6, 6},
+                                               {4, 4, 5, 6, 6}}));
+}
+
+TEST(wrap, periodic_stencil)
+{
+  // centered difference on a periodic domain, no ghost cells
+  const int n = 16;
+  gt::gtensor<double, 1> x(gt::shape(n));
+  for (int i = 0; i < n; i++) {
+    x(i) = i * i;
+  }
+  auto xw = gt::wrap(x, gt::shape(1), gt::boundary::periodic);
+  gt::gtensor<double, 1> dx = xw.view(_s(2, _)) - xw.view(_s(_, -2));
+
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(dx(i), x((i + 1) % n) - x((i + n - 1) % n));
+  }
+}
+
+TEST(wrap, assign_wrapped)
+{
+  // 5-point laplacian, periodic in both dimensions
+  const int nx = 9, ny = 7;
+  gt::gtensor<double, 2> a(gt::shape(nx, ny));
+  for (int j = 0; j < ny; j++) {
+    for (int i = 0; i < nx; i++) {
+      a(i, j) = 10 * i + j * j;
+    }
+  }
+  auto aw = gt::wrap(a, gt::shape(1, 1), gt::boundary::periodic);
+  auto sten = [&](int sx, int sy) {
+    return aw.view(_s(1 + sx, nx + 1 + sx), _s(1 + sy, ny + 1 + sy));
+  };
+  auto rhs = sten(-1, 0) + sten(1, 0) + sten(0, -1) + sten(0, 1) -
+             4. * sten(0, 0);
+
+  gt::gtensor<double, 2> expected(a.shape());
+  for (int j = 0; j < ny; j++) {
+    for (int i = 0; i < nx; i++) {
+      expected(i, j) = a((i + nx - 1) % nx, j) + a((i + 1) % nx, j) +
+                       a(i, (j + ny - 1) % ny) + a(i, (j + 1) % ny) -
+                       4. * a(i, j);
+    }
+  }
+
+  gt::gtensor<double, 2> b(a.shape());
+  b = rhs;
+  EXPECT_EQ(b, expected);
+
+  gt::gtensor<double, 2> c(a.shape(), 0.);
+  gt::assign_wrapped(c, rhs, gt::shape(1, 1));
+  EXPECT_EQ(c, expected);
+
+  // into a view, too small for an interior in the first dimension
+  gt::gtensor<double, 2> d(a.shape(), 0.);
+  gt::assign_wrapped(d.view(_all, _all), rhs, gt::shape(5, 1));
+  EXPECT_EQ(d, expected);
+
+  // kernels of the wrap view keep wrapping
+  auto k_aw = aw.to_kernel();
+  EXPECT_EQ(k_aw(0, 0), a(nx - 1, ny - 1));
+}
+
+TEST(wrap, assign_wrapped_broadcast)
+{
+  gt::gtensor<double, 2> a(gt::shape(6, 1));
+  for (int i = 0; i < 6; i++) {
+    a(i, 0) = i;
+  }
+  auto aw = gt::wrap(a, gt::shape(1, 0), gt::boundary::periodic);
+
+  gt::gtensor<double, 2> b(gt::shape(8, 5), -1.);
+  gt::assign_wrapped(b, aw, gt::shape(1, 1));
+  gt::gtensor<double, 2> c(b.shape(), -1.);
+  c.view(_all, _all) = aw;
+  EXPECT_EQ(b, c);
+  for (int j = 0; j < 5; j++) {
+    for (int i = 0; i < 8; i++) {
+      EXPECT_EQ(b(i, j), (i + 5) % 6);
+    }
+  }
+}
+
+#ifdef GTENSOR_HAVE_DEVICE
+
+TEST(wrap, device_periodic_stencil)
+{
+  const int n = 16;
+  gt::gtensor<double, 1> h_x(gt::shape(n));
+  for (int i = 0; i < n; i++) {
+    h_x(i) = i * i;
+  }
+  gt::gtensor_device<double, 1> x(h_x.shape());
+  gt::copy(h_x, x);
+
+  auto xw = gt::wrap(x, gt::shape(1), gt::boundary::periodic);
+  gt::gtensor_device<double, 1> dx(x.shape());
+  gt::assign_wrapped(dx, xw.view(_s(2, _)) - xw.view(_s(_, -2)),
+                     gt::shape(1));
+  gt::gtensor<double, 1> h_dx(dx.shape());
+  gt::copy(dx, h_dx);
+
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(h_dx(i), h_x((i + 1) % n) - h_x((i + n - 1) % n));
+  }
+}
+
+#endif